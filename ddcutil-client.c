@@ -426,6 +426,153 @@ static cmd_status_t call_detect(GDBusConnection *connection, gboolean list_only)
     return ddcutil_status == 0 ? COMPLETED_WITHOUT_ERROR : SERVICE_ERROR;
 }
 
+/* ----------------------------------------------------------------------------------------------------
+ * Flight recorder file layout, must match ddcutil-service.c.
+ */
+#define TRACE_MAGIC "DDCTRC1"
+
+typedef struct {
+    gint64 real_micros;
+    gint sequence;
+    guint32 duration_micros;
+    gint32 status;
+    gint16 display;
+    guint8 vcp_code;
+    guint8 kind;
+    char sender[16];
+    char name[24];
+} Trace_Record;
+
+typedef struct {
+    char magic[8];
+    guint32 record_size;
+    guint32 capacity;
+    gint next;
+    char reserved[44];
+} Trace_Header;
+
+static const char *trace_kind_names[] = {"?", "call", "run", "i2c"};
+
+/**
+ * @brief Output one flight recorder record to stdout.
+ * @param real_micros start time, microseconds since the epoch
+ * @param sequence record sequence number
+ * @param kind 1 for a main loop call, 2 for a worker thread run, 3 for an I2C operation
+ * @param sender D-Bus sender, empty for I2C operations
+ * @param name method or I2C operation name
+ * @param display display number, or I2C bus number for I2C operations
+ * @param vcp_code VCP-code, zero if not applicable
+ * @param status ddcutil status
+ * @param duration_micros duration in microseconds
+ */
+static void print_trace_record(gint64 real_micros, guint32 sequence, guint8 kind, const gchar *sender,
+                               const gchar *name, gint32 display, guint8 vcp_code, gint32 status,
+                               guint32 duration_micros) {
+    GDateTime *date_time = g_date_time_new_from_unix_local(real_micros / 1000000);
+    gchar *time_str = g_date_time_format(date_time, "%F %T");
+    g_print("%s.%06d %8u %-4s %-12s %-26s %4d 0x%02x %6d %9u\n",
+            time_str, (int) (real_micros % 1000000), sequence,
+            trace_kind_names[kind < G_N_ELEMENTS(trace_kind_names) ? kind : 0],
+            sender, name, display, vcp_code, status, duration_micros);
+    g_free(time_str);
+    g_date_time_unref(date_time);
+}
+
+static void print_trace_heading(void) {
+    g_print("%-26s %8s %-4s %-12s %-26s %4s %4s %6s %9s\n",
+            "time", "seq", "kind", "sender", "name", "disp", "code", "status", "micros");
+}
+
+/**
+ * @brief Implement trace, outputs the service's flight recorder to stdout
+ * @param connection dbus connection to ddcutil-service
+ * @return COMPLETED_WITHOUT_ERROR, SERVICE_ERROR or DBUS_ERROR
+ */
+static cmd_status_t call_get_trace(GDBusConnection *connection) {
+    const char *operation_name = "GetTrace";
+    GError *error = NULL;
+    GVariant *result;
+
+    result = g_dbus_connection_call_sync(connection,
+                                         DBUS_BUS_NAME,
+                                         DBUS_OBJECT_PATH,
+                                         DBUS_INTERFACE_NAME,
+                                         operation_name,  // Method name
+                                         g_variant_new("(u)", 0),
+                                         G_VARIANT_TYPE("(a(xuyssiyiu)is)"),
+                                         G_DBUS_CALL_FLAGS_NONE,
+                                         -1,
+                                         NULL,
+                                         &error);
+
+    cmd_status_t dbus_status = handle_dbus_error(operation_name, error);
+    if (dbus_status != COMPLETED_WITHOUT_ERROR) {
+        return dbus_status;
+    }
+
+    GVariantIter *array_iter;
+    gint32 ddcutil_status;
+    const gchar *error_message;
+    g_variant_get(result, "(a(xuyssiyiu)is)", &array_iter, &ddcutil_status, &error_message);
+    report_ddcutil_status(operation_name, ddcutil_status, error_message);
+
+    gint64 real_micros;
+    guint32 sequence, duration_micros;
+    guint8 kind, vcp_code;
+    const gchar *sender, *name;
+    gint32 display, status;
+    print_trace_heading();
+    while (g_variant_iter_next(array_iter, "(xuy&s&siyiu)", &real_micros, &sequence, &kind, &sender, &name,
+                               &display, &vcp_code, &status, &duration_micros)) {
+        print_trace_record(real_micros, sequence, kind, sender, name, display, vcp_code, status, duration_micros);
+    }
+    g_variant_iter_free(array_iter);
+    g_variant_unref(result);
+    return ddcutil_status == 0 ? COMPLETED_WITHOUT_ERROR : SERVICE_ERROR;
+}
+
+/**
+ * @brief Implement trace FILE, outputs a flight recorder file to stdout, works when the service is not running.
+ * @param filename the service's trace file, for example, $XDG_RUNTIME_DIR/ddcutil-service-trace.previous.bin
+ * @return COMPLETED_WITHOUT_ERROR or SERVICE_ERROR
+ */
+static cmd_status_t dump_trace_file(const char *filename) {
+    gchar *contents;
+    gsize length;
+    GError *error = NULL;
+    if (!g_file_get_contents(filename, &contents, &length, &error)) {
+        g_printerr("ERROR: %s\n", error->message);
+        g_error_free(error);
+        return SERVICE_ERROR;
+    }
+    const Trace_Header *header = (Trace_Header *) contents;
+    if (length < sizeof(Trace_Header) || memcmp(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0
+        || header->record_size != sizeof(Trace_Record)
+        || length < sizeof(Trace_Header) + (gsize) header->capacity * sizeof(Trace_Record)) {
+        g_printerr("ERROR: %s is not a ddcutil-service trace file of this version.\n", filename);
+        g_free(contents);
+        return SERVICE_ERROR;
+    }
+    const Trace_Record *ring = (Trace_Record *) (header + 1);
+    const guint next = (guint) header->next;
+    const guint count = MIN(next, header->capacity);
+    print_trace_heading();
+    for (guint n = next - count; n != next; n++) {
+        const Trace_Record *record = &ring[n % header->capacity];
+        if ((guint) record->sequence != n + 1) {
+            continue;  // Was being written, or was overwritten
+        }
+        gchar *sender = g_strndup(record->sender, sizeof(record->sender));
+        gchar *name = g_strndup(record->name, sizeof(record->name));
+        print_trace_record(record->real_micros, n + 1, record->kind, sender, name, record->display,
+                           record->vcp_code, record->status, record->duration_micros);
+        g_free(sender);
+        g_free(name);
+    }
+    g_free(contents);
+    return COMPLETED_WITHOUT_ERROR;
+}
+
 /**
  * @brief print a service property value to stdout
  * @param connection open service connection
@@ -609,6 +756,923 @@ static gboolean handle_boolean_prop(const gchar *option_name, const gchar *value
     return TRUE;
 }
 
+/* ----------------------------------------------------------------------------------------------------
+ * Load generator, the bench command.
+ *
+ * Keeps a fixed number of asynchronous calls in flight for a fixed duration, picking each call's method
+ * from a weighted mix and its display round-robin, and reports throughput, latency percentiles and error
+ * counts by status.  SetVcp writes back the value each display had when the run started.
+ */
+
+#define BENCH_DEFAULT_MIX "getvcp=70,setvcp=10,getmultiplevcp=10,list=10"
+
+typedef struct {
+    const char *command_name;     // As used in the --mix option
+    const char *method_name;
+    guint weight;
+    GArray *latencies_micros;     // gint64, one for each completed call
+    guint64 error_count;
+} Bench_Method;
+
+typedef struct {
+    GDBusConnection *connection;
+    Bench_Method methods[4];
+    guint total_weight;
+    GArray *display_numbers;      // gint
+    GArray *restore_values;       // guint16, the first VCP code's value on each display
+    GArray *vcp_codes;            // guint8
+    gint64 end_micros;
+    guint in_flight;
+    guint next_display;
+    GHashTable *error_counts;     // "method status" -> count
+    GHashTable *status_names;     // status -> name, from the StatusValues property
+    GMainLoop *main_loop;
+} Bench_Run;
+
+typedef struct {
+    Bench_Run *run;
+    Bench_Method *method;
+    gint64 start_micros;
+} Bench_Call;
+
+static void bench_issue_call(Bench_Run *run);
+
+/**
+ * @brief Return the value at a percentile of sorted latencies.
+ * @param sorted_micros latencies sorted in ascending order
+ * @param percentile 0.0 to 1.0
+ * @return the latency in microseconds, zero if there are none
+ */
+static gint64 bench_percentile(GArray *sorted_micros, double percentile) {
+    if (sorted_micros->len == 0) {
+        return 0;
+    }
+    const guint index = MIN(sorted_micros->len - 1, (guint) (percentile * sorted_micros->len));
+    return g_array_index(sorted_micros, gint64, index);
+}
+
+static gint bench_compare_micros(gconstpointer a, gconstpointer b) {
+    const gint64 x = *(const gint64 *) a, y = *(const gint64 *) b;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+/**
+ * @brief Print a line of latency statistics, sorting the latencies.
+ * @param name row name
+ * @param latencies_micros the latencies
+ * @param elapsed_seconds the run time, for the rate
+ * @param error_count number of errors
+ */
+static void bench_print_latency_row(const char *name, GArray *latencies_micros, double elapsed_seconds,
+                                    guint64 error_count) {
+    g_array_sort(latencies_micros, bench_compare_micros);
+    g_print("%-20s %8u %9.1f %9.2f %9.2f %9.2f %9.2f %8" G_GUINT64_FORMAT "\n",
+            name, latencies_micros->len, latencies_micros->len / elapsed_seconds,
+            bench_percentile(latencies_micros, 0.50) / 1000.0,
+            bench_percentile(latencies_micros, 0.90) / 1000.0,
+            bench_percentile(latencies_micros, 0.99) / 1000.0,
+            bench_percentile(latencies_micros, 1.0) / 1000.0,
+            error_count);
+}
+
+static void bench_print_latency_heading(void) {
+    g_print("%-20s %8s %9s %9s %9s %9s %9s %8s\n",
+            "method", "count", "per-sec", "p50-ms", "p90-ms", "p99-ms", "max-ms", "errors");
+}
+
+/**
+ * @brief Get a property's value.
+ * @param connection open service connection
+ * @param property_name the property
+ * @return the value, or NULL if unavailable, free with g_variant_unref
+ */
+static GVariant *get_property_value(GDBusConnection *connection, const char *property_name) {
+    GVariant *result = g_dbus_connection_call_sync(connection,
+                                                   DBUS_BUS_NAME,
+                                                   DBUS_OBJECT_PATH,
+                                                   "org.freedesktop.DBus.Properties",
+                                                   "Get",
+                                                   g_variant_new("(ss)", DBUS_INTERFACE_NAME, property_name),
+                                                   G_VARIANT_TYPE("(v)"),
+                                                   G_DBUS_CALL_FLAGS_NONE,
+                                                   -1,
+                                                   NULL,
+                                                   NULL);
+    GVariant *property_value = NULL;
+    if (result != NULL) {
+        g_variant_get(result, "(v)", &property_value);
+        g_variant_unref(result);
+    }
+    return property_value;
+}
+
+/**
+ * @brief Get a map of values to names from an a{is} property, such as StatusValues.
+ * @param connection open service connection
+ * @param property_name the property
+ * @return value -> name, empty if unavailable
+ */
+static GHashTable *get_property_names(GDBusConnection *connection, const char *property_name) {
+    GHashTable *names = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    GVariant *property_value = get_property_value(connection, property_name);
+    if (property_value != NULL) {
+        GVariantIter iter;
+        gint32 value;
+        gchar *name;
+        g_variant_iter_init(&iter, property_value);
+        while (g_variant_iter_next(&iter, "{is}", &value, &name)) {
+            g_hash_table_insert(names, GINT_TO_POINTER(value), name);
+        }
+        g_variant_unref(property_value);
+    }
+    return names;
+}
+
+/**
+ * @brief Count an error under its method and status.
+ * @param run the run
+ * @param method the method
+ * @param status_text the status number and name, or the D-Bus error name
+ */
+static void bench_count_error(Bench_Run *run, Bench_Method *method, const char *status_text) {
+    method->error_count++;
+    gchar *key = g_strdup_printf("%s %s", method->method_name, status_text);
+    const guint64 count = GPOINTER_TO_SIZE(g_hash_table_lookup(run->error_counts, key));
+    g_hash_table_replace(run->error_counts, key, GSIZE_TO_POINTER(count + 1));
+}
+
+static void bench_call_done(GObject *source, GAsyncResult *res, gpointer user_data) {
+    Bench_Call *call = user_data;
+    Bench_Run *run = call->run;
+    GError *error = NULL;
+    GVariant *result = g_dbus_connection_call_finish(run->connection, res, &error);
+    const gint64 latency_micros = g_get_monotonic_time() - call->start_micros;
+    g_array_append_val(call->method->latencies_micros, latency_micros);
+    if (result == NULL) {
+        gchar *remote_error = g_dbus_error_get_remote_error(error);
+        bench_count_error(run, call->method, remote_error != NULL ? remote_error : error->message);
+        g_free(remote_error);
+        g_error_free(error);
+    }
+    else {
+        // Every method's reply ends with (..., i error_status, s error_message)
+        gint32 status;
+        g_variant_get_child(result, g_variant_n_children(result) - 2, "i", &status);
+        if (status != 0) {
+            const char *status_name = g_hash_table_lookup(run->status_names, GINT_TO_POINTER(status));
+            gchar *status_text = g_strdup_printf("%d %s", status, status_name != NULL ? status_name : "");
+            bench_count_error(run, call->method, status_text);
+            g_free(status_text);
+        }
+        g_variant_unref(result);
+    }
+    g_free(call);
+    run->in_flight--;
+    if (g_get_monotonic_time() < run->end_micros) {
+        bench_issue_call(run);
+    }
+    else if (run->in_flight == 0) {
+        g_main_loop_quit(run->main_loop);
+    }
+}
+
+/**
+ * @brief Start one asynchronous call, choosing the method from the mix and the next display.
+ * @param run the run
+ */
+static void bench_issue_call(Bench_Run *run) {
+    guint pick = g_random_int_range(0, (gint32) run->total_weight);
+    Bench_Method *method = &run->methods[0];
+    for (guint i = 0; i < G_N_ELEMENTS(run->methods); i++) {
+        if (pick < run->methods[i].weight) {
+            method = &run->methods[i];
+            break;
+        }
+        pick -= run->methods[i].weight;
+    }
+    const guint display_index = run->next_display++ % run->display_numbers->len;
+    const gint display_number = g_array_index(run->display_numbers, gint, display_index);
+    const guint8 vcp_code = g_array_index(run->vcp_codes, guint8, 0);
+    GVariant *parameters;
+    const GVariantType *reply_type;
+    if (g_strcmp0(method->method_name, "GetVcp") == 0) {
+        parameters = g_variant_new("(isyu)", display_number, "", vcp_code, 0);
+        reply_type = G_VARIANT_TYPE("(qqsis)");
+    }
+    else if (g_strcmp0(method->method_name, "SetVcp") == 0) {
+        parameters = g_variant_new("(isyqu)", display_number, "", vcp_code,
+                                   g_array_index(run->restore_values, guint16, display_index), 0);
+        reply_type = G_VARIANT_TYPE("(is)");
+    }
+    else if (g_strcmp0(method->method_name, "GetMultipleVcp") == 0) {
+        GVariant *codes = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, run->vcp_codes->data,
+                                                    run->vcp_codes->len, sizeof(guint8));
+        parameters = g_variant_new("(is@ayu)", display_number, "", codes, 0);
+        reply_type = G_VARIANT_TYPE("(a(yqqs)is)");
+    }
+    else {
+        parameters = g_variant_new("(u)", 0);
+        reply_type = G_VARIANT_TYPE("(ia(iiisssqsu)is)");
+    }
+    Bench_Call *call = g_new0(Bench_Call, 1);
+    call->run = run;
+    call->method = method;
+    call->start_micros = g_get_monotonic_time();
+    run->in_flight++;
+    g_dbus_connection_call(run->connection, DBUS_BUS_NAME, DBUS_OBJECT_PATH, DBUS_INTERFACE_NAME,
+                           method->method_name, parameters, reply_type, G_DBUS_CALL_FLAGS_NONE, -1, NULL,
+                           bench_call_done, call);
+}
+
+/**
+ * @brief Parse a mix such as getvcp=70,setvcp=10 into the run's method weights.
+ * @return COMPLETED_WITHOUT_ERROR or SYNTAX_ERROR
+ */
+static cmd_status_t bench_parse_mix(Bench_Run *run, const char *mix) {
+    gchar **terms = g_strsplit(mix, ",", -1);
+    cmd_status_t status = COMPLETED_WITHOUT_ERROR;
+    for (gchar **term = terms; *term != NULL && status == COMPLETED_WITHOUT_ERROR; term++) {
+        gchar **name_weight = g_strsplit(*term, "=", 2);
+        status = SYNTAX_ERROR;
+        for (guint i = 0; i < G_N_ELEMENTS(run->methods) && name_weight[1] != NULL; i++) {
+            if (g_strcmp0(g_strstrip(name_weight[0]), run->methods[i].command_name) == 0) {
+                run->methods[i].weight = (guint) parse_int(name_weight[1], 10, &status);
+            }
+        }
+        g_strfreev(name_weight);
+    }
+    g_strfreev(terms);
+    run->total_weight = 0;
+    for (guint i = 0; i < G_N_ELEMENTS(run->methods); i++) {
+        run->total_weight += run->methods[i].weight;
+    }
+    if (status != COMPLETED_WITHOUT_ERROR || run->total_weight == 0) {
+        g_printerr("ERROR: Invalid mix %s, expected a comma separated list of getvcp|setvcp|getmultiplevcp|list=WEIGHT.\n",
+                   mix);
+        return SYNTAX_ERROR;
+    }
+    return COMPLETED_WITHOUT_ERROR;
+}
+
+/**
+ * @brief List the displays to target, all detected displays or just one.
+ * @param connection open service connection
+ * @param display_number the display to target, -1 for all displays
+ * @param display_numbers for returning the display numbers (gint)
+ * @param edids for returning the base64 encoded EDIDs, may be NULL
+ * @return COMPLETED_WITHOUT_ERROR, SERVICE_ERROR or DBUS_ERROR
+ */
+static cmd_status_t list_target_displays(GDBusConnection *connection, int display_number, GArray *display_numbers,
+                                         GPtrArray *edids) {
+    GError *error = NULL;
+    GVariant *result = g_dbus_connection_call_sync(connection, DBUS_BUS_NAME, DBUS_OBJECT_PATH,
+                                                   DBUS_INTERFACE_NAME, "ListDetected", g_variant_new("(u)", 0),
+                                                   G_VARIANT_TYPE("(ia(iiisssqsu)is)"), G_DBUS_CALL_FLAGS_NONE,
+                                                   -1, NULL, &error);
+    if (result == NULL) {
+        return handle_dbus_error("ListDetected", error);
+    }
+    GVariantIter *array_iter;
+    GVariant *array_element;
+    g_variant_get(result, "(ia(iiisssqsu)is)", NULL, &array_iter, NULL, NULL);
+    while ((array_element = g_variant_iter_next_value(array_iter)) != NULL) {
+        gint number;
+        gchar *edid_base64_encoded;
+        g_variant_get(array_element, "(iiisssqsu)", &number, NULL, NULL, NULL, NULL, NULL, NULL,
+                      &edid_base64_encoded, NULL);
+        if (display_number == -1 || display_number == number) {
+            g_array_append_val(display_numbers, number);
+            if (edids != NULL) {
+                g_ptr_array_add(edids, g_strdup(edid_base64_encoded));
+            }
+        }
+        g_free(edid_base64_encoded);
+        g_variant_unref(array_element);
+    }
+    g_variant_iter_free(array_iter);
+    g_variant_unref(result);
+    if (display_numbers->len == 0) {
+        g_printerr("ERROR: No displays to benchmark.\n");
+        return SERVICE_ERROR;
+    }
+    return COMPLETED_WITHOUT_ERROR;
+}
+
+/**
+ * @brief Read a VCP code's value on each display, for writing back.
+ * @param connection open service connection
+ * @param display_numbers the displays (gint)
+ * @param vcp_code the VCP code
+ * @param values for returning the values (guint16)
+ * @return COMPLETED_WITHOUT_ERROR, SERVICE_ERROR or DBUS_ERROR
+ */
+static cmd_status_t read_restore_values(GDBusConnection *connection, GArray *display_numbers, guint8 vcp_code,
+                                        GArray *values) {
+    GError *error = NULL;
+    for (guint i = 0; i < display_numbers->len; i++) {
+        const gint number = g_array_index(display_numbers, gint, i);
+        GVariant *result = g_dbus_connection_call_sync(connection, DBUS_BUS_NAME, DBUS_OBJECT_PATH,
+                                                       DBUS_INTERFACE_NAME, "GetVcp",
+                                                       g_variant_new("(isyu)", number, "", vcp_code, 0),
+                                                       G_VARIANT_TYPE("(qqsis)"), G_DBUS_CALL_FLAGS_NONE,
+                                                       -1, NULL, &error);
+        if (result == NULL) {
+            return handle_dbus_error("GetVcp", error);
+        }
+        guint16 value;
+        gint32 status;
+        g_variant_get(result, "(qqsis)", &value, NULL, NULL, &status, NULL);
+        g_variant_unref(result);
+        if (status != 0) {
+            g_printerr("ERROR: Cannot read the value to write back to display %d (status %d).\n", number, status);
+            return SERVICE_ERROR;
+        }
+        g_array_append_val(values, value);
+    }
+    return COMPLETED_WITHOUT_ERROR;
+}
+
+/**
+ * @brief Implements the bench command, a D-Bus load generator.
+ * @param connection open service connection
+ * @param display_number the display to target, -1 for all displays
+ * @param vcp_args VCP codes, the first is used by GetVcp and SetVcp, all are used by GetMultipleVcp
+ * @param concurrency number of calls to keep in flight
+ * @param duration_seconds how long to run for
+ * @param mix the method mix
+ * @return COMPLETED_WITHOUT_ERROR, SERVICE_ERROR, DBUS_ERROR or SYNTAX_ERROR
+ */
+static cmd_status_t run_bench(GDBusConnection *connection, int display_number, gchar **vcp_args,
+                              int concurrency, double duration_seconds, const char *mix) {
+    Bench_Run run = {
+        .connection = connection,
+        .methods = {
+            {"getvcp", "GetVcp"},
+            {"setvcp", "SetVcp"},
+            {"getmultiplevcp", "GetMultipleVcp"},
+            {"list", "ListDetected"},
+        },
+        .display_numbers = g_array_new(FALSE, FALSE, sizeof(gint)),
+        .restore_values = g_array_new(FALSE, FALSE, sizeof(guint16)),
+        .vcp_codes = g_array_new(FALSE, FALSE, sizeof(guint8)),
+        .error_counts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL),
+        .status_names = get_property_names(connection, "StatusValues"),
+        .main_loop = g_main_loop_new(NULL, FALSE),
+    };
+    cmd_status_t status = bench_parse_mix(&run, mix);
+    for (gchar **arg = vcp_args; status == COMPLETED_WITHOUT_ERROR && *arg != NULL; arg++) {
+        const guint8 vcp_code = (guint8) parse_int(*arg, 16, &status);
+        g_array_append_val(run.vcp_codes, vcp_code);
+        if (status != COMPLETED_WITHOUT_ERROR) {
+            g_printerr("ERROR: Invalid VCP code. It must be in hex format (e.g. 0x10).\n");
+        }
+    }
+    if (status == COMPLETED_WITHOUT_ERROR && run.vcp_codes->len == 0) {
+        const guint8 default_codes[] = {0x10, 0x12};
+        g_array_append_vals(run.vcp_codes, default_codes, G_N_ELEMENTS(default_codes));
+    }
+    if (status == COMPLETED_WITHOUT_ERROR && (concurrency < 1 || duration_seconds <= 0.0)) {
+        g_printerr("ERROR: Concurrency must be at least 1 and duration must be more than zero.\n");
+        status = SYNTAX_ERROR;
+    }
+    if (status == COMPLETED_WITHOUT_ERROR) {
+        status = list_target_displays(connection, display_number, run.display_numbers, NULL);
+    }
+    if (status == COMPLETED_WITHOUT_ERROR && run.methods[1].weight > 0) {
+        status = read_restore_values(connection, run.display_numbers, g_array_index(run.vcp_codes, guint8, 0),
+                                     run.restore_values);
+    }
+    if (status == COMPLETED_WITHOUT_ERROR) {
+        for (guint i = 0; i < G_N_ELEMENTS(run.methods); i++) {
+            run.methods[i].latencies_micros = g_array_new(FALSE, FALSE, sizeof(gint64));
+        }
+        g_print("bench: %u display(s), concurrency %d, duration %.1f s, mix %s\n",
+                run.display_numbers->len, concurrency, duration_seconds, mix);
+        const gint64 start_micros = g_get_monotonic_time();
+        run.end_micros = start_micros + (gint64) (duration_seconds * 1000000);
+        for (int i = 0; i < concurrency; i++) {
+            bench_issue_call(&run);
+        }
+        g_main_loop_run(run.main_loop);
+        const double elapsed_seconds = (g_get_monotonic_time() - start_micros) / 1000000.0;
+
+        bench_print_latency_heading();
+        GArray *all_micros = g_array_new(FALSE, FALSE, sizeof(gint64));
+        guint64 all_errors = 0;
+        for (guint i = 0; i < G_N_ELEMENTS(run.methods); i++) {
+            Bench_Method *method = &run.methods[i];
+            if (method->weight > 0) {
+                g_array_append_vals(all_micros, method->latencies_micros->data, method->latencies_micros->len);
+                all_errors += method->error_count;
+                bench_print_latency_row(method->method_name, method->latencies_micros, elapsed_seconds,
+                                        method->error_count);
+            }
+            g_array_free(method->latencies_micros, TRUE);
+        }
+        bench_print_latency_row("total", all_micros, elapsed_seconds, all_errors);
+        g_array_free(all_micros, TRUE);
+        if (g_hash_table_size(run.error_counts) > 0) {
+            g_print("errors by status:\n");
+            GHashTableIter iter;
+            gpointer key, value;
+            g_hash_table_iter_init(&iter, run.error_counts);
+            while (g_hash_table_iter_next(&iter, &key, &value)) {
+                g_print("  %s: %" G_GSIZE_FORMAT "\n", (const char *) key, GPOINTER_TO_SIZE(value));
+            }
+        }
+        status = all_errors == 0 ? COMPLETED_WITHOUT_ERROR : SERVICE_ERROR;
+    }
+    g_array_free(run.display_numbers, TRUE);
+    g_array_free(run.restore_values, TRUE);
+    g_array_free(run.vcp_codes, TRUE);
+    g_hash_table_destroy(run.error_counts);
+    g_hash_table_destroy(run.status_names);
+    g_main_loop_unref(run.main_loop);
+    return status;
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * Signal benchmark, the bench-signals command.
+ *
+ * In VCP mode, bursts of SetVcpWithContext calls carry a sequence number in their client-context, so each
+ * VcpValueChanged signal can be matched to the call that caused it.  This gives the latency from call to
+ * signal, and counts of signals that were lost, duplicated or arrived out of order.
+ *
+ * In DPMS and hotplug modes, bursts of sleep/wake or disconnect/connect events are applied to one simulated
+ * display with SimulateEvent, so these modes refuse to run unless the service is started with --simulate,
+ * they never touch a real display.  SimulateEvent brings the service's internal poll forward, so the
+ * latency is the service's detection and signalling, not its poll interval.  The service keeps only the
+ * latest event of each poll, so the transitions of a burst that share a ConnectedDisplaysChanged signal
+ * are counted as coalesced, and a burst whose final state is never signalled is counted as lost.
+ */
+
+#define SIGNAL_BENCH_CONTEXT_PREFIX "bench-signals:"
+#define SIGNAL_BENCH_GRACE_MILLIS 2000
+
+typedef struct {
+    gint64 sent_micros;
+    gint display_index;
+    gint32 status;                // -1 until the reply arrives
+    guint signal_count;
+} Signal_Bench_Call;
+
+typedef struct Signal_Bench_Run Signal_Bench_Run;
+
+typedef struct {
+    Signal_Bench_Run *run;
+    guint sequence;
+} Signal_Bench_Pending;
+
+struct Signal_Bench_Run {
+    GDBusConnection *connection;
+    const gchar *unique_name;
+    gboolean event_mode;          // DPMS or hotplug, driven by SimulateEvent
+    const char *off_action;       // SimulateEvent event, sleep or disconnect
+    const char *on_action;        // wake or connect
+    guint8 vcp_code;
+    guint burst_size;
+    gint64 end_micros;
+    GArray *display_numbers;      // gint
+    GPtrArray *edids;             // gchar *, for matching ConnectedDisplaysChanged
+    GArray *restore_values;       // guint16, on each display
+    GArray *last_sequences;       // gint64, the last sequence signalled for each display, or -1
+    GArray *calls;                // Signal_Bench_Call, indexed by sequence
+    guint burst_remaining;        // Calls of the current burst still to be issued (DPMS) or replied to (VCP)
+    GArray *call_micros;          // gint64
+    GArray *signal_micros;        // gint64, call (or a burst's last write) to signal
+    guint64 call_errors;
+    guint64 duplicate_count;
+    guint64 out_of_order_count;
+    guint64 other_count;          // Signals caused by someone else
+    gint off_event;               // ConnectedDisplaysChanged event type for off_action
+    gint on_event;
+    gboolean off;                 // The state applied last
+    gint64 burst_end_micros;      // When the last event of a burst was sent
+    gboolean burst_final_signalled;
+    guint64 burst_count;
+    guint64 transition_count;
+    guint64 event_signal_count;
+    guint64 lost_bursts;
+    GMainLoop *main_loop;
+};
+
+static void signal_bench_start_burst(Signal_Bench_Run *run);
+
+static void signal_bench_vcp_signal(Signal_Bench_Run *run, GVariant *parameters, gint64 now_micros) {
+    const gchar *client_name, *client_context;
+    g_variant_get(parameters, "(isyq&s&su)", NULL, NULL, NULL, NULL, &client_name, &client_context, NULL);
+    if (g_strcmp0(client_name, run->unique_name) != 0 ||
+        !g_str_has_prefix(client_context, SIGNAL_BENCH_CONTEXT_PREFIX)) {
+        run->other_count++;
+        return;
+    }
+    const guint64 sequence = g_ascii_strtoull(client_context + strlen(SIGNAL_BENCH_CONTEXT_PREFIX), NULL, 10);
+    if (sequence >= run->calls->len) {
+        run->other_count++;
+        return;
+    }
+    Signal_Bench_Call *call = &g_array_index(run->calls, Signal_Bench_Call, sequence);
+    if (call->signal_count++ > 0) {
+        run->duplicate_count++;
+        return;
+    }
+    const gint64 latency_micros = now_micros - call->sent_micros;
+    g_array_append_val(run->signal_micros, latency_micros);
+    gint64 *last_sequence = &g_array_index(run->last_sequences, gint64, call->display_index);
+    if ((gint64) sequence < *last_sequence) {
+        run->out_of_order_count++;
+    }
+    *last_sequence = MAX(*last_sequence, (gint64) sequence);
+}
+
+static void signal_bench_event_signal(Signal_Bench_Run *run, GVariant *parameters, gint64 now_micros) {
+    const gchar *edid_txt;
+    gint32 event_type;
+    g_variant_get(parameters, "(&siu)", &edid_txt, &event_type, NULL);
+    // Connection events don't identify the display.
+    if ((edid_txt[0] != '\0' && g_strcmp0(edid_txt, g_ptr_array_index(run->edids, 0)) != 0) ||
+        (event_type != run->off_event && event_type != run->on_event)) {
+        run->other_count++;
+        return;
+    }
+    run->event_signal_count++;
+    if (run->burst_remaining == 0 && !run->burst_final_signalled &&
+        (event_type == run->off_event) == run->off) {
+        run->burst_final_signalled = TRUE;
+        const gint64 latency_micros = now_micros - run->burst_end_micros;
+        g_array_append_val(run->signal_micros, latency_micros);
+    }
+}
+
+static void signal_bench_receiver(GDBusConnection *connection,
+                                  const gchar *sender_name,
+                                  const gchar *object_path,
+                                  const gchar *interface_name,
+                                  const gchar *signal_name,
+                                  GVariant *parameters,
+                                  gpointer user_data) {
+    Signal_Bench_Run *run = user_data;
+    const gint64 now_micros = g_get_monotonic_time();
+    if (run->event_mode) {
+        signal_bench_event_signal(run, parameters, now_micros);
+    }
+    else {
+        signal_bench_vcp_signal(run, parameters, now_micros);
+    }
+}
+
+static gboolean signal_bench_finish(gpointer user_data) {
+    Signal_Bench_Run *run = user_data;
+    g_main_loop_quit(run->main_loop);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * @brief Called when an event burst's signals have had time to arrive, starts the next burst or finishes.
+ */
+static gboolean signal_bench_event_settled(gpointer user_data) {
+    Signal_Bench_Run *run = user_data;
+    run->transition_count += run->burst_size;
+    if (!run->burst_final_signalled) {
+        run->lost_bursts++;
+    }
+    if (g_get_monotonic_time() < run->end_micros) {
+        signal_bench_start_burst(run);
+    }
+    else {
+        g_main_loop_quit(run->main_loop);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * @brief Returns how long to wait for an event burst's signals, a poll cascade per transition.
+ */
+static guint signal_bench_event_wait_millis(Signal_Bench_Run *run) {
+    double cascade_seconds = 0.5;
+    GVariant *value = get_property_value(run->connection, "ServicePollCascadeInterval");
+    if (value != NULL) {
+        cascade_seconds = g_variant_get_double(value);
+        g_variant_unref(value);
+    }
+    return (guint) (cascade_seconds * (run->burst_size + 1) * 1000) + SIGNAL_BENCH_GRACE_MILLIS;
+}
+
+static void signal_bench_call_done(GObject *source, GAsyncResult *res, gpointer user_data) {
+    Signal_Bench_Pending *pending = user_data;
+    Signal_Bench_Run *run = pending->run;
+    GError *error = NULL;
+    GVariant *result = g_dbus_connection_call_finish(run->connection, res, &error);
+    Signal_Bench_Call *call = &g_array_index(run->calls, Signal_Bench_Call, pending->sequence);
+    g_free(pending);
+    const gint64 latency_micros = g_get_monotonic_time() - call->sent_micros;
+    g_array_append_val(run->call_micros, latency_micros);
+    if (result == NULL) {
+        call->status = G_MAXINT32;
+        g_error_free(error);
+    }
+    else {
+        g_variant_get(result, "(is)", &call->status, NULL);
+        g_variant_unref(result);
+    }
+    if (call->status != 0) {
+        run->call_errors++;
+    }
+    if (run->event_mode) {
+        if (run->burst_remaining > 0) {
+            signal_bench_start_burst(run);  // Events are sequential, issue the next one
+        }
+        else {
+            g_timeout_add(signal_bench_event_wait_millis(run), signal_bench_event_settled, run);
+        }
+    }
+    else if (--run->burst_remaining == 0) {
+        if (g_get_monotonic_time() < run->end_micros) {
+            signal_bench_start_burst(run);
+        }
+        else {
+            g_timeout_add(SIGNAL_BENCH_GRACE_MILLIS, signal_bench_finish, run);
+        }
+    }
+}
+
+/**
+ * @brief Send one SetVcpWithContext, recording it under the next sequence number.
+ */
+static void signal_bench_set_vcp(Signal_Bench_Run *run, guint display_index, guint8 vcp_code, guint16 value) {
+    const guint sequence = run->calls->len;
+    const Signal_Bench_Call call = {g_get_monotonic_time(), (gint) display_index, -1, 0};
+    g_array_append_val(run->calls, call);
+    Signal_Bench_Pending *pending = g_new(Signal_Bench_Pending, 1);
+    pending->run = run;
+    pending->sequence = sequence;
+    gchar *client_context = g_strdup_printf(SIGNAL_BENCH_CONTEXT_PREFIX "%u", sequence);
+    g_dbus_connection_call(run->connection, DBUS_BUS_NAME, DBUS_OBJECT_PATH, DBUS_INTERFACE_NAME,
+                           "SetVcpWithContext",
+                           g_variant_new("(isyqsu)", g_array_index(run->display_numbers, gint, display_index), "",
+                                         vcp_code, value, client_context, 0),
+                           G_VARIANT_TYPE("(is)"), G_DBUS_CALL_FLAGS_NONE, -1, NULL,
+                           signal_bench_call_done, pending);
+    g_free(client_context);
+}
+
+/**
+ * @brief Send one SimulateEvent to the target display, recording it under the next sequence number.
+ */
+static void signal_bench_simulate_event(Signal_Bench_Run *run, const char *action) {
+    const Signal_Bench_Call call = {g_get_monotonic_time(), 0, -1, 0};
+    g_array_append_val(run->calls, call);
+    Signal_Bench_Pending *pending = g_new(Signal_Bench_Pending, 1);
+    pending->run = run;
+    pending->sequence = run->calls->len - 1;
+    g_dbus_connection_call(run->connection, DBUS_BUS_NAME, DBUS_OBJECT_PATH, DBUS_INTERFACE_NAME,
+                           "SimulateEvent",
+                           g_variant_new("(ssu)", (const gchar *) g_ptr_array_index(run->edids, 0), action, 0),
+                           G_VARIANT_TYPE("(is)"), G_DBUS_CALL_FLAGS_NONE, -1, NULL,
+                           signal_bench_call_done, pending);
+}
+
+/**
+ * @brief Start a burst, or in DPMS and hotplug modes, issue the burst's next event.
+ */
+static void signal_bench_start_burst(Signal_Bench_Run *run) {
+    if (run->event_mode) {
+        if (run->burst_remaining == 0) {
+            run->burst_remaining = run->burst_size;
+            run->burst_final_signalled = FALSE;
+            run->burst_count++;
+        }
+        run->burst_remaining--;
+        run->off = !run->off;
+        run->burst_end_micros = g_get_monotonic_time();
+        signal_bench_simulate_event(run, run->off ? run->off_action : run->on_action);
+    }
+    else {
+        run->burst_remaining = run->burst_size;
+        run->burst_count++;
+        for (guint i = 0; i < run->burst_size; i++) {
+            const guint display_index = (guint) (run->calls->len % run->display_numbers->len);
+            signal_bench_set_vcp(run, display_index, run->vcp_code,
+                                 g_array_index(run->restore_values, guint16, display_index));
+        }
+    }
+}
+
+/**
+ * @brief Find the event type numbers for the mode's off and on events from the DisplayEventTypes property.
+ * @param off_name the off event's name, for example, DDCA_EVENT_DPMS_ASLEEP
+ * @param on_name the on event's name
+ * @return COMPLETED_WITHOUT_ERROR or SERVICE_ERROR
+ */
+static cmd_status_t signal_bench_find_events(Signal_Bench_Run *run, const char *off_name, const char *on_name) {
+    GHashTable *event_names = get_property_names(run->connection, "DisplayEventTypes");
+    run->off_event = run->on_event = -1;
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, event_names);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        if (g_strcmp0(value, off_name) == 0) {
+            run->off_event = GPOINTER_TO_INT(key);
+        }
+        else if (g_strcmp0(value, on_name) == 0) {
+            run->on_event = GPOINTER_TO_INT(key);
+        }
+    }
+    g_hash_table_destroy(event_names);
+    if (run->off_event == -1 || run->on_event == -1) {
+        g_printerr("ERROR: The service does not report %s and %s events (property DisplayEventTypes).\n",
+                   off_name, on_name);
+        return SERVICE_ERROR;
+    }
+    GVariant *enabled = get_property_value(run->connection, "ServiceEmitConnectivitySignals");
+    const gboolean signals_enabled = enabled != NULL && g_variant_get_boolean(enabled);
+    if (enabled != NULL) {
+        g_variant_unref(enabled);
+    }
+    if (!signals_enabled) {
+        g_printerr("ERROR: The service is not emitting ConnectedDisplaysChanged (property ServiceEmitConnectivitySignals).\n");
+        return SERVICE_ERROR;
+    }
+    return COMPLETED_WITHOUT_ERROR;
+}
+
+/**
+ * @brief Put the target display into its on state, which also checks that the service is simulating.
+ * @return COMPLETED_WITHOUT_ERROR, SERVICE_ERROR or DBUS_ERROR
+ */
+static cmd_status_t signal_bench_reset_simulated(Signal_Bench_Run *run) {
+    GError *error = NULL;
+    GVariant *result = g_dbus_connection_call_sync(run->connection, DBUS_BUS_NAME, DBUS_OBJECT_PATH,
+                                                   DBUS_INTERFACE_NAME, "SimulateEvent",
+                                                   g_variant_new("(ssu)",
+                                                                 (const gchar *) g_ptr_array_index(run->edids, 0),
+                                                                 run->on_action, 0),
+                                                   G_VARIANT_TYPE("(is)"), G_DBUS_CALL_FLAGS_NONE,
+                                                   -1, NULL, &error);
+    if (result == NULL) {
+        g_printerr("ERROR: SimulateEvent failed: %s\n", error->message);
+        g_error_free(error);
+        return DBUS_ERROR;
+    }
+    gint32 error_status;
+    const gchar *error_message;
+    g_variant_get(result, "(i&s)", &error_status, &error_message);
+    if (error_status != 0) {
+        g_printerr("ERROR: %s\n"
+                   "The dpms and hotplug modes drive simulated events, they need ddcutil-service --simulate.\n",
+                   error_message);
+    }
+    g_variant_unref(result);
+    return error_status == 0 ? COMPLETED_WITHOUT_ERROR : SERVICE_ERROR;
+}
+
+/**
+ * @brief Implements the bench-signals command, measures signal latency and loss under bursts.
+ * @param connection open service connection
+ * @param display_number the display to target, -1 for all displays (first display in DPMS and hotplug modes)
+ * @param mode_arg "dpms", "hotplug", or the VCP code to write in VCP mode, NULL for 0x10
+ * @param burst_size number of calls in each burst
+ * @param duration_seconds how long to keep starting bursts for
+ * @return COMPLETED_WITHOUT_ERROR, SERVICE_ERROR, DBUS_ERROR or SYNTAX_ERROR
+ */
+static cmd_status_t run_signal_bench(GDBusConnection *connection, int display_number, const char *mode_arg,
+                                     int burst_size, double duration_seconds) {
+    Signal_Bench_Run run = {
+        .connection = connection,
+        .unique_name = g_dbus_connection_get_unique_name(connection),
+        .event_mode = g_strcmp0(mode_arg, "dpms") == 0 || g_strcmp0(mode_arg, "hotplug") == 0,
+        .vcp_code = 0x10,
+        .burst_size = (guint) burst_size,
+        .display_numbers = g_array_new(FALSE, FALSE, sizeof(gint)),
+        .edids = g_ptr_array_new_with_free_func(g_free),
+        .restore_values = g_array_new(FALSE, FALSE, sizeof(guint16)),
+        .last_sequences = g_array_new(FALSE, FALSE, sizeof(gint64)),
+        .calls = g_array_new(FALSE, FALSE, sizeof(Signal_Bench_Call)),
+        .call_micros = g_array_new(FALSE, FALSE, sizeof(gint64)),
+        .signal_micros = g_array_new(FALSE, FALSE, sizeof(gint64)),
+        .main_loop = g_main_loop_new(NULL, FALSE),
+    };
+    cmd_status_t status = COMPLETED_WITHOUT_ERROR;
+    const gboolean hotplug = g_strcmp0(mode_arg, "hotplug") == 0;
+    run.off_action = hotplug ? "disconnect" : "sleep";
+    run.on_action = hotplug ? "connect" : "wake";
+    if (mode_arg != NULL && !run.event_mode) {
+        run.vcp_code = (guint8) parse_int((char *) mode_arg, 16, &status);
+        if (status != COMPLETED_WITHOUT_ERROR) {
+            g_printerr("ERROR: Invalid VCP code. It must be in hex format (e.g. 0x10), dpms or hotplug.\n");
+        }
+    }
+    if (status == COMPLETED_WITHOUT_ERROR && (burst_size < 1 || duration_seconds <= 0.0)) {
+        g_printerr("ERROR: Concurrency must be at least 1 and duration must be more than zero.\n");
+        status = SYNTAX_ERROR;
+    }
+    if (status == COMPLETED_WITHOUT_ERROR) {
+        status = list_target_displays(connection, display_number, run.display_numbers, run.edids);
+    }
+    if (status == COMPLETED_WITHOUT_ERROR) {
+        if (run.event_mode) {
+            g_array_set_size(run.display_numbers, 1);  // One display, so its transitions can coalesce
+            run.burst_size |= 1;  // An odd number of transitions, so each burst changes the final state
+            status = hotplug ? signal_bench_find_events(&run, "DDCA_EVENT_DISPLAY_DISCONNECTED",
+                                                        "DDCA_EVENT_DISPLAY_CONNECTED")
+                             : signal_bench_find_events(&run, "DDCA_EVENT_DPMS_ASLEEP", "DDCA_EVENT_DPMS_AWAKE");
+            if (status == COMPLETED_WITHOUT_ERROR) {
+                status = signal_bench_reset_simulated(&run);
+            }
+        }
+        else {
+            status = read_restore_values(connection, run.display_numbers, run.vcp_code, run.restore_values);
+        }
+    }
+    const char *signal_name = run.event_mode ? "ConnectedDisplaysChanged" : "VcpValueChanged";
+    guint subscription_id = 0;
+    if (status == COMPLETED_WITHOUT_ERROR) {
+        subscription_id = g_dbus_connection_signal_subscribe(connection,
+                                                             DBUS_BUS_NAME,
+                                                             DBUS_INTERFACE_NAME,
+                                                             signal_name,
+                                                             NULL,
+                                                             NULL,
+                                                             G_DBUS_SIGNAL_FLAGS_NONE,
+                                                             signal_bench_receiver,
+                                                             &run,
+                                                             NULL);
+        if (subscription_id == 0) {
+            g_printerr("ERROR: Failed to subscribe to the %s signal.\n", signal_name);
+            status = DBUS_ERROR;
+        }
+    }
+    if (status == COMPLETED_WITHOUT_ERROR) {
+        for (guint i = 0; i < run.display_numbers->len; i++) {
+            const gint64 none = -1;
+            g_array_append_val(run.last_sequences, none);
+        }
+        if (run.event_mode) {
+            g_print("bench-signals: %s on simulated display %d, burst %u, duration %.1f s, allow %.1f s for each burst\n",
+                    mode_arg, g_array_index(run.display_numbers, gint, 0), run.burst_size, duration_seconds,
+                    signal_bench_event_wait_millis(&run) / 1000.0);
+        }
+        else {
+            g_print("bench-signals: vcp 0x%02x on %u display(s), burst %d, duration %.1f s\n",
+                    run.vcp_code, run.display_numbers->len, burst_size, duration_seconds);
+        }
+        const gint64 start_micros = g_get_monotonic_time();
+        run.end_micros = start_micros + (gint64) (duration_seconds * 1000000);
+        signal_bench_start_burst(&run);
+        g_main_loop_run(run.main_loop);
+        const double elapsed_seconds = (g_get_monotonic_time() - start_micros) / 1000000.0;
+
+        bench_print_latency_heading();
+        bench_print_latency_row(run.event_mode ? "SimulateEvent" : "SetVcpWithContext", run.call_micros,
+                                elapsed_seconds, run.call_errors);
+        if (run.event_mode) {
+            bench_print_latency_row(signal_name, run.signal_micros, elapsed_seconds, run.lost_bursts);
+            const guint64 coalesced = run.transition_count > run.event_signal_count
+                                          ? run.transition_count - run.event_signal_count : 0;
+            g_print("bursts: %" G_GUINT64_FORMAT "  transitions: %" G_GUINT64_FORMAT
+                    "  signals: %" G_GUINT64_FORMAT "  coalesced: %" G_GUINT64_FORMAT
+                    "  lost bursts: %" G_GUINT64_FORMAT "  other signals: %" G_GUINT64_FORMAT "\n",
+                    run.burst_count, run.transition_count, run.event_signal_count, coalesced,
+                    run.lost_bursts, run.other_count);
+            status = run.call_errors == 0 && run.lost_bursts == 0 ? COMPLETED_WITHOUT_ERROR : SERVICE_ERROR;
+            if (run.off) {  // Leave the display awake and connected
+                signal_bench_reset_simulated(&run);
+            }
+        }
+        else {
+            guint64 expected = 0, lost = 0;
+            for (guint i = 0; i < run.calls->len; i++) {
+                const Signal_Bench_Call *call = &g_array_index(run.calls, Signal_Bench_Call, i);
+                if (call->status == 0) {
+                    expected++;
+                    if (call->signal_count == 0) {
+                        lost++;
+                    }
+                }
+            }
+            bench_print_latency_row(signal_name, run.signal_micros, elapsed_seconds, lost);
+            g_print("bursts: %" G_GUINT64_FORMAT "  expected: %" G_GUINT64_FORMAT "  received: %u"
+                    "  lost: %" G_GUINT64_FORMAT "  duplicates: %" G_GUINT64_FORMAT
+                    "  out of order: %" G_GUINT64_FORMAT "  other signals: %" G_GUINT64_FORMAT "\n",
+                    run.burst_count, expected, run.signal_micros->len, lost, run.duplicate_count,
+                    run.out_of_order_count, run.other_count);
+            status = run.call_errors == 0 && lost == 0 ? COMPLETED_WITHOUT_ERROR : SERVICE_ERROR;
+        }
+    }
+    if (subscription_id != 0) {
+        g_dbus_connection_signal_unsubscribe(connection, subscription_id);
+    }
+    g_array_free(run.display_numbers, TRUE);
+    g_ptr_array_free(run.edids, TRUE);
+    g_array_free(run.restore_values, TRUE);
+    g_array_free(run.last_sequences, TRUE);
+    g_array_free(run.calls, TRUE);
+    g_array_free(run.call_micros, TRUE);
+    g_array_free(run.signal_micros, TRUE);
+    g_main_loop_unref(run.main_loop);
+    return status;
+}
+
 int main(int argc, char *argv[]) {
     GError *error = NULL;
     GOptionContext *context;
@@ -626,10 +1690,35 @@ int main(int argc, char *argv[]) {
     double cascade_interval = DBL_MAX;
     gint output_level = -2;
     gint attributes_detect = 0;
-
-    connection = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, &error);
+    gchar *bus_address = NULL;
+    gint concurrency = 4;
+    gdouble duration = 10.0;
+    gchar *mix = BENCH_DEFAULT_MIX;
+
+    // The connection is needed while parsing the property options, so find any bus address first.
+    GOptionEntry connection_entries[] = {
+            {"bus-address",      'b', 0,                          G_OPTION_ARG_STRING,       &bus_address},
+            {NULL}
+    };
+    GOptionContext *connection_context = g_option_context_new(NULL);
+    g_option_context_set_help_enabled(connection_context, FALSE);
+    g_option_context_set_ignore_unknown_options(connection_context, TRUE);
+    g_option_context_add_main_entries(connection_context, connection_entries, NULL);
+    gchar **connection_args = g_strdupv(argv);
+    g_option_context_parse_strv(connection_context, &connection_args, NULL);
+    g_strfreev(connection_args);
+    g_option_context_free(connection_context);
+
+    if (bus_address != NULL) {
+        connection = g_dbus_connection_new_for_address_sync(bus_address,
+                                                            G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                                                            G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+                                                            NULL, NULL, &error);
+    } else {
+        connection = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, &error);
+    }
     if (!connection) {
-        g_printerr("ERROR: Error connecting to session bus: %s\n", error->message);
+        g_printerr("ERROR: Error connecting to %s: %s\n", bus_address ? bus_address : "session bus", error->message);
         g_error_free(error);
         return DBUS_ERROR;
     }
@@ -651,12 +1740,16 @@ int main(int argc, char *argv[]) {
             {"poll-interval",    't', 0,                          G_OPTION_ARG_INT,          &poll_interval,        "hotplug/connectivity poll seconds >=30, 0 to query"},
             {"cascade-interval", 'c', 0,                          G_OPTION_ARG_DOUBLE,       &cascade_interval,     "hotplug/connectivity cascade seconds >=0.5, 0 to query"},
             {"output-level",     'o', 0,                          G_OPTION_ARG_INT,          &output_level,         "ddcutil output level, -1 to query"},
+            {"bus-address",      'b', 0,                          G_OPTION_ARG_STRING,       &bus_address,          "connect to the D-Bus daemon at ADDRESS instead of the session bus", "ADDRESS"},
+            {"concurrency",      'n', 0,                          G_OPTION_ARG_INT,          &concurrency,          "bench: number of calls in flight, bench-signals: burst size (default 4)"},
+            {"duration",         'D', 0,                          G_OPTION_ARG_DOUBLE,       &duration,             "bench and bench-signals: seconds to run for (default 10)"},
+            {"mix",              'm', 0,                          G_OPTION_ARG_STRING,       &mix,                  "bench: method weights (default " BENCH_DEFAULT_MIX ")"},
             {G_OPTION_REMAINING, 0,   0,                          G_OPTION_ARG_STRING_ARRAY, &remaining_args},
             {NULL}
     };
 
     context = g_option_context_new(
-            "[detect | list | capabilities | capabilities-terse | getvcp 0xNN | setvcp 0xNN n | wait-for-connection-change | wait-for-vcp-change | wait]");
+            "[detect | list | capabilities | capabilities-terse | getvcp 0xNN | setvcp 0xNN n | wait-for-connection-change | wait-for-vcp-change | wait | trace [FILE] | bench [0xNN...] | bench-signals [0xNN | dpms | hotplug]]");
     g_option_context_add_main_entries(context, entries, NULL);
     if (!g_option_context_parse(context, &argc, &argv, &error)) {
         g_printerr("ERROR: Error parsing options: %s\n", error->message);
@@ -794,6 +1887,12 @@ int main(int argc, char *argv[]) {
         } else if (g_strcmp0(method, "wait") == 0) {
             gchar* signals[] = {"ConnectedDisplaysChanged", "VcpValueChanged", NULL};
             exit_status = wait_for_signal(signals);
+        } else if (g_strcmp0(method, "trace") == 0) {
+            exit_status = remaining_args[1] ? dump_trace_file(remaining_args[1]) : call_get_trace(connection);
+        } else if (g_strcmp0(method, "bench") == 0) {
+            exit_status = run_bench(connection, display_number, remaining_args + 1, concurrency, duration, mix);
+        } else if (g_strcmp0(method, "bench-signals") == 0) {
+            exit_status = run_signal_bench(connection, display_number, remaining_args[1], concurrency, duration);
         }  else {
             g_printerr("ERROR: Unknown command: %s\n", method);
             exit_status = SYNTAX_ERROR;
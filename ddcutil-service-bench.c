@@ -0,0 +1,286 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2026 Contributors to ddcutil-service <https://github.com/digitaltrails/ddcutil-service>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+/* ----------------------------------------------------------------------------------------------------
+ * ddcutil-service-bench.c
+ * -----------------------
+ * Microbenchmarks for the hot helpers in ddcutil-service.c
+ *
+ * Copyright (C) 2023-2026, Contributors to ddcutil-service
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Built by "make bench", which also runs it.  The service source is included whole, so the helpers are
+ * measured exactly as the service compiles them, with the display simulator standing in for libddcutil's
+ * display list and display handles.  Display lists of 1 to 64 simulated displays are used for the helpers
+ * whose cost depends on the number of displays.
+ *
+ * Each benchmark is repeated until it has run for at least BENCH_MIN_MICROS, and reports the time and the
+ * number of heap allocations (malloc, calloc and realloc calls, including those made inside glib and
+ * libddcutil) per operation.
+ *
+ * Usage: ddcutil-service-bench [NAME-SUBSTRING]
+ */
+
+#define main ddcutil_service_main
+#include "ddcutil-service.c"
+#undef main
+
+#define BENCH_MIN_MICROS 200000
+#define BENCH_MAX_DISPLAYS 64
+
+/* ----------------------------------------------------------------------------------------------------
+ * Allocation counting
+ *
+ * malloc, calloc and realloc defined here take precedence over libc's for the whole process, including
+ * glib and libddcutil, and pass through to glibc's implementation.
+ */
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+
+static gboolean bench_counting = FALSE;
+static guint64 bench_allocations = 0;
+
+void* malloc(size_t size) {
+    if (bench_counting) {
+        bench_allocations++;
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (bench_counting) {
+        bench_allocations++;
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (bench_counting) {
+        bench_allocations++;
+    }
+    return __libc_realloc(ptr, size);
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * Fixtures
+ */
+
+static const char* bench_capabilities =
+    "(prot(monitor)type(LCD)model(27UK650)cmds(01 02 03 0C E3 F3)vcp(02 04 05 08 10 12 14(05 08 0B) 16 18 1A "
+    "52 60(11 12 0F 10) AC AE B2 B6 C0 C6 C8 C9 D6(01 04) DF 62 8D F4 F5(00 01 02) F6(00 01 02) 4D 4E 4F "
+    "15(01 06 09 10 11 13 14 28 29 32 48) F7(00 01 02 03) F8(00 01) F9 E4 E5 E6 E7 E8 E9 EA EB EF FD(00 01) "
+    "FE(00 01 02) FF)mccs_ver(2.1)mswhql(1))";
+
+static DDCA_Display_Info_List* bench_dlist = NULL;  // The currently detected simulated displays
+static GList* bench_poll_list = NULL;               // A poll_list item for each of them
+static gchar* bench_last_edid = NULL;               // Encoded EDID of the last display in the list
+static int bench_last_dispno = 0;
+static DDCA_Capabilities* bench_parsed_capabilities = NULL;
+static DDCA_Display_Handle bench_disp_handle = NULL;
+static const void* volatile bench_sink;             // Keeps results the compiler could otherwise discard
+
+/**
+ * @brief Load BENCH_MAX_DISPLAYS simulated displays, all disconnected.
+ */
+static void bench_load_displays(void) {
+    GKeyFile* key_file = g_key_file_new();
+    for (int i = 0; i < BENCH_MAX_DISPLAYS; i++) {
+        gchar* group = g_strdup_printf("display-%d", i + 1);
+        gchar* serial = g_strdup_printf("BENCH%04d", i + 1);
+        g_key_file_set_string(key_file, group, "mfg-id", "SIM");
+        g_key_file_set_string(key_file, group, "model", "Bench Model");
+        g_key_file_set_string(key_file, group, "serial", serial);
+        g_key_file_set_string(key_file, group, "capabilities", bench_capabilities);
+        g_key_file_set_string(key_file, group, "vcp-10", "50/100");
+        g_key_file_set_boolean(key_file, group, "connected", FALSE);
+        g_free(serial);
+        g_free(group);
+    }
+    GError* error = NULL;
+    if (!sim_load_key_file(key_file, "benchmark fixtures", &error)) {
+        g_printerr("Failed to load simulated displays: %s\n", error->message);
+        exit(1);
+    }
+    g_key_file_free(key_file);
+}
+
+/**
+ * @brief Connect and detect the first display_count simulated displays, and build the matching fixtures.
+ * @param display_count number of displays
+ */
+static void bench_set_displays(const int display_count) {
+    for (guint i = 0; i < sim_displays->len; i++) {
+        ((Sim_Display*) g_ptr_array_index(sim_displays, i))->connected = i < display_count;
+    }
+    backend->redetect_displays();
+    backend->free_display_info_list(bench_dlist);
+    backend->get_display_info_list2(FALSE, &bench_dlist);
+    g_list_free_full(bench_poll_list, g_free);
+    bench_poll_list = NULL;
+    for (int ndx = 0; ndx < bench_dlist->ct; ndx++) {
+        Poll_List_Item* item = g_new0(Poll_List_Item, 1);
+        item->edid_encoded = edid_encode(bench_dlist->info[ndx].edid_bytes);
+        item->connected = TRUE;
+        bench_poll_list = g_list_append(bench_poll_list, item);
+    }
+    g_free(bench_last_edid);
+    bench_last_edid = edid_encode(bench_dlist->info[bench_dlist->ct - 1].edid_bytes);
+    bench_last_dispno = bench_dlist->info[bench_dlist->ct - 1].dispno;
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * Benchmarks
+ */
+
+static void bench_edid_encode(void) {
+    g_free(edid_encode(bench_dlist->info[0].edid_bytes));
+}
+
+static void bench_edid_to_binary_serial_number(void) {
+    bench_sink = GUINT_TO_POINTER(edid_to_binary_serial_number(bench_dlist->info[0].edid_bytes));
+}
+
+static void bench_sanitize_utf8(void) {
+    g_free(sanitize_utf8(bench_dlist->info[0].model_name));
+}
+
+static void bench_sanitize_utf8_invalid(void) {
+    g_free(sanitize_utf8("Bench\xF0\xA4\xAD Model"));
+}
+
+static void bench_get_status_message_ok(void) {
+    g_free(get_status_message(DDCRC_OK));
+}
+
+static void bench_get_status_message_error(void) {
+    g_free(get_status_message(DDCRC_RETRIES));
+}
+
+static void bench_find_display_info_by_number(void) {
+    bench_sink = find_display_info(bench_dlist, bench_last_dispno, NULL, FALSE);
+}
+
+static void bench_find_display_info_by_edid(void) {
+    bench_sink = find_display_info(bench_dlist, -1, bench_last_edid, FALSE);
+}
+
+static void bench_get_display_info_by_number(void) {
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL;
+    get_display_info(bench_last_dispno, "", &info_list, &vdu_info, FALSE);
+    backend->free_display_info_list(info_list);
+}
+
+static void bench_get_display_info_by_edid(void) {
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL;
+    get_display_info(-1, bench_last_edid, &info_list, &vdu_info, FALSE);
+    backend->free_display_info_list(info_list);
+}
+
+static void bench_poll_list_search(void) {
+    bench_sink = g_list_find_custom(bench_poll_list, bench_last_edid, pollcmp);
+}
+
+static void bench_detect_variant(void) {
+    GVariantBuilder builder;
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a(iiisssqsu)"));
+    add_detected_displays(&builder, bench_dlist);
+    g_variant_unref(g_variant_ref_sink(g_variant_builder_end(&builder)));
+}
+
+static void bench_capabilities_metadata_variant(void) {
+    GVariantBuilder command_dict_builder;
+    GVariantBuilder feature_dict_builder;
+    g_variant_builder_init(&command_dict_builder, G_VARIANT_TYPE("a{ys}"));
+    g_variant_builder_init(&feature_dict_builder, G_VARIANT_TYPE("a{y(ssa{ys})}"));
+    add_capabilities_metadata(bench_parsed_capabilities, bench_disp_handle,
+                              &command_dict_builder, &feature_dict_builder);
+    g_variant_unref(g_variant_ref_sink(g_variant_builder_end(&command_dict_builder)));
+    g_variant_unref(g_variant_ref_sink(g_variant_builder_end(&feature_dict_builder)));
+}
+
+/**
+ * @brief Time a benchmark, doubling the iterations until it runs for long enough, and print the result.
+ * @param filter only run benchmarks whose name contains this, NULL for all
+ * @param name benchmark name
+ * @param display_count number of displays in the fixtures
+ * @param func the operation to time
+ */
+static void bench_run(const char* filter, const char* name, const int display_count, void (*func)(void)) {
+    if (filter != NULL && strstr(name, filter) == NULL) {
+        return;
+    }
+    func();  // Warm up
+    guint64 iterations = 1;
+    while (TRUE) {
+        bench_allocations = 0;
+        bench_counting = TRUE;
+        const long start_micros = g_get_monotonic_time();
+        for (guint64 i = 0; i < iterations; i++) {
+            func();
+        }
+        const long elapsed_micros = g_get_monotonic_time() - start_micros;
+        bench_counting = FALSE;
+        if (elapsed_micros >= BENCH_MIN_MICROS) {
+            g_print("%-36s %8d %12.1f %12.2f\n", name, display_count,
+                    elapsed_micros * 1000.0 / iterations, (double) bench_allocations / iterations);
+            return;
+        }
+        iterations *= 2;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const char* filter = argc > 1 ? argv[1] : NULL;
+
+    bench_load_displays();
+    bench_set_displays(1);
+
+    if (ddca_parse_capabilities_string((char*) bench_capabilities, &bench_parsed_capabilities) != DDCRC_OK
+        || backend->open_display2(bench_dlist->info[0].dref, TRUE, &bench_disp_handle) != DDCRC_OK) {
+        g_printerr("Failed to set up the capabilities fixture\n");
+        exit(1);
+    }
+
+    g_print("%-36s %8s %12s %12s\n", "benchmark", "displays", "ns/op", "allocs/op");
+    bench_run(filter, "edid_encode", 1, bench_edid_encode);
+    bench_run(filter, "edid_to_binary_serial_number", 1, bench_edid_to_binary_serial_number);
+    bench_run(filter, "sanitize_utf8", 1, bench_sanitize_utf8);
+    bench_run(filter, "sanitize_utf8 invalid", 1, bench_sanitize_utf8_invalid);
+    bench_run(filter, "get_status_message ok", 1, bench_get_status_message_ok);
+    bench_run(filter, "get_status_message error", 1, bench_get_status_message_error);
+    bench_run(filter, "GetCapabilitiesMetadata variant", 1, bench_capabilities_metadata_variant);
+
+    for (int display_count = 1; display_count <= BENCH_MAX_DISPLAYS; display_count *= 2) {
+        bench_set_displays(display_count);
+        bench_run(filter, "find_display_info by number", display_count, bench_find_display_info_by_number);
+        bench_run(filter, "find_display_info by edid", display_count, bench_find_display_info_by_edid);
+        bench_run(filter, "get_display_info by number", display_count, bench_get_display_info_by_number);
+        bench_run(filter, "get_display_info by edid", display_count, bench_get_display_info_by_edid);
+        bench_run(filter, "poll_list search", display_count, bench_poll_list_search);
+        bench_run(filter, "Detect variant", display_count, bench_detect_variant);
+    }
+
+    backend->close_display(bench_disp_handle);
+    ddca_free_parsed_capabilities(bench_parsed_capabilities);
+    return 0;
+}
@@ -57,6 +57,11 @@
 #include <glob.h>
 #include <unistd.h>
 #include <spawn.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 #include <ddcutil_c_api.h>
 #include <ddcutil_status_codes.h>
@@ -64,7 +69,7 @@
 
 #include "ddcutil-service-introspection-xml.h"
 
-#define DDCUTIL_DBUS_INTERFACE_VERSION_STRING "1.0.15"
+#define DDCUTIL_DBUS_INTERFACE_VERSION_STRING "1.0.16"
 #define DDCUTIL_DBUS_DOMAIN "com.ddcutil.DdcutilService"
 
 #if DDCUTIL_VMAJOR == 2 && DDCUTIL_VMINOR == 0 && DDCUTIL_VMICRO < 2
@@ -79,6 +84,28 @@
     #define LIBDDCUTIL_HAS_DDCA_GET_DEFAULT_SLEEP_MULTIPLIER
 #endif
 
+/**
+ * USDT static tracepoints for perf, bpftrace and SystemTap, compiled in when sys/sdt.h is available.
+ * Every probe has the same arguments: a label (method, operation, or client name), display number
+ * (I2C bus number for DDC operations), VCP-code, status, and duration in microseconds, for example:
+ *
+ *     bpftrace -e 'usdt:/usr/bin/ddcutil-service:ddcutil_service:ddc__get_vcp { @[arg1] = hist(arg4); }'
+ */
+#if defined(__has_include)
+    #if __has_include(<sys/sdt.h>)
+        #include <sys/sdt.h>
+        #define HAVE_SYS_SDT_H
+    #endif
+#endif
+
+#if defined(HAVE_SYS_SDT_H)
+    #define USDT_PROBE(name, label, display, vcp_code, status, duration_micros) \
+        DTRACE_PROBE5(ddcutil_service, name, label, display, vcp_code, status, duration_micros)
+#else
+    #define USDT_PROBE(name, label, display, vcp_code, status, duration_micros) \
+        do { (void) (label); (void) (display); (void) (vcp_code); (void) (status); (void) (duration_micros); } while (0)
+#endif
+
 #define BOOL_STR(value) ((value) ? "true" : "false")
 #define MACRO_EXISTS(name) (#name [0] != G_STRINGIFY(name) [0])
 
@@ -136,19 +163,28 @@ static gboolean service_info_logging = FALSE;
  */
 typedef enum {
     EDID_PREFIX = 1,        // Indicates the EDID passed to the service is a unique prefix (substr) of the actual EDID.
-    RETURN_RAW_VALUES = 2,  // GetVcp GetMultipleVcp
-    NO_VERIFY = 4,          // SetVcp
+    RETURN_RAW_VALUES = 2,  // GetVcp GetMultipleVcp GetVcpConditional GetMultipleVcpConditional AdjustVcp
+    NO_VERIFY = 4,          // SetVcp AdjustVcp SetMultipleVcp ApplyPreset RampVcp
     DETECT_ALL = 8,         // Detect all VDUs, including those that are not powered up.
+    PRIORITY = 16,          // Serve before non-priority calls, for interactive use.
 } Flags_Enum_Type;
 
+/**
+ * The upper 16 bits of the flags argument may carry a deadline for scheduled methods, in milliseconds
+ * from the service's receipt of the call (zero for none).  A call still queued at its deadline is discarded.
+ */
+#define FLAGS_DEADLINE_SHIFT 16
+#define FLAGS_DEADLINE_MILLIS(flags) ((flags) >> FLAGS_DEADLINE_SHIFT)
+
 /**
  * Iterable definitions of Flags_Enum_Type values/names (for return from a service property).
  */
-static const int flag_options[] = {EDID_PREFIX,RETURN_RAW_VALUES, NO_VERIFY, DETECT_ALL, };
+static const int flag_options[] = {EDID_PREFIX,RETURN_RAW_VALUES, NO_VERIFY, DETECT_ALL, PRIORITY, };
 static const char* flag_options_names[] = {G_STRINGIFY(EDID_PREFIX),
                                     G_STRINGIFY(RETURN_RAW_VALUES),
                                     G_STRINGIFY(NO_VERIFY),
-                                    G_STRINGIFY(DETECT_ALL),};
+                                    G_STRINGIFY(DETECT_ALL),
+                                    G_STRINGIFY(PRIORITY),};
 
 G_STATIC_ASSERT(G_N_ELEMENTS(flag_options) == G_N_ELEMENTS(flag_options_names));  // Boilerplate
 
@@ -275,6 +311,10 @@ typedef enum {
     DDCUTIL_SERVICE_INVALID_POLL_CASCADE_SECONDS,
     DDCUTIL_SERVICE_I2C_DEV_NO_MODULE,
     DDCUTIL_SERVICE_I2C_DEV_NO_PERMISSIONS,
+    DDCUTIL_SERVICE_INVALID_VCP_CACHE_MAX_AGE,
+    DDCUTIL_SERVICE_PRESET_SAVE_FAILED,
+    DDCUTIL_SERVICE_QUEUE_FULL,
+    DDCUTIL_SERVICE_DISCARDED,
     DDCUTIL_SERVICE_OK, // Non error
     DDCUTIL_SERVICE_N_ERRORS  // Dummy placeholder for counting the number of entries
 } DdcutilServiceStatus;
@@ -287,6 +327,10 @@ static const GDBusErrorEntry ddcutil_service_error_entries[] = {
         { DDCUTIL_SERVICE_INVALID_POLL_CASCADE_SECONDS, "com.ddcutil.DdcutilService.Error.InvalidPollCascadeSeconds" },
         { DDCUTIL_SERVICE_I2C_DEV_NO_MODULE, "com.ddcutil.DdcutilService.Error.I2cDevNoModule" },
         { DDCUTIL_SERVICE_I2C_DEV_NO_PERMISSIONS, "com.ddcutil.DdcutilService.Error.I2cDevNoPermissions" },
+        { DDCUTIL_SERVICE_INVALID_VCP_CACHE_MAX_AGE, "com.ddcutil.DdcutilService.Error.InvalidVcpCacheMaxAge" },
+        { DDCUTIL_SERVICE_PRESET_SAVE_FAILED, "com.ddcutil.DdcutilService.Error.PresetSaveFailed" },
+        { DDCUTIL_SERVICE_QUEUE_FULL, "com.ddcutil.DdcutilService.Error.QueueFull" },
+        { DDCUTIL_SERVICE_DISCARDED, "com.ddcutil.DdcutilService.Error.Discarded" },
         { DDCUTIL_SERVICE_OK, "com.ddcutil.DdcutilService.Error.OK" },
 };
 
@@ -399,6 +443,844 @@ static char* get_status_message(const DDCA_Status status) {
     return message_text;
 }
 
+/* ----------------------------------------------------------------------------------------------------
+ * Display backend
+ *
+ * All display detection and DDC I/O goes through a table of functions with the same signatures as the
+ * libddcutil functions they stand in for.  Normally the table is libddcutil itself, with --simulate=FILE
+ * it is the display simulator below.
+ */
+
+typedef struct {
+    DDCA_Status (*get_display_info_list2)(bool include_invalid_displays, DDCA_Display_Info_List** dlist_loc);
+    void (*free_display_info_list)(DDCA_Display_Info_List* dlist);
+    DDCA_Status (*redetect_displays)(void);
+    DDCA_Status (*get_display_info)(DDCA_Display_Ref ddca_dref, DDCA_Display_Info** dinfo_loc);
+    void (*free_display_info)(DDCA_Display_Info* info_rec);
+    DDCA_Status (*validate_display_ref)(DDCA_Display_Ref dref, bool require_not_asleep);
+    DDCA_Status (*open_display2)(DDCA_Display_Ref ddca_dref, bool wait, DDCA_Display_Handle* ddca_dh_loc);
+    DDCA_Status (*close_display)(DDCA_Display_Handle ddca_dh);
+    DDCA_Display_Ref (*display_ref_from_handle)(DDCA_Display_Handle ddca_dh);
+    DDCA_Status (*get_non_table_vcp_value)(DDCA_Display_Handle ddca_dh, DDCA_Vcp_Feature_Code feature_code,
+                                           DDCA_Non_Table_Vcp_Value* valrec);
+    DDCA_Status (*set_non_table_vcp_value)(DDCA_Display_Handle ddca_dh, DDCA_Vcp_Feature_Code feature_code,
+                                           uint8_t hi_byte, uint8_t lo_byte);
+    DDCA_Status (*get_capabilities_string)(DDCA_Display_Handle ddca_dh, char** caps_loc);
+    DDCA_Status (*get_feature_metadata_by_dh)(DDCA_Vcp_Feature_Code feature_code, DDCA_Display_Handle ddca_dh,
+                                              bool create_default_if_not_found, DDCA_Feature_Metadata** meta_loc);
+    DDCA_Status (*get_feature_metadata_by_dref)(DDCA_Vcp_Feature_Code feature_code, DDCA_Display_Ref ddca_dref,
+                                                bool create_default_if_not_found, DDCA_Feature_Metadata** meta_loc);
+    DDCA_Status (*format_non_table_vcp_value_by_dref)(DDCA_Vcp_Feature_Code feature_code, DDCA_Display_Ref ddca_dref,
+                                                      DDCA_Non_Table_Vcp_Value* valrec, char** formatted_value_loc);
+#if defined(LIBDDCUTIL_HAS_INDIVIDUAL_SLEEP_MULTIPLIER)
+    DDCA_Status (*get_current_display_sleep_multiplier)(DDCA_Display_Ref ddca_dref, double* multiplier_loc);
+    DDCA_Status (*set_display_sleep_multiplier)(DDCA_Display_Ref ddca_dref, double multiplier);
+#endif
+} Display_Backend;
+
+static const Display_Backend libddcutil_backend = {
+    .get_display_info_list2 = ddca_get_display_info_list2,
+    .free_display_info_list = ddca_free_display_info_list,
+    .redetect_displays = ddca_redetect_displays,
+    .get_display_info = ddca_get_display_info,
+    .free_display_info = ddca_free_display_info,
+    .validate_display_ref = ddca_validate_display_ref,
+    .open_display2 = ddca_open_display2,
+    .close_display = ddca_close_display,
+    .display_ref_from_handle = ddca_display_ref_from_handle,
+    .get_non_table_vcp_value = ddca_get_non_table_vcp_value,
+    .set_non_table_vcp_value = ddca_set_non_table_vcp_value,
+    .get_capabilities_string = ddca_get_capabilities_string,
+    .get_feature_metadata_by_dh = ddca_get_feature_metadata_by_dh,
+    .get_feature_metadata_by_dref = ddca_get_feature_metadata_by_dref,
+    .format_non_table_vcp_value_by_dref = ddca_format_non_table_vcp_value_by_dref,
+#if defined(LIBDDCUTIL_HAS_INDIVIDUAL_SLEEP_MULTIPLIER)
+    .get_current_display_sleep_multiplier = ddca_get_current_display_sleep_multiplier,
+    .set_display_sleep_multiplier = ddca_set_display_sleep_multiplier,
+#endif
+};
+
+static const Display_Backend* backend = &libddcutil_backend;
+
+/* ----------------------------------------------------------------------------------------------------
+ * Display simulator
+ *
+ * Simulates displays described by a GKeyFile, so that the service can be run, load-tested and
+ * used to reproduce field issues without any real monitors.  Each group other than [simulator]
+ * describes one display, all keys are optional:
+ *
+ *     bus                      I2C bus number, defaults to the display's position in the file
+ *     mfg-id, model, serial,   used to build an EDID
+ *     product-code
+ *     edid                     256 hex digits, overrides the four keys above
+ *     mccs-version             default 2.1
+ *     capabilities             default made up from the vcp- keys
+ *     vcp-XX                   VALUE[/MAXIMUM] of each supported VCP code, in decimal,
+ *                              a display with vcp-D6 supports DPMS
+ *     connected                default true
+ *     asleep-responds          whether codes other than D6 can be read in DPMS sleep, default false
+ *     latency-open, -read,     MEAN[,JITTER] milliseconds, scaled by the sleep multiplier
+ *     -write, -caps
+ *     fault-timeout            probability of an operation exhausting its retries
+ *     fault-nak                probability of the display NAKing an operation
+ *     fault-garbage-high-byte  probability of a garbage high byte in a Simple NC value
+ *
+ * The [simulator] group has:
+ *
+ *     latency-detect           MEAN[,JITTER] milliseconds
+ *     script                   SECONDS connect|disconnect|sleep|wake GROUP;...
+ *     script-repeat            seconds after which to restart the script, default 0, run once
+ *
+ * The script's times are seconds since the service started.  Like real displays, connection changes
+ * only show in the display list after the next redetect, which the service's internal polling does.
+ * See examples/simulated-displays.ini.
+ */
+
+#define SIMULATOR_GROUP "simulator"
+#define SIM_MAX_TRIES 4
+
+typedef enum {
+    SIM_OPEN, SIM_READ, SIM_WRITE, SIM_CAPS, SIM_OP_COUNT
+} Sim_Operation;
+
+static const char* sim_latency_keys[SIM_OP_COUNT] = {
+    "latency-open", "latency-read", "latency-write", "latency-caps",
+};
+
+typedef struct {
+    double mean_millis;
+    double jitter_millis;
+} Sim_Latency;
+
+typedef struct {
+    gchar* name;                       // Key file group
+    DDCA_Display_Info info;            // dispno is assigned on detection, dref points to this struct
+    gchar* capabilities;
+    gboolean supported[256];
+    guint16 values[256];
+    guint16 maximums[256];
+    Sim_Latency latency[SIM_OP_COUNT];
+    double fault_timeout;
+    double fault_nak;
+    double fault_garbage_high_byte;
+    gboolean asleep_responds;
+    double sleep_multiplier;
+    gboolean connected;
+    gboolean detected;                 // Connected as of the last redetect
+    gboolean asleep;
+    gboolean open;
+} Sim_Display;
+
+typedef struct {
+    double at_seconds;
+    gchar* action;                     // connect, disconnect, sleep, or wake
+    Sim_Display* display;
+} Sim_Script_Event;
+
+static gchar* simulate_path = NULL;    // Set by command line argument
+static GPtrArray* sim_displays = NULL;
+static Sim_Latency sim_detect_latency;
+static GArray* sim_script = NULL;      // Sim_Script_Event, in time order
+static double sim_script_repeat_seconds = 0.0;
+static guint sim_script_next = 0;
+static long sim_script_start_micros = 0;
+static GMutex sim_mutex;               // Protects the mutable state of the displays
+static GCond sim_display_closed;
+
+/**
+ * @brief Sleep for a simulated operation's latency.
+ * @param latency the latency distribution
+ * @param multiplier the display's sleep multiplier
+ */
+static void sim_sleep(const Sim_Latency* latency, const double multiplier) {
+    const double millis = latency->mean_millis + (g_random_double() * 2.0 - 1.0) * latency->jitter_millis;
+    if (millis > 0.0) {
+        g_usleep((gulong) (millis * multiplier * 1000.0));
+    }
+}
+
+/**
+ * @brief Simulate the I2C transaction of an operation, including latency and injected faults.
+ * @param display the display
+ * @param operation the kind of operation
+ * @param feature_code the VCP code, for deciding whether a sleeping display responds
+ * @return DDCRC_OK, or the status of the simulated failure
+ */
+static DDCA_Status sim_transaction(Sim_Display* display, const Sim_Operation operation,
+                                   const DDCA_Vcp_Feature_Code feature_code) {
+    g_mutex_lock(&sim_mutex);
+    const gboolean connected = display->connected;
+    const gboolean unresponsive = display->asleep && !display->asleep_responds
+                                  && operation != SIM_OPEN && feature_code != 0xd6;
+    const double multiplier = display->sleep_multiplier;
+    g_mutex_unlock(&sim_mutex);
+    if (!connected) {
+        return DDCRC_DISCONNECTED;
+    }
+    if (unresponsive || g_random_double() < display->fault_timeout) {
+        for (int i = 0; i < SIM_MAX_TRIES; i++) {
+            sim_sleep(&display->latency[operation], multiplier);
+        }
+        return DDCRC_RETRIES;
+    }
+    sim_sleep(&display->latency[operation], multiplier);
+    if (g_random_double() < display->fault_nak) {
+        return -EIO;
+    }
+    return DDCRC_OK;
+}
+
+static DDCA_Status sim_get_display_info_list2(bool include_invalid_displays, DDCA_Display_Info_List** dlist_loc) {
+    g_mutex_lock(&sim_mutex);
+    int count = 0;
+    for (guint i = 0; i < sim_displays->len; i++) {
+        count += ((Sim_Display*) g_ptr_array_index(sim_displays, i))->detected ? 1 : 0;
+    }
+    DDCA_Display_Info_List* dlist = g_malloc0(sizeof(DDCA_Display_Info_List) + count * sizeof(DDCA_Display_Info));
+    for (guint i = 0; i < sim_displays->len; i++) {
+        const Sim_Display* display = g_ptr_array_index(sim_displays, i);
+        if (display->detected) {
+            dlist->info[dlist->ct++] = display->info;
+        }
+    }
+    g_mutex_unlock(&sim_mutex);
+    *dlist_loc = dlist;
+    return DDCRC_OK;
+}
+
+static void sim_free_display_info_list(DDCA_Display_Info_List* dlist) {
+    g_free(dlist);
+}
+
+static DDCA_Status sim_redetect_displays(void) {
+    sim_sleep(&sim_detect_latency, 1.0);
+    g_mutex_lock(&sim_mutex);
+    int dispno = 1;
+    for (guint i = 0; i < sim_displays->len; i++) {
+        Sim_Display* display = g_ptr_array_index(sim_displays, i);
+        display->detected = display->connected;
+        display->info.dispno = display->detected ? dispno++ : -1;
+    }
+    g_mutex_unlock(&sim_mutex);
+    return DDCRC_OK;
+}
+
+static DDCA_Status sim_get_display_info(DDCA_Display_Ref ddca_dref, DDCA_Display_Info** dinfo_loc) {
+    const Sim_Display* display = ddca_dref;
+    DDCA_Display_Info* info = g_new(DDCA_Display_Info, 1);
+    g_mutex_lock(&sim_mutex);
+    *info = display->info;
+    g_mutex_unlock(&sim_mutex);
+    *dinfo_loc = info;
+    return DDCRC_OK;
+}
+
+static void sim_free_display_info(DDCA_Display_Info* info_rec) {
+    g_free(info_rec);
+}
+
+static DDCA_Status sim_validate_display_ref(DDCA_Display_Ref dref, bool require_not_asleep) {
+    const Sim_Display* display = dref;
+    g_mutex_lock(&sim_mutex);
+    const DDCA_Status status = !display->connected ? DDCRC_DISCONNECTED
+                             : require_not_asleep && display->asleep ? DDCRC_DPMS_ASLEEP
+                             : DDCRC_OK;
+    g_mutex_unlock(&sim_mutex);
+    return status;
+}
+
+static DDCA_Status sim_open_display2(DDCA_Display_Ref ddca_dref, bool wait, DDCA_Display_Handle* ddca_dh_loc) {
+    Sim_Display* display = ddca_dref;
+    *ddca_dh_loc = NULL;
+    g_mutex_lock(&sim_mutex);
+    if (!display->detected) {
+        g_mutex_unlock(&sim_mutex);
+        return DDCRC_INVALID_DISPLAY;
+    }
+    while (display->open && wait) {  // libddcutil only allows one open handle per display
+        g_cond_wait(&sim_display_closed, &sim_mutex);
+    }
+    if (display->open) {
+        g_mutex_unlock(&sim_mutex);
+        return DDCRC_INVALID_OPERATION;
+    }
+    display->open = TRUE;
+    g_mutex_unlock(&sim_mutex);
+    const DDCA_Status status = sim_transaction(display, SIM_OPEN, 0);
+    if (status != DDCRC_OK) {
+        g_mutex_lock(&sim_mutex);
+        display->open = FALSE;
+        g_cond_broadcast(&sim_display_closed);
+        g_mutex_unlock(&sim_mutex);
+        return status;
+    }
+    *ddca_dh_loc = display;  // The handle is the display, it can only be open once
+    return DDCRC_OK;
+}
+
+static DDCA_Status sim_close_display(DDCA_Display_Handle ddca_dh) {
+    Sim_Display* display = ddca_dh;
+    if (display == NULL) {
+        return DDCRC_ARG;
+    }
+    g_mutex_lock(&sim_mutex);
+    display->open = FALSE;
+    g_cond_broadcast(&sim_display_closed);
+    g_mutex_unlock(&sim_mutex);
+    return DDCRC_OK;
+}
+
+static DDCA_Display_Ref sim_display_ref_from_handle(DDCA_Display_Handle ddca_dh) {
+    return ddca_dh;
+}
+
+static DDCA_Status sim_get_non_table_vcp_value(DDCA_Display_Handle ddca_dh, DDCA_Vcp_Feature_Code feature_code,
+                                               DDCA_Non_Table_Vcp_Value* valrec) {
+    Sim_Display* display = ddca_dh;
+    DDCA_Status status = sim_transaction(display, SIM_READ, feature_code);
+    if (status == DDCRC_OK) {
+        g_mutex_lock(&sim_mutex);
+        if (display->supported[feature_code]) {
+            const guint16 value = feature_code == 0xd6 && display->asleep ? 4 : display->values[feature_code];
+            valrec->mh = display->maximums[feature_code] >> 8;
+            valrec->ml = display->maximums[feature_code] & 0xff;
+            valrec->sh = value >> 8;
+            valrec->sl = value & 0xff;
+        }
+        else {
+            status = DDCRC_REPORTED_UNSUPPORTED;
+        }
+        g_mutex_unlock(&sim_mutex);
+    }
+    if (status == DDCRC_OK && g_random_double() < display->fault_garbage_high_byte) {
+        DDCA_Feature_Metadata* metadata = NULL;
+        if (ddca_get_feature_metadata_by_vspec(feature_code, display->info.vcp_version, FALSE, &metadata) == DDCRC_OK) {
+            if (metadata->feature_flags & DDCA_SIMPLE_NC) {
+                valrec->sh = (uint8_t) g_random_int_range(1, 256);
+            }
+            ddca_free_feature_metadata(metadata);
+        }
+    }
+    return status;
+}
+
+static DDCA_Status sim_set_non_table_vcp_value(DDCA_Display_Handle ddca_dh, DDCA_Vcp_Feature_Code feature_code,
+                                               uint8_t hi_byte, uint8_t lo_byte) {
+    Sim_Display* display = ddca_dh;
+    DDCA_Status status = sim_transaction(display, SIM_WRITE, feature_code);
+    if (status == DDCRC_OK) {
+        g_mutex_lock(&sim_mutex);
+        if (display->supported[feature_code]) {
+            const guint16 value = hi_byte << 8 | lo_byte;
+            if (feature_code == 0xd6) {
+                display->asleep = value > 1;
+            }
+            // Like most displays, clamp continuous values to the maximum
+            display->values[feature_code] = display->maximums[feature_code] > 0
+                                                ? MIN(value, display->maximums[feature_code]) : value;
+        }
+        else {
+            status = DDCRC_REPORTED_UNSUPPORTED;
+        }
+        g_mutex_unlock(&sim_mutex);
+    }
+    return status;
+}
+
+static DDCA_Status sim_get_capabilities_string(DDCA_Display_Handle ddca_dh, char** caps_loc) {
+    Sim_Display* display = ddca_dh;
+    *caps_loc = NULL;
+    const DDCA_Status status = sim_transaction(display, SIM_CAPS, 0);
+    if (status == DDCRC_OK) {
+        *caps_loc = strdup(display->capabilities);
+    }
+    return status;
+}
+
+static DDCA_Status sim_get_feature_metadata_by_dref(DDCA_Vcp_Feature_Code feature_code, DDCA_Display_Ref ddca_dref,
+                                                    bool create_default_if_not_found, DDCA_Feature_Metadata** meta_loc) {
+    const Sim_Display* display = ddca_dref;
+    return ddca_get_feature_metadata_by_vspec(feature_code, display->info.vcp_version, create_default_if_not_found,
+                                              meta_loc);
+}
+
+static DDCA_Status sim_get_feature_metadata_by_dh(DDCA_Vcp_Feature_Code feature_code, DDCA_Display_Handle ddca_dh,
+                                                  bool create_default_if_not_found, DDCA_Feature_Metadata** meta_loc) {
+    return sim_get_feature_metadata_by_dref(feature_code, ddca_dh, create_default_if_not_found, meta_loc);
+}
+
+static DDCA_Status sim_format_non_table_vcp_value_by_dref(DDCA_Vcp_Feature_Code feature_code, DDCA_Display_Ref ddca_dref,
+                                                          DDCA_Non_Table_Vcp_Value* valrec, char** formatted_value_loc) {
+    DDCA_Feature_Metadata* metadata = NULL;
+    const DDCA_Status status = sim_get_feature_metadata_by_dref(feature_code, ddca_dref, TRUE, &metadata);
+    if (status != DDCRC_OK) {
+        return status;
+    }
+    gchar* text = NULL;
+    if (metadata->feature_flags & DDCA_SIMPLE_NC) {
+        const char* value_name = "Unrecognized value";
+        for (const DDCA_Feature_Value_Entry* entry = metadata->sl_values;
+             entry != NULL && entry->value_name != NULL; entry++) {
+            if (entry->value_code == valrec->sl) {
+                value_name = entry->value_name;
+                break;
+            }
+        }
+        text = g_strdup_printf("%s (sl=0x%02x)", value_name, valrec->sl);
+    }
+    else if (metadata->feature_flags & DDCA_CONT) {
+        text = g_strdup_printf("current value = %5d, max value = %5d",
+                               valrec->sh << 8 | valrec->sl, valrec->mh << 8 | valrec->ml);
+    }
+    else {
+        text = g_strdup_printf("mh=0x%02x, ml=0x%02x, sh=0x%02x, sl=0x%02x",
+                               valrec->mh, valrec->ml, valrec->sh, valrec->sl);
+    }
+    ddca_free_feature_metadata(metadata);
+    *formatted_value_loc = strdup(text);  // Caller frees with free()
+    g_free(text);
+    return DDCRC_OK;
+}
+
+#if defined(LIBDDCUTIL_HAS_INDIVIDUAL_SLEEP_MULTIPLIER)
+static DDCA_Status sim_get_current_display_sleep_multiplier(DDCA_Display_Ref ddca_dref, double* multiplier_loc) {
+    const Sim_Display* display = ddca_dref;
+    g_mutex_lock(&sim_mutex);
+    *multiplier_loc = display->sleep_multiplier;
+    g_mutex_unlock(&sim_mutex);
+    return DDCRC_OK;
+}
+
+static DDCA_Status sim_set_display_sleep_multiplier(DDCA_Display_Ref ddca_dref, double multiplier) {
+    Sim_Display* display = ddca_dref;
+    if (multiplier < 0.0 || multiplier > 10.0) {
+        return DDCRC_ARG;
+    }
+    g_mutex_lock(&sim_mutex);
+    display->sleep_multiplier = multiplier;
+    g_mutex_unlock(&sim_mutex);
+    return DDCRC_OK;
+}
+#endif
+
+static const Display_Backend simulator_backend = {
+    .get_display_info_list2 = sim_get_display_info_list2,
+    .free_display_info_list = sim_free_display_info_list,
+    .redetect_displays = sim_redetect_displays,
+    .get_display_info = sim_get_display_info,
+    .free_display_info = sim_free_display_info,
+    .validate_display_ref = sim_validate_display_ref,
+    .open_display2 = sim_open_display2,
+    .close_display = sim_close_display,
+    .display_ref_from_handle = sim_display_ref_from_handle,
+    .get_non_table_vcp_value = sim_get_non_table_vcp_value,
+    .set_non_table_vcp_value = sim_set_non_table_vcp_value,
+    .get_capabilities_string = sim_get_capabilities_string,
+    .get_feature_metadata_by_dh = sim_get_feature_metadata_by_dh,
+    .get_feature_metadata_by_dref = sim_get_feature_metadata_by_dref,
+    .format_non_table_vcp_value_by_dref = sim_format_non_table_vcp_value_by_dref,
+#if defined(LIBDDCUTIL_HAS_INDIVIDUAL_SLEEP_MULTIPLIER)
+    .get_current_display_sleep_multiplier = sim_get_current_display_sleep_multiplier,
+    .set_display_sleep_multiplier = sim_set_display_sleep_multiplier,
+#endif
+};
+
+/**
+ * @brief Fill in an EDID text descriptor, a tag followed by up to 13 characters.
+ */
+static void sim_edid_set_descriptor(uint8_t* descriptor, const uint8_t tag, const char* text) {
+    memset(descriptor, 0, 18);
+    descriptor[3] = tag;
+    memset(descriptor + 5, ' ', 13);
+    const size_t len = MIN(strlen(text), 13);
+    memcpy(descriptor + 5, text, len);
+    if (len < 13) {
+        descriptor[5 + len] = '\n';
+    }
+}
+
+/**
+ * @brief Get the text of an EDID text descriptor.
+ */
+static void sim_edid_get_descriptor(const uint8_t* edid, const uint8_t tag, char* text, const size_t text_size) {
+    for (int offset = 54; offset < 126; offset += 18) {
+        const uint8_t* descriptor = edid + offset;
+        if (descriptor[0] == 0 && descriptor[1] == 0 && descriptor[3] == tag) {
+            const size_t len = MIN(text_size - 1, 13);  // Not NUL terminated
+            memcpy(text, descriptor + 5, len);
+            text[len] = '\0';
+            text[strcspn(text, "\n")] = '\0';
+            g_strchomp(text);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Build an EDID for a simulated display, or parse the one given, and fill in the display info.
+ * @param key_file the simulator key file
+ * @param display the display
+ * @param error_loc for returning an error
+ * @return TRUE if successful
+ */
+static gboolean sim_load_edid(GKeyFile* key_file, Sim_Display* display, GError** error_loc) {
+    DDCA_Display_Info* info = &display->info;
+    uint8_t* edid = info->edid_bytes;
+    gchar* edid_hex = g_key_file_get_string(key_file, display->name, "edid", NULL);
+    if (edid_hex != NULL) {
+        g_strstrip(edid_hex);
+        gboolean ok = strlen(edid_hex) == 256;
+        for (int i = 0; ok && i < 128; i++) {
+            const int hi = g_ascii_xdigit_value(edid_hex[i * 2]);
+            const int lo = g_ascii_xdigit_value(edid_hex[i * 2 + 1]);
+            ok = hi >= 0 && lo >= 0;
+            edid[i] = (uint8_t) (hi << 4 | lo);
+        }
+        g_free(edid_hex);
+        if (!ok) {
+            g_set_error(error_loc, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+                        "[%s] edid must be 256 hex digits", display->name);
+            return FALSE;
+        }
+    }
+    else {
+        gchar* mfg_id = g_key_file_get_string(key_file, display->name, "mfg-id", NULL);
+        gchar* model = g_key_file_get_string(key_file, display->name, "model", NULL);
+        gchar* serial = g_key_file_get_string(key_file, display->name, "serial", NULL);
+        const char* mfg = mfg_id != NULL && strlen(mfg_id) == 3 ? mfg_id : "SIM";
+        const guint product_code = g_key_file_has_key(key_file, display->name, "product-code", NULL)
+                                       ? g_key_file_get_integer(key_file, display->name, "product-code", NULL)
+                                       : display->info.path.path.i2c_busno;
+        const char* serial_text = serial != NULL ? serial : display->name;
+        const guint32 binary_serial = g_str_hash(serial_text);
+        static const uint8_t header[] = {0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+        memcpy(edid, header, sizeof(header));
+        const guint16 mfg_packed = (guint16) ((mfg[0] - 'A' + 1) << 10 | (mfg[1] - 'A' + 1) << 5 | (mfg[2] - 'A' + 1));
+        edid[8] = mfg_packed >> 8;
+        edid[9] = mfg_packed & 0xff;
+        edid[10] = product_code & 0xff;
+        edid[11] = (product_code >> 8) & 0xff;
+        for (int i = 0; i < 4; i++) {
+            edid[12 + i] = (binary_serial >> (8 * i)) & 0xff;
+        }
+        edid[16] = 1;   // Week
+        edid[17] = 34;  // 2024
+        edid[18] = 1;   // EDID 1.3
+        edid[19] = 3;
+        sim_edid_set_descriptor(edid + 54, 0xff, serial_text);
+        sim_edid_set_descriptor(edid + 72, 0xfc, model != NULL ? model : display->name);
+        sim_edid_set_descriptor(edid + 90, 0x10, "");
+        sim_edid_set_descriptor(edid + 108, 0x10, "");
+        uint8_t checksum = 0;
+        for (int i = 0; i < 127; i++) {
+            checksum += edid[i];
+        }
+        edid[127] = (uint8_t) (256 - checksum);
+        g_free(mfg_id);
+        g_free(model);
+        g_free(serial);
+    }
+    const guint16 mfg_packed = edid[8] << 8 | edid[9];
+    info->mfg_id[0] = (char) ('A' - 1 + ((mfg_packed >> 10) & 0x1f));
+    info->mfg_id[1] = (char) ('A' - 1 + ((mfg_packed >> 5) & 0x1f));
+    info->mfg_id[2] = (char) ('A' - 1 + (mfg_packed & 0x1f));
+    info->mfg_id[3] = '\0';
+    info->product_code = edid[10] | edid[11] << 8;
+    sim_edid_get_descriptor(edid, 0xfc, info->model_name, sizeof(info->model_name));
+    sim_edid_get_descriptor(edid, 0xff, info->sn, sizeof(info->sn));
+    return TRUE;
+}
+
+/**
+ * @brief Parse a MEAN[,JITTER] latency in milliseconds.
+ */
+static void sim_load_latency(GKeyFile* key_file, const char* group, const char* key, Sim_Latency* latency) {
+    gsize length = 0;
+    gdouble* values = g_key_file_get_double_list(key_file, group, key, &length, NULL);
+    if (values != NULL) {
+        latency->mean_millis = MAX(values[0], 0.0);
+        latency->jitter_millis = length > 1 ? MIN(MAX(values[1], 0.0), latency->mean_millis) : 0.0;
+        g_free(values);
+    }
+}
+
+static double sim_load_double(GKeyFile* key_file, const char* group, const char* key, const double default_value) {
+    GError* error = NULL;
+    const double value = g_key_file_get_double(key_file, group, key, &error);
+    if (error != NULL) {
+        g_error_free(error);
+        return default_value;
+    }
+    return value;
+}
+
+static gboolean sim_load_boolean(GKeyFile* key_file, const char* group, const char* key, const gboolean default_value) {
+    GError* error = NULL;
+    const gboolean value = g_key_file_get_boolean(key_file, group, key, &error);
+    if (error != NULL) {
+        g_error_free(error);
+        return default_value;
+    }
+    return value;
+}
+
+/**
+ * @brief Load one simulated display from its key file group.
+ * @return the display, or NULL with error_loc set
+ */
+static Sim_Display* sim_load_display(GKeyFile* key_file, const char* group, const int index, GError** error_loc) {
+    Sim_Display* display = g_new0(Sim_Display, 1);
+    display->name = g_strdup(group);
+    DDCA_Display_Info* info = &display->info;
+    memcpy(info->marker, "DDIN", 4);
+    info->path.io_mode = DDCA_IO_I2C;
+    info->path.path.i2c_busno = g_key_file_has_key(key_file, group, "bus", NULL)
+                                    ? g_key_file_get_integer(key_file, group, "bus", NULL) : index + 1;
+    info->dref = display;
+    const double mccs_version = sim_load_double(key_file, group, "mccs-version", 2.1);
+    info->vcp_version.major = (uint8_t) mccs_version;
+    info->vcp_version.minor = (uint8_t) ((mccs_version - info->vcp_version.major) * 10.0 + 0.5);
+    if (!sim_load_edid(key_file, display, error_loc)) {
+        g_free(display->name);
+        g_free(display);
+        return NULL;
+    }
+    gchar** keys = g_key_file_get_keys(key_file, group, NULL, NULL);
+    for (int i = 0; keys != NULL && keys[i] != NULL; i++) {
+        if (g_str_has_prefix(keys[i], "vcp-")) {
+            gchar* end = NULL;
+            const guint64 code = g_ascii_strtoull(keys[i] + 4, &end, 16);
+            if (end == keys[i] + 4 || *end != '\0' || code > 0xff) {
+                g_warning("Simulator: [%s] ignoring %s, not a hex VCP-code", group, keys[i]);
+                continue;
+            }
+            gchar* value_text = g_key_file_get_string(key_file, group, keys[i], NULL);
+            gchar* max_text = strchr(value_text, '/');
+            display->supported[code] = TRUE;
+            display->values[code] = (guint16) g_ascii_strtoull(value_text, NULL, 10);
+            display->maximums[code] = max_text != NULL ? (guint16) g_ascii_strtoull(max_text + 1, NULL, 10) : 0;
+            g_free(value_text);
+        }
+    }
+    g_strfreev(keys);
+    display->capabilities = g_key_file_get_string(key_file, group, "capabilities", NULL);
+    if (display->capabilities == NULL) {  // Make one up from the supported codes
+        GString* caps = g_string_new("(prot(monitor)type(lcd)cmds(01 02 03 0C E3 F3)vcp(");
+        for (int code = 0; code < 256; code++) {
+            if (display->supported[code]) {
+                g_string_append_printf(caps, "%s%02X", caps->str[caps->len - 1] == '(' ? "" : " ", code);
+            }
+        }
+        g_string_append_printf(caps, ")mccs_ver(%d.%d))", info->vcp_version.major, info->vcp_version.minor);
+        display->capabilities = g_string_free(caps, FALSE);
+    }
+    for (int op = 0; op < SIM_OP_COUNT; op++) {
+        sim_load_latency(key_file, group, sim_latency_keys[op], &display->latency[op]);
+    }
+    display->fault_timeout = sim_load_double(key_file, group, "fault-timeout", 0.0);
+    display->fault_nak = sim_load_double(key_file, group, "fault-nak", 0.0);
+    display->fault_garbage_high_byte = sim_load_double(key_file, group, "fault-garbage-high-byte", 0.0);
+    display->asleep_responds = sim_load_boolean(key_file, group, "asleep-responds", FALSE);
+    display->connected = sim_load_boolean(key_file, group, "connected", TRUE);
+    display->asleep = display->supported[0xd6] && display->values[0xd6] > 1;
+    display->sleep_multiplier = 1.0;
+    return display;
+}
+
+/**
+ * @brief Load the script of hotplug and DPMS events.
+ */
+static gboolean sim_load_script(GKeyFile* key_file, GError** error_loc) {
+    sim_script = g_array_new(FALSE, TRUE, sizeof(Sim_Script_Event));
+    gchar** steps = g_key_file_get_string_list(key_file, SIMULATOR_GROUP, "script", NULL, NULL);
+    for (int i = 0; steps != NULL && steps[i] != NULL; i++) {
+        gchar** words = g_strsplit(g_strstrip(steps[i]), " ", 3);
+        Sim_Script_Event event = {0};
+        if (g_strv_length(words) == 3) {
+            event.at_seconds = g_ascii_strtod(words[0], NULL);
+            event.action = g_strdup(words[1]);
+            for (guint d = 0; d < sim_displays->len; d++) {
+                Sim_Display* display = g_ptr_array_index(sim_displays, d);
+                if (g_strcmp0(display->name, words[2]) == 0) {
+                    event.display = display;
+                }
+            }
+        }
+        const gboolean valid = event.display != NULL && g_strv_contains(
+            (const gchar* const[]) {"connect", "disconnect", "sleep", "wake", NULL}, event.action);
+        g_strfreev(words);
+        if (!valid) {
+            g_set_error(error_loc, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+                        "[%s] script step '%s' is not 'SECONDS connect|disconnect|sleep|wake DISPLAY-GROUP'",
+                        SIMULATOR_GROUP, steps[i]);
+            g_free(event.action);
+            g_strfreev(steps);
+            return FALSE;
+        }
+        guint pos = 0;  // Keep in time order
+        while (pos < sim_script->len && g_array_index(sim_script, Sim_Script_Event, pos).at_seconds <= event.at_seconds) {
+            pos++;
+        }
+        g_array_insert_val(sim_script, pos, event);
+    }
+    g_strfreev(steps);
+    sim_script_repeat_seconds = sim_load_double(key_file, SIMULATOR_GROUP, "script-repeat", 0.0);
+    return TRUE;
+}
+
+/**
+ * @brief Load the simulated displays from a key file and switch the backend to the simulator.
+ * @param key_file the simulator key file
+ * @param source where the key file came from, for logging
+ * @param error_loc for returning an error
+ * @return TRUE if successful
+ */
+static gboolean sim_load_key_file(GKeyFile* key_file, const char* source, GError** error_loc) {
+    sim_displays = g_ptr_array_new();
+    gchar** groups = g_key_file_get_groups(key_file, NULL);
+    gboolean ok = TRUE;
+    for (int i = 0; ok && groups[i] != NULL; i++) {
+        if (g_strcmp0(groups[i], SIMULATOR_GROUP) != 0) {
+            Sim_Display* display = sim_load_display(key_file, groups[i], (int) sim_displays->len, error_loc);
+            ok = display != NULL;
+            if (ok) {
+                g_ptr_array_add(sim_displays, display);
+            }
+        }
+    }
+    g_strfreev(groups);
+    if (ok) {
+        sim_load_latency(key_file, SIMULATOR_GROUP, "latency-detect", &sim_detect_latency);
+        ok = sim_load_script(key_file, error_loc);
+    }
+    if (ok) {
+        backend = &simulator_backend;
+        sim_redetect_displays();
+        g_message("Simulating %u displays from %s", sim_displays->len, source);
+    }
+    return ok;
+}
+
+/**
+ * @brief Load the simulated displays from a file and switch the backend to the simulator.
+ * @param path the simulator key file
+ * @param error_loc for returning an error
+ * @return TRUE if successful
+ */
+static gboolean sim_load(const char* path, GError** error_loc) {
+    GKeyFile* key_file = g_key_file_new();
+    const gboolean ok = g_key_file_load_from_file(key_file, path, G_KEY_FILE_NONE, error_loc)
+                        && sim_load_key_file(key_file, path, error_loc);
+    g_key_file_free(key_file);
+    return ok;
+}
+
+/**
+ * @brief Apply a connect, disconnect, sleep or wake event to a simulated display.  Requires sim_mutex.
+ * @param display the display
+ * @param action the event
+ */
+static void sim_apply_event(Sim_Display* display, const char* action) {
+    if (g_strcmp0(action, "connect") == 0 || g_strcmp0(action, "disconnect") == 0) {
+        display->connected = g_strcmp0(action, "connect") == 0;
+    }
+    else if (display->supported[0xd6]) {
+        display->asleep = g_strcmp0(action, "sleep") == 0;
+        display->values[0xd6] = display->asleep ? 4 : 1;
+    }
+}
+
+/**
+ * @brief Run the script steps that are due, then schedule the next one.
+ */
+static gboolean sim_script_step(gpointer user_data) {
+    const double elapsed_seconds = (g_get_monotonic_time() - sim_script_start_micros) / 1000000.0;
+    while (sim_script_next < sim_script->len) {
+        const Sim_Script_Event* event = &g_array_index(sim_script, Sim_Script_Event, sim_script_next);
+        if (event->at_seconds > elapsed_seconds) {
+            break;
+        }
+        g_message("Simulator: %s %s", event->action, event->display->name);
+        g_mutex_lock(&sim_mutex);
+        sim_apply_event(event->display, event->action);
+        g_mutex_unlock(&sim_mutex);
+        sim_script_next++;
+    }
+    if (sim_script_next == sim_script->len && sim_script_repeat_seconds > 0.0) {
+        sim_script_start_micros += (long) (sim_script_repeat_seconds * 1000000);
+        sim_script_next = 0;
+    }
+    if (sim_script_next < sim_script->len) {
+        const double at_seconds = g_array_index(sim_script, Sim_Script_Event, sim_script_next).at_seconds;
+        const long due_micros = sim_script_start_micros + (long) (at_seconds * 1000000);
+        g_timeout_add((guint) MAX((due_micros - g_get_monotonic_time()) / 1000, 0), sim_script_step, NULL);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * @brief Start the simulator's script, if simulating.
+ */
+static void sim_start(void) {
+    if (simulate_path != NULL && sim_script->len > 0) {
+        sim_script_start_micros = g_get_monotonic_time();
+        sim_script_next = 0;
+        sim_script_step(NULL);
+    }
+}
+
+static void poll_soon(void);
+
+/**
+ * @brief Implements the DdcutilService SimulateEvent method
+ *
+ * Applies a connect, disconnect, sleep or wake event to a simulated display, as a script step would,
+ * and brings the next internal poll forward, much as a kernel hotplug notification would.
+ *
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void simulate_event(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    const char* edid_encoded;
+    const char* action;
+    u_int32_t flags;
+    g_variant_get(parameters, "(&s&su)", &edid_encoded, &action, &flags);
+
+    g_info("SimulateEvent action=%s edid=%.30s...", action, edid_encoded);
+
+    DDCA_Status status = DDCRC_UNIMPLEMENTED;  // Not simulating
+    if (simulate_path != NULL) {
+        status = g_strv_contains((const gchar* const[]) {"connect", "disconnect", "sleep", "wake", NULL}, action)
+                     ? DDCRC_INVALID_DISPLAY : DDCRC_ARG;
+    }
+    if (status == DDCRC_INVALID_DISPLAY) {
+        Sim_Display* match = NULL;
+        guint match_count = 0;
+        for (guint i = 0; i < sim_displays->len; i++) {
+            Sim_Display* display = g_ptr_array_index(sim_displays, i);
+            gchar* display_edid = edid_encode(display->info.edid_bytes);
+            if ((flags & EDID_PREFIX) ? g_str_has_prefix(display_edid, edid_encoded)
+                                      : g_strcmp0(display_edid, edid_encoded) == 0) {
+                match = display;
+                match_count++;
+            }
+            g_free(display_edid);
+        }
+        if (match_count == 1 && edid_encoded[0] != '\0') {
+            g_message("Simulator: %s %s", action, match->name);
+            g_mutex_lock(&sim_mutex);
+            sim_apply_event(match, action);
+            g_mutex_unlock(&sim_mutex);
+            poll_soon();
+            status = DDCRC_OK;
+        }
+    }
+    char* message_text = get_status_message(status);
+    GVariant* result = g_variant_new("(is)", status, message_text);
+    g_dbus_method_invocation_return_value(invocation, result);
+    free(message_text);
+}
+
 /**
  * Wrap ddca_get_display_info_list2 filter return status for success. Some versions of libddcutil return
  * both DDCRC_OK and DDCRC_OTHER for success.
@@ -408,7 +1290,7 @@ static char* get_status_message(const DDCA_Status status) {
  * @return DDCRC_OK if successful
  */
 static DDCA_Status get_display_info_list(bool include_invalid, DDCA_Display_Info_List**  dlist_loc, char *msg_prefix) {
-    DDCA_Status detect_status = ddca_get_display_info_list2(include_invalid, dlist_loc);
+    DDCA_Status detect_status = backend->get_display_info_list2(include_invalid, dlist_loc);
 
     // Pre libddcutil 2.1.5 ddca_get_display_info_list2 could return DDCRC_OTHER if some VDUs were invalid,
     // For libddcutil 2.1.5+ ddca_get_display_info_list2 will return DDCRC_OK, but set error_detail if some VDUs
@@ -437,18 +1319,51 @@ static DDCA_Status get_display_info_list(bool include_invalid, DDCA_Display_Info
 }
 
 /**
- * @brief Lookup DDCA_Display_Info for either a display_number or an encoded EDID.
- *
- * This is a supporting-function, it's used by functions that implement the
- * service's methods.  It does the donkey work of looking up a display by
- * number or EDID.
+ * @brief Find the DDCA_Display_Info for either a display_number or an encoded EDID in an existing list.
  *
+ * @param dlist ddcutil list of displays
  * @param display_number display number
  * @param edid_encoded text encoded edid
- * @param dlist ddcutil list of displays (will need to be freed after use)
- * @param dinfo pointer into the list for the matched display
  * @param edid_is_prefix match edid by unique prefix
- * @return success status
+ * @return pointer into the list for the matched display, or NULL if not found
+ */
+static DDCA_Display_Info* find_display_info(DDCA_Display_Info_List* dlist,
+                                            const int display_number, const char* edid_encoded, bool edid_is_prefix) {
+    for (int ndx = 0; ndx < dlist->ct; ndx++) {
+        if (display_number == dlist->info[ndx].dispno) {
+            return &(dlist->info[ndx]);
+        }
+        if (edid_encoded != NULL) {
+            gchar* dlist_edid_encoded = edid_encode(dlist->info[ndx].edid_bytes);
+            const bool edit_matched =
+                    edid_is_prefix
+                        ? (strncmp(edid_encoded, dlist_edid_encoded, strlen(edid_encoded)) == 0)
+                        : (strcmp(edid_encoded, dlist_edid_encoded) == 0);
+            g_free(dlist_edid_encoded);
+            if (edit_matched) {
+                return &(dlist->info[ndx]);
+            }
+        }
+    }
+    if (g_log_get_debug_enabled()) {
+        g_debug("Display info not found: display=%d edid-encoded=%-30s?", display_number, edid_encoded);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Lookup DDCA_Display_Info for either a display_number or an encoded EDID.
+ *
+ * This is a supporting-function, it's used by functions that implement the
+ * service's methods.  It does the donkey work of looking up a display by
+ * number or EDID.
+ *
+ * @param display_number display number
+ * @param edid_encoded text encoded edid
+ * @param dlist ddcutil list of displays (will need to be freed after use)
+ * @param dinfo pointer into the list for the matched display
+ * @param edid_is_prefix match edid by unique prefix
+ * @return success status
  */
 static DDCA_Status get_display_info(const int display_number, const char* edid_encoded,
                                     DDCA_Display_Info_List** dlist, DDCA_Display_Info** dinfo, bool edid_is_prefix) {
@@ -456,424 +1371,5232 @@ static DDCA_Status get_display_info(const int display_number, const char* edid_e
     DDCA_Status status = get_display_info_list(0, dlist, "get_display_info");
 
     if (status == DDCRC_OK) {
-        for (int ndx = 0; ndx < (*dlist)->ct; ndx++) {
-            if (display_number == (*dlist)->info[ndx].dispno) {
-                *dinfo = &((*dlist)->info[ndx]);
-                break;
-            }
-            gchar* dlist_edid_encoded = edid_encode((*dlist)->info[ndx].edid_bytes);
-            if (edid_encoded != NULL) {
-                const bool edit_matched =
-                        edid_is_prefix
-                            ? (strncmp(edid_encoded, dlist_edid_encoded, strlen(edid_encoded)) == 0)
-                            : (strcmp(edid_encoded, dlist_edid_encoded) == 0);
-                if (edit_matched) {
-                    *dinfo = &((*dlist)->info[ndx]);
-                    g_free(dlist_edid_encoded);
-                    break;
-                }
-            }
-            g_free(dlist_edid_encoded);
-        }
+        *dinfo = find_display_info(*dlist, display_number, edid_encoded, edid_is_prefix);
         if (*dinfo == NULL) {
-            if (g_log_get_debug_enabled()) {
-                g_debug("Display info not found: display=%d edid-encoded=%-30s?", display_number, edid_encoded);
-            }
             status = DDCRC_INVALID_DISPLAY;
         }
     }
     return status;
 }
 
-extern char** environ;
+/* ----------------------------------------------------------------------------------------------------
+ * Latency histograms
+ *
+ * Each method records the time its call spends in the main loop (dispatch), waiting for a worker
+ * (queue), and running on the worker (run).  Each I2C display records the time spent in libddcutil
+ * opening it (open), reading (read), writing (write), reading back a written value (verify), and
+ * reading capabilities (caps).  Times go into fixed-bucket histograms, so recording costs a mutex
+ * and a hash lookup, cheap enough to leave on.  Histograms are reported by GetServiceStats and
+ * cleared by setting ServiceStatsResetTime.
+ */
+
+static const guint64 latency_bucket_bounds_micros[] = {
+    250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000,
+};
+
+#define LATENCY_BUCKET_COUNT (G_N_ELEMENTS(latency_bucket_bounds_micros) + 1)  // Plus one for overflow
+
+typedef struct {
+    const char* kind;    // "method" or "display"
+    gchar* name;         // Method name, or /dev/i2c-N
+    const char* phase;   // Static string
+    guint64 count;
+    guint64 sum_micros;
+    guint64 max_micros;
+    guint64 buckets[LATENCY_BUCKET_COUNT];
+} Latency_Histogram;
+
+static GHashTable* latency_table = NULL;  // "kind name phase" -> Latency_Histogram
+static gint64 latency_reset_real_micros = 0;
+static GMutex latency_mutex;              // Protects all of the above
+
+static void latency_histogram_free(gpointer data) {
+    Latency_Histogram* histogram = data;
+    g_free(histogram->name);
+    g_free(histogram);
+}
 
 /**
- * @brief Implement the DdcutilService Restart method
- *
- * Restarts the service. This function must terminate the current
- * process and fork a new one so that dca_init() can then be called
- * to apply libopts, syslog_level and opts.
- *
- * @param parameters containing the new libopts, syslog_level and opts (suu)
- * @param invocation the originating D-Bus call - returning a value to it before terminating the current process.
+ * @brief Add an elapsed time to a histogram.  Requires the mutex protecting the histogram.
+ * @param histogram the histogram
+ * @param start_micros monotonic start time
  */
-static void restart(GVariant* parameters, GDBusMethodInvocation* invocation) {
-    if (lock_configuration) {
-        g_dbus_method_invocation_return_error(invocation, service_error_quark, DDCUTIL_SERVICE_CONFIGURATION_LOCKED,
-            "Failed to restart the service: configuration locked by --lock command line argument.");
-        return;
+static void latency_histogram_add(Latency_Histogram* histogram, const long start_micros) {
+    const guint64 elapsed_micros = MAX(g_get_monotonic_time() - start_micros, 0);
+    int bucket = 0;
+    while (bucket < G_N_ELEMENTS(latency_bucket_bounds_micros)
+           && elapsed_micros > latency_bucket_bounds_micros[bucket]) {
+        bucket++;
     }
-    char* libopts;
-    u_int32_t syslog_level;
-    u_int32_t opts;
-    g_variant_get(parameters, "(suu)", &libopts, &syslog_level, &opts);
-    char* message_text = get_status_message(DDCRC_OK);
-    g_message("DdcaInit syslog_level=%x opts=%x libopts=%s", syslog_level, opts, libopts);
-    GVariant* result = g_variant_new("(is)", DDCRC_OK, message_text);
-    g_dbus_method_invocation_return_value(invocation, result);
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    histogram->sum_micros += elapsed_micros;
+    histogram->max_micros = MAX(histogram->max_micros, elapsed_micros);
+}
 
-    gchar** argv;
-#if defined(LIBDDCUTIL_HAS_OPTION_ARGUMENTS)
-    gchar* args_str = "";
-    if (syslog_level != 0) {
-        args_str = g_strdup_printf("%s --ddca-syslog-level=%d", args_str, syslog_level);
+/**
+ * @brief Add an elapsed time to the histogram for a phase.
+ * @param kind "method" or "display"
+ * @param name the method name or display device
+ * @param phase static string naming the phase
+ * @param start_micros monotonic start time of the phase
+ */
+static void latency_record(const char* kind, const char* name, const char* phase, const long start_micros) {
+    char key[128];
+    g_snprintf(key, sizeof(key), "%s %s %s", kind, name, phase);
+    g_mutex_lock(&latency_mutex);
+    if (latency_table == NULL) {
+        latency_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, latency_histogram_free);
+        latency_reset_real_micros = g_get_real_time();
     }
-    if (opts != 0) {
-        args_str = g_strdup_printf("%s --ddca-init-options=%d", args_str, opts);
+    Latency_Histogram* histogram = g_hash_table_lookup(latency_table, key);
+    if (histogram == NULL) {
+        histogram = g_new0(Latency_Histogram, 1);
+        histogram->kind = kind;
+        histogram->name = g_strdup(name);
+        histogram->phase = phase;
+        g_hash_table_insert(latency_table, g_strdup(key), histogram);
     }
-    args_str = g_strdup_printf("%s -- %s", args_str, libopts);
-    argv = g_strsplit(args_str, " ", -1);
-#else
-  gchar *no_args = { NULL };
-  argv = &no_args;
-#endif
+    latency_histogram_add(histogram, start_micros);
+    g_mutex_unlock(&latency_mutex);
+}
 
-    // If running under dbus-daemon a respawn is not necessary except that
-    // we want to pass arguments.
-    const struct sigaction arg = {
-        .sa_handler = SIG_IGN,
-        .sa_flags = SA_NOCLDWAIT // Never wait for termination of a child process.
-    };
-    sigaction(SIGCHLD, &arg, NULL);
+static void latency_record_method(const char* method_name, const char* phase, const long start_micros) {
+    latency_record("method", method_name, phase, start_micros);
+}
 
-    pid_t spawn_pid;
-    posix_spawn(&spawn_pid, server_executable, NULL, NULL, argv, environ);
-    exit(0);
+/**
+ * @brief Record a phase of a DDC operation on an I2C display.
+ * @param busno the display's I2C bus number, negative if not an I2C display (not recorded)
+ * @param phase static string naming the phase
+ * @param start_micros monotonic start time of the phase
+ */
+static void latency_record_display(const int busno, const char* phase, const long start_micros) {
+    if (busno >= 0) {
+        char name[32];
+        g_snprintf(name, sizeof(name), "/dev/i2c-%d", busno);
+        latency_record("display", name, phase, start_micros);
+    }
 }
 
-#if defined(LIBDDCUTIL_HAS_CHANGES_CALLBACK)
-static void display_status_event_callback(DDCA_Display_Status_Event event);
-#endif
+/**
+ * @brief Discard all histograms.
+ */
+static void latency_reset(void) {
+    g_mutex_lock(&latency_mutex);
+    if (latency_table != NULL) {
+        g_hash_table_remove_all(latency_table);
+    }
+    latency_reset_real_micros = g_get_real_time();
+    g_mutex_unlock(&latency_mutex);
+}
 
 /**
- * @brief Implements the DdcutilService Detect method
+ * @brief When the histograms were last reset.
+ * @return wall clock time in microseconds since the epoch, zero if nothing has been recorded yet
+ */
+static gint64 latency_get_reset_time(void) {
+    g_mutex_lock(&latency_mutex);
+    const gint64 reset_real_micros = latency_reset_real_micros;
+    g_mutex_unlock(&latency_mutex);
+    return reset_real_micros;
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * Flight recorder
  *
- * Passes a list of display structs back to the invocation.
+ * A fixed-size ring of binary records of recent method calls and DDC operations, held in a file
+ * mapped into memory, so that the most recent records survive a crash of the service.  Writing a
+ * record is a slot claim and a few stores, cheap enough to leave on.  The trace is returned by the
+ * GetTrace method, and ddcutil-client can dump it directly from the file when the service is dead.
+ * On startup, the trace of the previous instance is kept as TRACE_PREVIOUS_FILENAME.
  *
+ * The record layout is shared with ddcutil-client, change TRACE_MAGIC if it changes.
+ */
+
+#define TRACE_FILENAME "ddcutil-service-trace.bin"
+#define TRACE_PREVIOUS_FILENAME "ddcutil-service-trace.previous.bin"
+#define TRACE_MAGIC "DDCTRC1"
+#define DEFAULT_TRACE_RECORDS 8192
+
+typedef enum {
+    TRACE_CALL = 1,  // Method call handled by the main loop, scheduled calls are only queued here
+    TRACE_RUN = 2,   // Method call run on a worker thread
+    TRACE_I2C = 3,   // DDC operation, the display is the I2C bus number
+} Trace_Kind;
+
+typedef struct {
+    gint64 real_micros;        // Start time
+    gint sequence;             // Atomic, written last, zero while the record is being written
+    guint32 duration_micros;
+    gint32 status;             // For calls, the first DDC failure during the call
+    gint16 display;            // Display number, or I2C bus number
+    guint8 vcp_code;
+    guint8 kind;               // Trace_Kind
+    char sender[16];
+    char name[24];             // Method or DDC operation
+} Trace_Record;
+
+typedef struct {
+    char magic[8];
+    guint32 record_size;
+    guint32 capacity;
+    gint next;                 // Atomic, total records claimed
+    char reserved[44];
+} Trace_Header;
+
+static int trace_records = DEFAULT_TRACE_RECORDS;  // Set by command line argument, zero to disable
+static Trace_Header* trace_header = NULL;
+static Trace_Record* trace_ring = NULL;
+static GPrivate trace_thread_status;  // First DDC failure on this thread since trace_call_begin
+
+/**
+ * @brief Map the flight recorder file, keeping the previous instance's trace.
+ */
+static void trace_start(void) {
+    if (trace_records <= 0) {
+        return;
+    }
+    gchar* path = g_build_filename(g_get_user_runtime_dir(), TRACE_FILENAME, NULL);
+    gchar* previous_path = g_build_filename(g_get_user_runtime_dir(), TRACE_PREVIOUS_FILENAME, NULL);
+    rename(path, previous_path);
+    // A power of two, so that slot n % capacity stays continuous when the guint claim counter wraps.
+    guint capacity = 1;
+    while (capacity < (guint) trace_records) {
+        capacity <<= 1;
+    }
+    const size_t size = sizeof(Trace_Header) + (size_t) capacity * sizeof(Trace_Record);
+    const int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    void* mapped = MAP_FAILED;
+    if (fd >= 0 && ftruncate(fd, (off_t) size) == 0) {
+        mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (mapped == MAP_FAILED) {
+        g_warning("Flight recorder: failed to map %s: %s", path, g_strerror(errno));
+    }
+    else {
+        trace_header = mapped;
+        trace_header->record_size = sizeof(Trace_Record);
+        trace_header->capacity = capacity;
+        memcpy(trace_header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        trace_ring = (Trace_Record *) (trace_header + 1);
+        g_message("Flight recorder: recording the last %u operations in %s", capacity, path);
+    }
+    if (fd >= 0) {
+        close(fd);  // The mapping remains
+    }
+    g_free(previous_path);
+    g_free(path);
+}
+
+/**
+ * @brief Append a record to the flight recorder.
+ * @param kind a Trace_Kind
+ * @param sender D-Bus sender, may be NULL
+ * @param name method or DDC operation name
+ * @param display display number or I2C bus number
+ * @param vcp_code VCP-code, zero if not applicable
+ * @param status libddcutil status
+ * @param start_micros monotonic start time
+ */
+static void trace_record(const Trace_Kind kind, const char* sender, const char* name, const int display,
+                         const uint8_t vcp_code, const DDCA_Status status, const long start_micros) {
+    if (trace_ring == NULL) {
+        return;
+    }
+    const long now_micros = g_get_monotonic_time();
+    const guint n = (guint) g_atomic_int_add(&trace_header->next, 1);
+    Trace_Record* record = &trace_ring[n % trace_header->capacity];
+    g_atomic_int_set(&record->sequence, 0);  // Readers drop the record if they see this change
+    __atomic_thread_fence(__ATOMIC_RELEASE);  // Orders the store above before the field stores
+    record->real_micros = g_get_real_time() - (now_micros - start_micros);
+    record->duration_micros = (guint32) MIN(now_micros - start_micros, G_MAXUINT32);
+    record->status = status;
+    record->display = (gint16) display;
+    record->vcp_code = vcp_code;
+    record->kind = kind;
+    strncpy(record->sender, sender != NULL ? sender : "", sizeof(record->sender));
+    strncpy(record->name, name, sizeof(record->name));
+    g_atomic_int_set(&record->sequence, (gint) (n + 1));  // Publishes the record
+}
+
+/**
+ * @brief Note a DDC outcome against the method call running on this thread.
+ * @param status libddcutil status
+ */
+static void trace_note_status(const DDCA_Status status) {
+    if (status != DDCRC_OK && g_private_get(&trace_thread_status) == NULL) {
+        g_private_set(&trace_thread_status, GINT_TO_POINTER(status));
+    }
+}
+
+/**
+ * @brief Start tracing a method call on this thread.
+ * @param parameters the call's parameters, the display number and VCP-code are taken from the
+ *                   conventional (isy...) leading arguments, if present, for tracing and probes
+ * @param display output display number, -1 if none
+ * @param vcp_code output VCP-code, zero if none
+ */
+static void trace_call_begin(GVariant* parameters, int* display, uint8_t* vcp_code) {
+    g_private_set(&trace_thread_status, NULL);
+    *display = -1;
+    *vcp_code = 0;
+    const gchar* type = g_variant_get_type_string(parameters);
+    if (g_str_has_prefix(type, "(i")) {
+        g_variant_get_child(parameters, 0, "i", display);
+    }
+    if (g_str_has_prefix(type, "(isy")) {
+        g_variant_get_child(parameters, 2, "y", vcp_code);
+    }
+}
+
+/**
+ * @brief Record a method call traced with trace_call_begin.
+ * @param kind TRACE_CALL or TRACE_RUN
+ * @param sender D-Bus sender
+ * @param method_name the method
+ * @param display display number from trace_call_begin
+ * @param vcp_code VCP-code from trace_call_begin
+ * @param start_micros monotonic start time
+ */
+static void trace_call_end(const Trace_Kind kind, const char* sender, const char* method_name, const int display,
+                           const uint8_t vcp_code, const long start_micros) {
+    trace_record(kind, sender, method_name, display, vcp_code, GPOINTER_TO_INT(g_private_get(&trace_thread_status)),
+                 start_micros);
+}
+
+/**
+ * @brief Implements D-Bus method GetTrace, returns the flight recorder's records, oldest first.
  * @param parameters inbound parameters
- * @param invocation originating D-Bus method call
+ * @param invocation D-Bus method call
  */
-static void detect(GVariant* parameters, GDBusMethodInvocation* invocation, gboolean list_only) {
+static void get_trace(GVariant* parameters, GDBusMethodInvocation* invocation) {
     u_int32_t flags;
     g_variant_get(parameters, "(u)", &flags);
 
-    int vdu_count = 0;
+    g_info("GetTrace");
+
+    GVariantBuilder builder_instance;
+    GVariantBuilder* builder = &builder_instance;
+    g_variant_builder_init(builder, G_VARIANT_TYPE("a(xuyssiyiu)"));
+    if (trace_ring != NULL) {
+        const guint next = (guint) g_atomic_int_get(&trace_header->next);
+        const guint count = MIN(next, trace_header->capacity);
+        for (guint n = next - count; n != next; n++) {
+            Trace_Record* slot = &trace_ring[n % trace_header->capacity];
+            if ((guint) g_atomic_int_get(&slot->sequence) != n + 1) {
+                continue;  // Being written, or already overwritten
+            }
+            // Seqlock read, trace_record() doesn't take a lock, so copy and then check the slot wasn't reused.
+            Trace_Record record;
+            memcpy(&record, slot, sizeof(Trace_Record));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if ((guint) g_atomic_int_get(&slot->sequence) != n + 1) {
+                continue;  // Overwritten while being copied
+            }
+            char sender[sizeof(record.sender) + 1] = {0};
+            char name[sizeof(record.name) + 1] = {0};
+            memcpy(sender, record.sender, sizeof(record.sender));
+            memcpy(name, record.name, sizeof(record.name));
+            g_variant_builder_add(builder, "(xuyssiyiu)", record.real_micros, n + 1, record.kind,
+                                  sender, name, (gint32) record.display, record.vcp_code, record.status,
+                                  record.duration_micros);
+        }
+    }
+    const DDCA_Status status = trace_ring != NULL ? DDCRC_OK : DDCRC_UNIMPLEMENTED;
+    char* message_text = get_status_message(status);
+    GVariant* result = g_variant_new("(a(xuyssiyiu)is)", builder, status, message_text);
+    g_dbus_method_invocation_return_value(invocation, result);
+    free(message_text);
+}
 
-    // GVariantBuilder: see https://docs.gtk.org/glib/struct.VariantBuilder.html
-    GVariantBuilder detected_displays_builder_instance; // Allocate on the stack for easier memory management.
-    GVariantBuilder* detected_displays_builder = &detected_displays_builder_instance;
-    g_variant_builder_init(detected_displays_builder, G_VARIANT_TYPE("a(iiisssqsu)"));
+/* ----------------------------------------------------------------------------------------------------
+ * Main-loop stall detection
+ *
+ * Method calls that aren't scheduled on worker threads, internal polling and signal dispatch all run on
+ * the GMainLoop, so one slow DDC call there can hold up every client.  A heartbeat timer on the main
+ * loop records when it last ran.  A watchdog thread notices when the heartbeat is overdue, and notes
+ * the phase the main loop was in, as set by watchdog_phase_set, for example "poll_for_changes/is_dpms_awake
+ * disp 3".  When the heartbeat resumes, the stall's duration is added to a histogram and the most recent
+ * stalls are kept, both are reported by the ServiceMainLoopStalls property.
+ */
 
-    g_info("Detect flags=%x", flags);
+#define DEFAULT_STALL_THRESHOLD_MILLIS 250
+#define STALL_RECORDS_KEPT 16
+#define STALL_PHASE_MAX 64
 
-    DDCA_Status detect_status = DDCRC_OK;
-    char* detect_message_text = NULL;
+typedef struct {
+    gint64 real_micros;         // Start of the stall
+    guint64 duration_micros;
+    char phase[STALL_PHASE_MAX + 16];
+} Stall_Record;
+
+static int stall_threshold_millis = DEFAULT_STALL_THRESHOLD_MILLIS;  // Set by command line argument, 0 to disable
+static gboolean stall_warnings = FALSE;                              // Set by command line argument
+
+static long heartbeat_interval_micros = 0;
+static long last_heartbeat_micros = 0;
+static char mainloop_phase[STALL_PHASE_MAX] = "";   // Empty when idle
+static int mainloop_phase_display = -1;
+static gboolean stall_in_progress = FALSE;
+static char stall_phase[STALL_PHASE_MAX + 16] = "";  // Phase noted by the watchdog during the current stall
+static Latency_Histogram stall_histogram;
+static Stall_Record stall_records[STALL_RECORDS_KEPT];
+static guint stall_record_count = 0;                 // Total recorded, the ring holds the most recent
+static GMutex watchdog_mutex;                        // Protects all of the above
 
-    if (!list_only) {
-        detect_status = ddca_redetect_displays();
+/**
+ * @brief Note what the main loop is doing, in case it stalls.  Only called from the main loop.
+ * @param phase static or short-lived description, NULL when finished
+ * @param display the display number concerned, -1 if none
+ */
+static void watchdog_phase_set(const char* phase, const int display) {
+    if (heartbeat_interval_micros == 0) {
+        return;
     }
+    g_mutex_lock(&watchdog_mutex);
+    g_strlcpy(mainloop_phase, phase != NULL ? phase : "", sizeof(mainloop_phase));  // Copied, phase may be freed
+    mainloop_phase_display = display;
+    g_mutex_unlock(&watchdog_mutex);
+}
 
-    if (detect_status != DDCRC_OK) {
-        detect_message_text = get_status_message(detect_status);
-        g_warning("Detect: ddca_redetect_displays failed status=%d message=%s", detect_status, detect_message_text);
+/**
+ * @brief Main loop timer, records the heartbeat and completes any stall that has just ended.
+ */
+static gboolean watchdog_heartbeat(gpointer user_data) {
+    const long now = g_get_monotonic_time();
+    g_mutex_lock(&watchdog_mutex);
+    const long late_micros = now - last_heartbeat_micros - heartbeat_interval_micros;
+    last_heartbeat_micros = now;
+    if (late_micros >= stall_threshold_millis * 1000L) {
+        Stall_Record* record = &stall_records[stall_record_count++ % STALL_RECORDS_KEPT];
+        record->real_micros = g_get_real_time() - late_micros;
+        record->duration_micros = late_micros;
+        g_strlcpy(record->phase, stall_in_progress ? stall_phase : "unknown", sizeof(record->phase));
+        latency_histogram_add(&stall_histogram, now - late_micros);
+        if (stall_warnings) {
+            g_warning("Main loop stalled for %ld ms in %s", late_micros / 1000, record->phase);
+        }
     }
-    else {
-        DDCA_Display_Info_List *dlist = NULL;
-        const int detect_all = (flags & DETECT_ALL) || (flags & EDID_PREFIX);  // Accept either because of old API error
-        detect_status = get_display_info_list(detect_all, &dlist, "Detect");
-        detect_message_text = get_status_message(detect_status);
-        if (detect_status != DDCRC_OK) {
-            g_warning("Detect: ddca_get_display_info_list2 failed status=%d message=%s",
-                      detect_status, detect_message_text);
-        } else {
-            vdu_count = dlist->ct;
-#if defined(TEST_LAPTOP_BOGUS_VDU)
-            g_variant_builder_add(
-                detected_displays_builder,
-                "(iiisssqsu)",
-                -1, -1, 0,
-                g_strdup(""), g_strdup(""), g_strdup(""),
-                0,
-                g_strdup("123456789-123456789-123456789-123456789-123456789-123456789-123456789-123456789-123456789"
-                "-123456789-123456789-123456789-12345678"),
-                0);
-            vdu_count++;
-#endif
-            for (int ndx = 0; ndx < vdu_count; ndx++) {
-                const DDCA_Display_Info *vdu_info = &dlist->info[ndx];
-                gchar *safe_mfg_id = sanitize_utf8(vdu_info->mfg_id);
-                gchar *safe_model = sanitize_utf8(vdu_info->model_name); //"xxxxwww\xF0\xA4\xADiii" );
-                gchar *safe_sn = sanitize_utf8(vdu_info->sn);
-                gchar *edid_encoded = edid_encode(vdu_info->edid_bytes);
-                g_info("Detect: detected %s %s %s display_num=%d edid=%.30s...",
-                       safe_mfg_id, safe_model, safe_sn, vdu_info->dispno, edid_encoded);
-                g_variant_builder_add(
-                        detected_displays_builder,
-                        "(iiisssqsu)",
-                        vdu_info->dispno, vdu_info->usb_bus, vdu_info->usb_device,
-                        safe_mfg_id, safe_model, safe_sn,
-                        vdu_info->product_code,
-                        edid_encoded,
-                        edid_to_binary_serial_number(vdu_info->edid_bytes));
-                g_free(safe_mfg_id);
-                g_free(safe_model);
-                g_free(safe_sn);
-                g_free(edid_encoded);
+    stall_in_progress = FALSE;
+    g_mutex_unlock(&watchdog_mutex);
+    return G_SOURCE_CONTINUE;
+}
+
+static gpointer watchdog_thread_func(gpointer data) {
+    while (TRUE) {
+        g_usleep(heartbeat_interval_micros);
+        g_mutex_lock(&watchdog_mutex);
+        const long overdue_micros = g_get_monotonic_time() - last_heartbeat_micros - heartbeat_interval_micros;
+        if (!stall_in_progress && overdue_micros >= stall_threshold_millis * 1000L) {
+            // Note the phase now, while the main loop is still stuck in it.
+            if (mainloop_phase_display >= 0) {
+                g_snprintf(stall_phase, sizeof(stall_phase), "%s disp %d",
+                           mainloop_phase[0] != '\0' ? mainloop_phase : "idle", mainloop_phase_display);
+            }
+            else {
+                g_strlcpy(stall_phase, mainloop_phase[0] != '\0' ? mainloop_phase : "idle", sizeof(stall_phase));
+            }
+            stall_in_progress = TRUE;
+            if (stall_warnings) {
+                g_warning("Main loop has stalled for over %d ms in %s", stall_threshold_millis, stall_phase);
             }
-            ddca_free_display_info_list(dlist);
         }
+        g_mutex_unlock(&watchdog_mutex);
     }
+    return NULL;
+}
 
-    GVariant* result = g_variant_new("(ia(iiisssqsu)is)",
-                                     vdu_count, detected_displays_builder, detect_status, detect_message_text);
+/**
+ * @brief Start the heartbeat and watchdog, unless disabled.
+ */
+static void watchdog_start(void) {
+    if (stall_threshold_millis <= 0) {
+        return;
+    }
+    heartbeat_interval_micros = MAX(stall_threshold_millis * 1000L / 4, 10000L);
+    last_heartbeat_micros = g_get_monotonic_time();
+    g_timeout_add(heartbeat_interval_micros / 1000, watchdog_heartbeat, NULL);
+    g_thread_new("watchdog", watchdog_thread_func, NULL);
+    g_message("Main loop stall detection enabled, threshold %d ms", stall_threshold_millis);
+}
+
+/**
+ * @brief Build the value of the ServiceMainLoopStalls property.
+ * @return a{sv} of threshold_millis, count, max_micros, bucket_bounds_micros, buckets,
+ *         and recent, an a(xts) of (start time, duration micros, phase), most recent first
+ */
+static GVariant* get_stall_statistics(void) {
+    GVariantBuilder builder_instance;
+    GVariantBuilder* builder = &builder_instance;
+    g_variant_builder_init(builder, G_VARIANT_TYPE("a{sv}"));
+    GVariantBuilder bounds_builder_instance;
+    GVariantBuilder* bounds_builder = &bounds_builder_instance;
+    g_variant_builder_init(bounds_builder, G_VARIANT_TYPE("at"));
+    for (int i = 0; i < G_N_ELEMENTS(latency_bucket_bounds_micros); i++) {
+        g_variant_builder_add(bounds_builder, "t", latency_bucket_bounds_micros[i]);
+    }
+    GVariantBuilder buckets_builder_instance;
+    GVariantBuilder* buckets_builder = &buckets_builder_instance;
+    g_variant_builder_init(buckets_builder, G_VARIANT_TYPE("at"));
+    GVariantBuilder recent_builder_instance;
+    GVariantBuilder* recent_builder = &recent_builder_instance;
+    g_variant_builder_init(recent_builder, G_VARIANT_TYPE("a(xts)"));
+    g_mutex_lock(&watchdog_mutex);
+    for (int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+        g_variant_builder_add(buckets_builder, "t", stall_histogram.buckets[i]);
+    }
+    for (guint n = stall_record_count; n > 0 && stall_record_count - n < STALL_RECORDS_KEPT; n--) {
+        const Stall_Record* record = &stall_records[(n - 1) % STALL_RECORDS_KEPT];
+        g_variant_builder_add(recent_builder, "(xts)", record->real_micros, record->duration_micros, record->phase);
+    }
+    g_variant_builder_add(builder, "{sv}", "threshold_millis", g_variant_new_int32(stall_threshold_millis));
+    g_variant_builder_add(builder, "{sv}", "count", g_variant_new_uint64(stall_histogram.count));
+    g_variant_builder_add(builder, "{sv}", "max_micros", g_variant_new_uint64(stall_histogram.max_micros));
+    g_mutex_unlock(&watchdog_mutex);
+    g_variant_builder_add(builder, "{sv}", "bucket_bounds_micros", g_variant_builder_end(bounds_builder));
+    g_variant_builder_add(builder, "{sv}", "buckets", g_variant_builder_end(buckets_builder));
+    g_variant_builder_add(builder, "{sv}", "recent", g_variant_builder_end(recent_builder));
+    return g_variant_builder_end(builder);
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * Metrics collection
+ *
+ * Statistics only needed by the OpenMetrics endpoint (see --metrics-socket) are collected when the
+ * endpoint is listening: DDC outcomes by status, per-display health, poll pass durations, and
+ * conditional read cache hits.
+ */
+
+typedef struct {
+    int busno;
+    guint64 ok_count;
+    guint64 error_count;
+    guint consecutive_failures;
+    gint64 last_ok_real_micros;   // Zero if never
+} Display_Health;
+
+static gboolean metrics_enabled = FALSE;           // Set once the endpoint is listening
+static GHashTable* ddc_status_counts = NULL;       // DDCA status -> guint64 count
+static GHashTable* display_health_table = NULL;    // busno -> Display_Health
+static Latency_Histogram poll_pass_histogram;
+static GMutex metrics_mutex;                       // Protects all of the above
+
+/**
+ * @brief Count the outcome of a DDC operation.
+ * @param busno the display's I2C bus number, negative if not an I2C display (no health recorded)
+ * @param status the libddcutil status of the operation
+ */
+static void metrics_record_ddc(const int busno, const DDCA_Status status) {
+    if (!metrics_enabled) {
+        return;
+    }
+    g_mutex_lock(&metrics_mutex);
+    if (ddc_status_counts == NULL) {
+        ddc_status_counts = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+        display_health_table = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    }
+    guint64* count = g_hash_table_lookup(ddc_status_counts, GINT_TO_POINTER(status));
+    if (count == NULL) {
+        count = g_new0(guint64, 1);
+        g_hash_table_insert(ddc_status_counts, GINT_TO_POINTER(status), count);
+    }
+    (*count)++;
+    if (busno >= 0) {
+        Display_Health* health = g_hash_table_lookup(display_health_table, GINT_TO_POINTER(busno));
+        if (health == NULL) {
+            health = g_new0(Display_Health, 1);
+            health->busno = busno;
+            g_hash_table_insert(display_health_table, GINT_TO_POINTER(busno), health);
+        }
+        if (status == DDCRC_OK) {
+            health->ok_count++;
+            health->consecutive_failures = 0;
+            health->last_ok_real_micros = g_get_real_time();
+        }
+        else {
+            health->error_count++;
+            health->consecutive_failures++;
+        }
+    }
+    g_mutex_unlock(&metrics_mutex);
+}
+
+/**
+ * @brief Record the duration of an internal poll pass.
+ * @param start_micros monotonic start time of the pass
+ */
+static void metrics_record_poll_pass(const long start_micros) {
+    if (metrics_enabled) {
+        g_mutex_lock(&metrics_mutex);
+        latency_histogram_add(&poll_pass_histogram, start_micros);
+        g_mutex_unlock(&metrics_mutex);
+    }
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * I2C rate limiting
+ *
+ * Some VDUs lock up their DDC/CI controller if sent transactions too quickly.  Every DDC operation
+ * performed by the service passes through a token bucket for its I2C bus.  The default rate is set
+ * by --i2c-rate-limit (zero for unlimited), and may be overridden per model or per display in
+ * $XDG_CONFIG_HOME/ddcutil-service/rate-limits.ini, for example:
+ *
+ *     [all]
+ *     rate=10
+ *     burst=2
+ *     [model-HP ZR24w]
+ *     rate=4
+ *     [edid-AP////////AHJ...]
+ *     rate=2
+ *
+ * Groups are applied in the order all, model, edid, so the most specific wins.  Writes are preferred,
+ * reads wait while any write is waiting for the same bus, so background polling and capability
+ * reads cannot hold up an interactive change.  Each libddcutil call consumes one token, libddcutil's
+ * own retries and verification are not metered separately.  A feature metadata lookup may read the
+ * display's VCP version, libddcutil caches it, so only the first lookup for each display is metered.
+ *
+ * Waiting for a token must never happen on the GMainLoop.  The internal poll, which runs there, uses
+ * rate_limit_try_acquire() and postpones a display's DPMS check, or adding a newly seen display, if no
+ * token is immediately available.
+ */
+
+#define DEFAULT_I2C_RATE_LIMIT_BURST 2
+#define RATE_LIMITS_SELECTOR_ALL "all"
+#define RATE_LIMITS_SELECTOR_MODEL_PREFIX "model-"
+#define RATE_LIMITS_SELECTOR_EDID_PREFIX "edid-"
+
+typedef struct {
+    int busno;
+    double rate;                  // Transactions per second, zero for unlimited
+    double burst;                 // Bucket capacity
+    double tokens;
+    long refill_micros;           // Monotonic time tokens was last topped up
+    guint waiting_writes;
+    guint waiting_reads;
+    guint64 granted_writes;
+    guint64 granted_reads;
+    guint64 delayed_count;        // Transactions that had to wait for a token
+    guint64 total_wait_micros;
+    guint64 max_wait_micros;
+    DDCA_Display_Ref version_dref;  // Display whose VCP version libddcutil has already read
+} Bus_Limiter;
+
+static double i2c_rate_limit = 0.0;  // Default transactions per second, set by command line argument
+
+static GKeyFile* rate_limits_key_file = NULL;
+static GHashTable* bus_limiter_table = NULL;  // busno -> Bus_Limiter
+static GMutex rate_limit_mutex;               // Protects all of the above
+static GCond rate_limit_cond;
+static GPrivate rate_limit_prepaid;           // busno + 1 of a token taken by rate_limit_try_acquire()
+
+/**
+ * @brief Apply the rate and burst in a group of rate-limits.ini, if present.  Requires rate_limit_mutex.
+ * @param group the group name
+ * @param limiter the limiter to update
+ */
+static void rate_limits_apply_group(const gchar* group, Bus_Limiter* limiter) {
+    if (g_key_file_has_key(rate_limits_key_file, group, "rate", NULL)) {
+        limiter->rate = MAX(0.0, g_key_file_get_double(rate_limits_key_file, group, "rate", NULL));
+    }
+    if (g_key_file_has_key(rate_limits_key_file, group, "burst", NULL)) {
+        limiter->burst = MAX(1, g_key_file_get_integer(rate_limits_key_file, group, "burst", NULL));
+    }
+}
+
+/**
+ * @brief Create the limiter for a bus, configured for the display on it.  Requires rate_limit_mutex.
+ * @param dinfo the display on the bus
+ * @return the new limiter, owned by bus_limiter_table
+ */
+static Bus_Limiter* bus_limiter_new(const DDCA_Display_Info* dinfo) {
+    if (rate_limits_key_file == NULL) {
+        rate_limits_key_file = g_key_file_new();
+        gchar* path = g_build_filename(g_get_user_config_dir(), "ddcutil-service", "rate-limits.ini", NULL);
+        GError* local_error = NULL;
+        if (!g_key_file_load_from_file(rate_limits_key_file, path, G_KEY_FILE_NONE, &local_error)) {
+            if (!g_error_matches(local_error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+                g_warning("Rate limits: failed to load %s: %s", path, local_error->message);
+            }
+            g_error_free(local_error);
+        }
+        else {
+            g_message("Rate limits: loaded %s", path);
+        }
+        g_free(path);
+    }
+    Bus_Limiter* limiter = g_new0(Bus_Limiter, 1);
+    limiter->busno = dinfo->path.path.i2c_busno;
+    limiter->rate = i2c_rate_limit;
+    limiter->burst = DEFAULT_I2C_RATE_LIMIT_BURST;
+    rate_limits_apply_group(RATE_LIMITS_SELECTOR_ALL, limiter);
+    gchar* model_group = g_strconcat(RATE_LIMITS_SELECTOR_MODEL_PREFIX, dinfo->model_name, NULL);
+    rate_limits_apply_group(model_group, limiter);
+    g_free(model_group);
+    gchar** groups = g_key_file_get_groups(rate_limits_key_file, NULL);
+    gchar* edid_encoded = edid_encode(dinfo->edid_bytes);
+    for (int i = 0; groups[i] != NULL; i++) {
+        if (g_str_has_prefix(groups[i], RATE_LIMITS_SELECTOR_EDID_PREFIX)) {
+            const char* edid_prefix = groups[i] + strlen(RATE_LIMITS_SELECTOR_EDID_PREFIX);
+            if (strncmp(edid_prefix, edid_encoded, strlen(edid_prefix)) == 0) {
+                rate_limits_apply_group(groups[i], limiter);
+            }
+        }
+    }
+    g_free(edid_encoded);
+    g_strfreev(groups);
+    limiter->tokens = limiter->burst;
+    limiter->refill_micros = g_get_monotonic_time();
+    g_hash_table_insert(bus_limiter_table, GINT_TO_POINTER(limiter->busno), limiter);
+    if (limiter->rate > 0.0) {
+        g_message("Rate limits: /dev/i2c-%d %s limited to %.1f transactions per second, burst %.0f",
+                  limiter->busno, dinfo->model_name, limiter->rate, limiter->burst);
+    }
+    return limiter;
+}
+
+/**
+ * @brief Return the limiter for a display's bus, creating it on first use.  Requires rate_limit_mutex.
+ * @param dinfo the display, on an I2C bus
+ * @return the limiter, owned by bus_limiter_table
+ */
+static Bus_Limiter* bus_limiter_get(const DDCA_Display_Info* dinfo) {
+    if (bus_limiter_table == NULL) {
+        bus_limiter_table = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    }
+    Bus_Limiter* limiter = g_hash_table_lookup(bus_limiter_table, GINT_TO_POINTER(dinfo->path.path.i2c_busno));
+    if (limiter == NULL) {
+        limiter = bus_limiter_new(dinfo);
+    }
+    return limiter;
+}
+
+/**
+ * @brief Top up a limiter's tokens for the time elapsed since the last top up.  Requires rate_limit_mutex.
+ * @param limiter the limiter
+ * @param now monotonic time now
+ */
+static void bus_limiter_refill(Bus_Limiter* limiter, const long now) {
+    limiter->tokens = MIN(limiter->burst, limiter->tokens + (now - limiter->refill_micros) * limiter->rate / 1000000.0);
+    limiter->refill_micros = now;
+}
+
+/**
+ * @brief Take a read token for a display's bus only if one is available now, never waits.
+ *
+ * For callers on the GMainLoop.  On success, the calling thread's next rate_limit_acquire() for the
+ * bus uses the token rather than waiting.
+ *
+ * @param dinfo the display
+ * @return TRUE if the read may proceed, FALSE if it should be retried later
+ */
+static gboolean rate_limit_try_acquire(const DDCA_Display_Info* dinfo) {
+    if (dinfo->path.io_mode != DDCA_IO_I2C) {  // USB VDUs aren't affected
+        return TRUE;
+    }
+    gboolean acquired = TRUE;
+    g_mutex_lock(&rate_limit_mutex);
+    Bus_Limiter* limiter = bus_limiter_get(dinfo);
+    if (limiter->rate > 0.0) {
+        bus_limiter_refill(limiter, g_get_monotonic_time());
+        acquired = limiter->tokens >= 1.0 && limiter->waiting_writes == 0;
+        if (acquired) {
+            limiter->tokens -= 1.0;
+            g_private_set(&rate_limit_prepaid, GINT_TO_POINTER(limiter->busno + 1));
+        }
+    }
+    g_mutex_unlock(&rate_limit_mutex);
+    return acquired;
+}
+
+/**
+ * @brief Return an unused token taken by rate_limit_try_acquire(), if the calling thread holds one.
+ *
+ * For GMainLoop callers whose DDC call was not made, for example because the open failed.
+ */
+static void rate_limit_refund_prepaid(void) {
+    const int busno = GPOINTER_TO_INT(g_private_get(&rate_limit_prepaid)) - 1;
+    if (busno < 0) {
+        return;
+    }
+    g_private_set(&rate_limit_prepaid, NULL);
+    g_mutex_lock(&rate_limit_mutex);
+    Bus_Limiter* limiter = g_hash_table_lookup(bus_limiter_table, GINT_TO_POINTER(busno));
+    if (limiter != NULL) {
+        limiter->tokens = MIN(limiter->burst, limiter->tokens + 1.0);
+    }
+    g_mutex_unlock(&rate_limit_mutex);
+}
+
+/**
+ * @brief Wait for a token for a display's bus.
+ *
+ * Must not be called from the GMainLoop, unless rate_limit_try_acquire() has just succeeded.
+ *
+ * @param dinfo the display, as already looked up by the caller
+ * @param is_write TRUE for a write, writes are served before reads
+ * @return the I2C bus number, or -1 if the display isn't on an I2C bus
+ */
+static int rate_limit_acquire(const DDCA_Display_Info* dinfo, const gboolean is_write) {
+    if (dinfo->path.io_mode != DDCA_IO_I2C) {  // USB VDUs aren't affected
+        return -1;
+    }
+    const int busno = dinfo->path.path.i2c_busno;
+    const gboolean prepaid = GPOINTER_TO_INT(g_private_get(&rate_limit_prepaid)) == busno + 1;
+    if (prepaid) {
+        g_private_set(&rate_limit_prepaid, NULL);
+    }
+    g_mutex_lock(&rate_limit_mutex);
+    Bus_Limiter* limiter = bus_limiter_get(dinfo);
+    if (limiter->rate > 0.0 && !prepaid) {
+        const long start_micros = g_get_monotonic_time();
+        guint* waiting = is_write ? &limiter->waiting_writes : &limiter->waiting_reads;
+        (*waiting)++;
+        while (TRUE) {
+            const long now = g_get_monotonic_time();
+            bus_limiter_refill(limiter, now);
+            if (limiter->tokens >= 1.0 && (is_write || limiter->waiting_writes == 0)) {
+                break;
+            }
+            // Wait for the deficit to refill, or for a waiting write to be served.
+            const double deficit = MAX(1.0 - limiter->tokens, 0.0);
+            const long wait_micros = MAX((long) (deficit * 1000000.0 / limiter->rate), 1000);
+            g_cond_wait_until(&rate_limit_cond, &rate_limit_mutex, now + wait_micros);
+        }
+        (*waiting)--;
+        limiter->tokens -= 1.0;
+        const guint64 waited_micros = g_get_monotonic_time() - start_micros;
+        if (waited_micros >= 1000) {
+            limiter->delayed_count++;
+            limiter->total_wait_micros += waited_micros;
+            limiter->max_wait_micros = MAX(limiter->max_wait_micros, waited_micros);
+        }
+        g_cond_broadcast(&rate_limit_cond);  // Reads held back by this write can re-check
+    }
+    if (is_write) {
+        limiter->granted_writes++;
+    }
+    else {
+        limiter->granted_reads++;
+    }
+    g_mutex_unlock(&rate_limit_mutex);
+    return busno;
+}
+
+static int get_display_busno(const DDCA_Display_Info* vdu_info) {
+    return vdu_info->path.io_mode == DDCA_IO_I2C ? vdu_info->path.path.i2c_busno : -1;
+}
+
+static DDCA_Status i2c_open_display(const DDCA_Display_Info* vdu_info, DDCA_Display_Handle* disp_handle) {
+    const long start_micros = g_get_monotonic_time();
+    const DDCA_Status status = backend->open_display2(vdu_info->dref, 1, disp_handle);
+    const int busno = get_display_busno(vdu_info);
+    latency_record_display(busno, "open", start_micros);
+    metrics_record_ddc(busno, status);
+    trace_record(TRACE_I2C, NULL, "open", busno, 0, status, start_micros);
+    USDT_PROBE(ddc__open, "open", busno, 0, status, g_get_monotonic_time() - start_micros);
+    trace_note_status(status);
+    return status;
+}
+
+static DDCA_Status i2c_read_non_table_vcp_value(DDCA_Display_Handle disp_handle, const DDCA_Display_Info* vdu_info,
+                                                const uint8_t vcp_code, DDCA_Non_Table_Vcp_Value* valrec,
+                                                const char* phase) {
+    const int busno = rate_limit_acquire(vdu_info, FALSE);
+    const long start_micros = g_get_monotonic_time();
+    const DDCA_Status status = backend->get_non_table_vcp_value(disp_handle, vcp_code, valrec);
+    latency_record_display(busno, phase, start_micros);
+    metrics_record_ddc(busno, status);
+    trace_record(TRACE_I2C, NULL, phase, busno, vcp_code, status, start_micros);
+    USDT_PROBE(ddc__get_vcp, phase, busno, vcp_code, status, g_get_monotonic_time() - start_micros);
+    trace_note_status(status);
+    return status;
+}
+
+static DDCA_Status i2c_get_non_table_vcp_value(DDCA_Display_Handle disp_handle, const DDCA_Display_Info* vdu_info,
+                                               const uint8_t vcp_code, DDCA_Non_Table_Vcp_Value* valrec) {
+    return i2c_read_non_table_vcp_value(disp_handle, vdu_info, vcp_code, valrec, "read");
+}
+
+static DDCA_Status i2c_set_non_table_vcp_value(DDCA_Display_Handle disp_handle, const DDCA_Display_Info* vdu_info,
+                                               const uint8_t vcp_code,
+                                               const uint8_t high_byte, const uint8_t low_byte) {
+    const int busno = rate_limit_acquire(vdu_info, TRUE);
+    const long start_micros = g_get_monotonic_time();
+    const DDCA_Status status = backend->set_non_table_vcp_value(disp_handle, vcp_code, high_byte, low_byte);
+    latency_record_display(busno, "write", start_micros);
+    metrics_record_ddc(busno, status);
+    trace_record(TRACE_I2C, NULL, "write", busno, vcp_code, status, start_micros);
+    USDT_PROBE(ddc__set_vcp, "write", busno, vcp_code, status, g_get_monotonic_time() - start_micros);
+    trace_note_status(status);
+    return status;
+}
+
+static DDCA_Status i2c_get_capabilities_string(DDCA_Display_Handle disp_handle, const DDCA_Display_Info* vdu_info,
+                                               char** caps_text) {
+    const int busno = rate_limit_acquire(vdu_info, FALSE);
+    const long start_micros = g_get_monotonic_time();
+    const DDCA_Status status = backend->get_capabilities_string(disp_handle, caps_text);
+    latency_record_display(busno, "caps", start_micros);
+    metrics_record_ddc(busno, status);
+    trace_record(TRACE_I2C, NULL, "caps", busno, 0, status, start_micros);
+    USDT_PROBE(ddc__caps, "caps", busno, 0, status, g_get_monotonic_time() - start_micros);
+    trace_note_status(status);
+    return status;
+}
+
+static DDCA_Status i2c_get_feature_metadata_by_dh(DDCA_Display_Handle disp_handle, const DDCA_Display_Info* vdu_info,
+                                                  const uint8_t vcp_code, const bool create_default_if_not_found,
+                                                  DDCA_Feature_Metadata** metadata_loc) {
+    gboolean first_lookup = FALSE;  // Only the first lookup may read the VCP version
+    if (vdu_info->path.io_mode == DDCA_IO_I2C) {
+        g_mutex_lock(&rate_limit_mutex);
+        Bus_Limiter* limiter = bus_limiter_get(vdu_info);
+        first_lookup = limiter->version_dref != vdu_info->dref;
+        limiter->version_dref = vdu_info->dref;
+        g_mutex_unlock(&rate_limit_mutex);
+    }
+    if (first_lookup) {
+        const int busno = rate_limit_acquire(vdu_info, FALSE);
+        const long start_micros = g_get_monotonic_time();
+        const DDCA_Status status = backend->get_feature_metadata_by_dh(vcp_code, disp_handle,
+                                                                       create_default_if_not_found, metadata_loc);
+        latency_record_display(busno, "metadata", start_micros);
+        metrics_record_ddc(busno, status);
+        trace_record(TRACE_I2C, NULL, "metadata", busno, vcp_code, status, start_micros);
+        trace_note_status(status);
+        return status;
+    }
+    return backend->get_feature_metadata_by_dh(vcp_code, disp_handle, create_default_if_not_found, metadata_loc);
+}
+
+/**
+ * @brief Build the per-bus rate limiter statistics for the ServiceStatistics property.
+ * @return a{i(duuttttt)} busno -> (rate, waiting writes, waiting reads, granted writes, granted reads,
+ *         delayed, total wait, max wait)
+ */
+static GVariant* get_rate_limit_statistics(void) {
+    GVariantBuilder builder_instance;
+    GVariantBuilder* builder = &builder_instance;
+    g_variant_builder_init(builder, G_VARIANT_TYPE("a{i(duuttttt)}"));
+    g_mutex_lock(&rate_limit_mutex);
+    if (bus_limiter_table != NULL) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, bus_limiter_table);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            const Bus_Limiter* limiter = value;
+            g_variant_builder_add(builder, "{i(duuttttt)}", limiter->busno, limiter->rate,
+                                  limiter->waiting_writes, limiter->waiting_reads,
+                                  limiter->granted_writes, limiter->granted_reads, limiter->delayed_count,
+                                  limiter->total_wait_micros, limiter->max_wait_micros);
+        }
+    }
+    g_mutex_unlock(&rate_limit_mutex);
+    return g_variant_builder_end(builder);
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * Display I/O statistics
+ *
+ * GetDisplayIoStats reports what the service measures itself for a display: the time in each kind of
+ * libddcutil call, the time held back by I2C rate limiting, and the current effective sleep multiplier.
+ * GetServiceStats includes the same for every display.
+ *
+ * The call times include libddcutil's retries and the sleeps mandated by the DDC/CI spec, they can't be
+ * split per display.  libddcutil keeps retry counts by operation type and sleep totals, but only exposes
+ * them as a text report for all displays, in a format it doesn't guarantee.  The report is passed on
+ * verbatim for a person to read, it isn't parsed into per-display fields.
+ */
+
+/**
+ * @brief Capture libddcutil's statistics report by redirecting its (per-thread) output stream.
+ * @return the report text, free with g_free
+ */
+static gchar* get_libddcutil_stats_report(void) {
+    char* buffer = NULL;
+    size_t size = 0;
+    FILE* stream = open_memstream(&buffer, &size);
+    if (stream == NULL) {
+        g_warning("Failed to capture libddcutil statistics: %s", g_strerror(errno));
+        return g_strdup("");
+    }
+    ddca_set_fout(stream);
+    ddca_show_stats(DDCA_STATS_ALL, TRUE, 0);
+    ddca_set_fout_to_default();
+    fclose(stream);
+    gchar* report = g_strdup(buffer);
+    free(buffer);
+    return report;
+}
+
+/**
+ * @brief Get the sleep multiplier currently in effect for a display, including any dynamic sleep adjustment.
+ * @param vdu_info the display
+ * @return the multiplier, zero if libddcutil cannot report it
+ */
+static double get_effective_sleep_multiplier(const DDCA_Display_Info* vdu_info) {
+    double multiplier = 0.0;
+#if defined(LIBDDCUTIL_HAS_INDIVIDUAL_SLEEP_MULTIPLIER)
+    if (backend->get_current_display_sleep_multiplier(vdu_info->dref, &multiplier) != DDCRC_OK) {
+        multiplier = 0.0;
+    }
+#elif defined(LIBDDCUTIL_HAS_DDCA_GET_SLEEP_MULTIPLIER)
+    multiplier = ddca_get_sleep_multiplier();
+#elif defined(LIBDDCUTIL_HAS_DDCA_GET_DEFAULT_SLEEP_MULTIPLIER)
+    multiplier = ddca_get_default_sleep_multiplier();
+#endif
+    return multiplier;
+}
+
+/**
+ * @brief Build the service measured time in each kind of libddcutil call for an I2C display.
+ * @param busno the display's I2C bus number, negative if not an I2C display (nothing measured)
+ * @return a(sttt) of (phase, count, sum_micros, max_micros)
+ */
+static GVariant* get_display_io_phases(const int busno) {
+    GVariantBuilder builder_instance;
+    GVariantBuilder* builder = &builder_instance;
+    g_variant_builder_init(builder, G_VARIANT_TYPE("a(sttt)"));
+    if (busno >= 0) {
+        char name[32];
+        g_snprintf(name, sizeof(name), "/dev/i2c-%d", busno);
+        g_mutex_lock(&latency_mutex);
+        if (latency_table != NULL) {
+            GHashTableIter iter;
+            gpointer value;
+            g_hash_table_iter_init(&iter, latency_table);
+            while (g_hash_table_iter_next(&iter, NULL, &value)) {
+                const Latency_Histogram* histogram = value;
+                if (g_strcmp0(histogram->kind, "display") == 0 && g_strcmp0(histogram->name, name) == 0) {
+                    g_variant_builder_add(builder, "(sttt)", histogram->phase, histogram->count,
+                                          histogram->sum_micros, histogram->max_micros);
+                }
+            }
+        }
+        g_mutex_unlock(&latency_mutex);
+    }
+    return g_variant_builder_end(builder);
+}
+
+/**
+ * @brief Get the total time a display's transactions have waited for the I2C rate limiter.
+ * @param busno the display's I2C bus number, negative if not an I2C display
+ * @return microseconds waited, zero if never limited
+ */
+static guint64 get_display_rate_limit_wait(const int busno) {
+    guint64 wait_micros = 0;
+    g_mutex_lock(&rate_limit_mutex);
+    if (bus_limiter_table != NULL) {
+        const Bus_Limiter* limiter = g_hash_table_lookup(bus_limiter_table, GINT_TO_POINTER(busno));
+        if (limiter != NULL) {
+            wait_micros = limiter->total_wait_micros;
+        }
+    }
+    g_mutex_unlock(&rate_limit_mutex);
+    return wait_micros;
+}
+
+/**
+ * @brief Implements D-Bus method GetDisplayIoStats.
+ * @param parameters inbound parameters
+ * @param invocation D-Bus method call
+ */
+static void get_display_io_stats(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    int display_number;
+    char* edid_encoded;
+    u_int32_t flags;
+
+    g_variant_get(parameters, "(isu)", &display_number, &edid_encoded, &flags);
+
+    g_info("GetDisplayIoStats display_num=%d, edid=%.30s...", display_number, edid_encoded);
+
+    double multiplier = 0.0;
+    int busno = -1;
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    const DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info,
+                                                flags & EDID_PREFIX);
+    if (status == DDCRC_OK) {
+        multiplier = get_effective_sleep_multiplier(vdu_info);
+        busno = get_display_busno(vdu_info);
+    }
+    backend->free_display_info_list(info_list);
+
+    gchar* report = status == DDCRC_OK ? get_libddcutil_stats_report() : g_strdup("");
+    char* message_text = get_status_message(status);
+    GVariant* result = g_variant_new("(d@a(sttt)tsis)", multiplier, get_display_io_phases(busno),
+                                     get_display_rate_limit_wait(busno), report, status, message_text);
+    g_dbus_method_invocation_return_value(invocation, result);
+    g_free(report);
+    free(edid_encoded);
+    free(message_text);
+}
+
+/**
+ * @brief Build the service measured I/O statistics of every display for GetServiceStats.
+ * @return a(isdta(sttt)) of (display_number, device, sleep_multiplier, rate_limit_wait_micros, phases)
+ */
+static GVariant* get_display_io_statistics(void) {
+    GVariantBuilder builder_instance;
+    GVariantBuilder* builder = &builder_instance;
+    g_variant_builder_init(builder, G_VARIANT_TYPE("a(isdta(sttt))"));
+    DDCA_Display_Info_List* info_list = NULL;
+    if (get_display_info_list(0, &info_list, "GetServiceStats") == DDCRC_OK) {
+        for (int i = 0; i < info_list->ct; i++) {
+            const DDCA_Display_Info* vdu_info = &info_list->info[i];
+            const int busno = get_display_busno(vdu_info);
+            char device[32];
+            if (busno >= 0) {
+                g_snprintf(device, sizeof(device), "/dev/i2c-%d", busno);
+            }
+            else {
+                g_strlcpy(device, "", sizeof(device));
+            }
+            g_variant_builder_add(builder, "(isdt@a(sttt))", vdu_info->dispno, device,
+                                  get_effective_sleep_multiplier(vdu_info), get_display_rate_limit_wait(busno),
+                                  get_display_io_phases(busno));
+        }
+    }
+    backend->free_display_info_list(info_list);
+    return g_variant_builder_end(builder);
+}
+
+/**
+ * @brief Implements D-Bus method GetServiceStats, returns the latency histograms and display I/O statistics.
+ * @param parameters inbound parameters
+ * @param invocation D-Bus method call
+ */
+static void get_service_stats(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    u_int32_t flags;
+    g_variant_get(parameters, "(u)", &flags);
+
+    g_info("GetServiceStats");
+
+    GVariantBuilder bounds_builder_instance;
+    GVariantBuilder* bounds_builder = &bounds_builder_instance;
+    g_variant_builder_init(bounds_builder, G_VARIANT_TYPE("at"));
+    for (int i = 0; i < G_N_ELEMENTS(latency_bucket_bounds_micros); i++) {
+        g_variant_builder_add(bounds_builder, "t", latency_bucket_bounds_micros[i]);
+    }
+
+    GVariantBuilder histograms_builder_instance;
+    GVariantBuilder* histograms_builder = &histograms_builder_instance;
+    g_variant_builder_init(histograms_builder, G_VARIANT_TYPE("a(ssstttat)"));
+    g_mutex_lock(&latency_mutex);
+    if (latency_table != NULL) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, latency_table);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            const Latency_Histogram* histogram = value;
+            GVariantBuilder buckets_builder_instance;
+            GVariantBuilder* buckets_builder = &buckets_builder_instance;
+            g_variant_builder_init(buckets_builder, G_VARIANT_TYPE("at"));
+            for (int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+                g_variant_builder_add(buckets_builder, "t", histogram->buckets[i]);
+            }
+            g_variant_builder_add(histograms_builder, "(ssstttat)", histogram->kind, histogram->name,
+                                  histogram->phase, histogram->count, histogram->sum_micros,
+                                  histogram->max_micros, buckets_builder);
+        }
+    }
+    g_mutex_unlock(&latency_mutex);
+
+    char* message_text = get_status_message(DDCRC_OK);
+    GVariant* result = g_variant_new("(ata(ssstttat)@a(isdta(sttt))is)", bounds_builder, histograms_builder,
+                                     get_display_io_statistics(), DDCRC_OK, message_text);
+    g_dbus_method_invocation_return_value(invocation, result);
+    free(message_text);
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * VCP value cache.
+ *
+ * The service remembers the last value it read or set for each (display, VCP-code) pair, along with a
+ * version number.  The version is bumped whenever the value is set, a read observes a different value,
+ * or the display is invalidated (hotplug, DPMS or detect).  Versions come from a single service wide
+ * counter, so a version number is never reused for the same display and code.
+ *
+ * Clients of the conditional get methods pass back the last version they saw.  If the version still
+ * matches and the cached value is younger than vcp_cache_max_age_micros, the service reports the value
+ * as not-modified without any DDC/I2C traffic.  Changes made via the VDU's on-screen-display can't be
+ * seen, so this is disabled unless the user opts in with a max age.
+ *
+ * The cache is keyed by base64 encoded EDID because display numbers may be reallocated.
+ */
+
+#define DEFAULT_VCP_CACHE_MAX_AGE_SECONDS 0.0  // Any non-zero default would be a guess
+
+/**
+ * How long a cached value can be trusted to still match the VDU (changes made via the VDU's
+ * on-screen-display cannot be seen by the service).  Zero disables not-modified replies.
+ */
+static long vcp_cache_max_age_micros = (long) (DEFAULT_VCP_CACHE_MAX_AGE_SECONDS * 1000000);
+
+typedef struct {
+    guint32 version;                  // Zero if the service has never seen a value
+    gboolean valid;                   // FALSE if never read, or invalidated by an event
+    gboolean is_simple_nc;            // Simple Non-Continuous, the high byte may be garbage
+    DDCA_Non_Table_Vcp_Value valrec;  // The raw value as returned by libddcutil
+    gchar* formatted_value;
+    long updated_micros;              // Monotonic time of the last read or set
+    long prefetched_micros;           // Non-zero if read by predictive prefetch and not yet used by a client
+    gboolean set_by_service;          // set_value was written by the service and no read has seen otherwise
+    uint16_t set_value;
+} Vcp_Cache_Entry;
+
+typedef struct {
+    Vcp_Cache_Entry entries[256];     // Indexed by VCP-code
+} Vcp_Cache;
+
+static GHashTable* vcp_cache_table = NULL;  // base64 EDID -> Vcp_Cache
+
+static GMutex vcp_cache_mutex;  // Statically allocated, needs no init.  Entries may be updated by Execute threads.
+
+static guint32 vcp_cache_version_counter = 0;
+
+#define PREFETCH_TTL_MICROS 2000000  // How long a predictively prefetched value may stand in for a live read
+
+static guint64 prefetch_hit_count = 0;  // Prefetched values used by clients, protected by vcp_cache_mutex
+static guint64 conditional_lookup_count = 0;  // Only counted when metrics_enabled, protected by vcp_cache_mutex
+static guint64 conditional_hit_count = 0;
+
+/**
+ * @brief validate and update the vcp_cache_max_age_micros
+ * @param secs
+ * @return TRUE if valid and succeeded
+ */
+static bool update_vcp_cache_max_age(const double secs) {
+    if (secs < 0.0) {
+        g_warning("Invalid VCP cache max age %5.3f, must be zero or more seconds", secs);
+        return FALSE;
+    }
+    if (secs == 0.0) {
+        g_message("ServiceVcpCacheMaxAge changed to zero, not-modified replies are now disabled.");
+    }
+    else {
+        g_message("ServiceVcpCacheMaxAge changed to %5.3f seconds", secs);
+    }
+    vcp_cache_max_age_micros = (long) (secs * 1000000);
+    return TRUE;
+}
+
+static void vcp_cache_free(gpointer data) {
+    Vcp_Cache* cache = data;
+    for (int i = 0; i < G_N_ELEMENTS(cache->entries); i++) {
+        g_free(cache->entries[i].formatted_value);
+    }
+    g_free(cache);
+}
+
+/**
+ * @brief Find the cache entry for a display's VCP-code, optionally creating it.
+ * @param edid_encoded the display's full base64 encoded EDID
+ * @param vcp_code the VCP-code
+ * @param create create the entry if it doesn't exist yet
+ * @return the entry, or NULL if not found and create is FALSE
+ */
+static Vcp_Cache_Entry* vcp_cache_lookup(const char* edid_encoded, const uint8_t vcp_code, const gboolean create) {
+    if (vcp_cache_table == NULL) {
+        if (!create) {
+            return NULL;
+        }
+        vcp_cache_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, vcp_cache_free);
+    }
+    Vcp_Cache* cache = g_hash_table_lookup(vcp_cache_table, edid_encoded);
+    if (cache == NULL) {
+        if (!create) {
+            return NULL;
+        }
+        cache = g_new0(Vcp_Cache, 1);
+        g_hash_table_insert(vcp_cache_table, g_strdup(edid_encoded), cache);
+    }
+    return &cache->entries[vcp_code];
+}
+
+/**
+ * @brief Record a value read from a VDU, bumping the version if it differs from the cached value.
+ * @param edid_encoded the display's full base64 encoded EDID
+ * @param vcp_code the VCP-code
+ * @param valrec the value returned from libddcutil
+ * @param is_simple_nc TRUE if the feature is Simple Non-Continuous
+ * @param formatted_value the value formatted by libddcutil
+ * @return the entry's version
+ */
+static guint32 vcp_cache_store(const char* edid_encoded, const uint8_t vcp_code,
+                               const DDCA_Non_Table_Vcp_Value* valrec, const gboolean is_simple_nc,
+                               const char* formatted_value) {
+    g_mutex_lock(&vcp_cache_mutex);
+    Vcp_Cache_Entry* entry = vcp_cache_lookup(edid_encoded, vcp_code, TRUE);
+    const gboolean changed = !entry->valid || entry->version == 0
+                             || memcmp(&entry->valrec, valrec, sizeof(DDCA_Non_Table_Vcp_Value)) != 0;
+    if (changed) {
+        entry->version = ++vcp_cache_version_counter;
+        entry->valrec = *valrec;
+        g_free(entry->formatted_value);
+        entry->formatted_value = g_strdup(formatted_value != NULL ? formatted_value : "");
+    }
+    const uint16_t mask = is_simple_nc ? 0x00ff : 0xffff;  // The high byte of an SNC value may be garbage
+    if (entry->set_by_service && ((valrec->sh << 8 | valrec->sl) & mask) != (entry->set_value & mask)) {
+        entry->set_by_service = FALSE;  // Changed by other means, for example, the VDU's own controls
+    }
+    entry->valid = TRUE;
+    entry->is_simple_nc = is_simple_nc;
+    entry->updated_micros = g_get_monotonic_time();
+    entry->prefetched_micros = 0;
+    const guint32 version = entry->version;
+    g_mutex_unlock(&vcp_cache_mutex);
+    return version;
+}
+
+/**
+ * @brief Record a value successfully set by the service, always bumps the version.
+ *
+ * The maximum value isn't known from a set, so the entry only remains valid if it was previously
+ * populated by a read.
+ *
+ * @param edid_encoded the display's full base64 encoded EDID
+ * @param dref the display's libddcutil reference (for reformatting the value)
+ * @param vcp_code the VCP-code
+ * @param new_value the value that was set
+ * @return the entry's new version
+ */
+static guint32 vcp_cache_store_set_value(const char* edid_encoded, DDCA_Display_Ref dref,
+                                         const uint8_t vcp_code, const uint16_t new_value) {
+    g_mutex_lock(&vcp_cache_mutex);
+    Vcp_Cache_Entry* entry = vcp_cache_lookup(edid_encoded, vcp_code, TRUE);
+    entry->version = ++vcp_cache_version_counter;
+    entry->prefetched_micros = 0;
+    entry->set_by_service = TRUE;
+    entry->set_value = new_value;
+    if (entry->valid) {
+        entry->valrec.sh = new_value >> 8;
+        entry->valrec.sl = new_value & 0x00ff;
+        char* formatted_value = NULL;
+        if (backend->format_non_table_vcp_value_by_dref(vcp_code, dref, &entry->valrec, &formatted_value) == DDCRC_OK) {
+            g_free(entry->formatted_value);
+            entry->formatted_value = g_strdup(formatted_value);
+            entry->updated_micros = g_get_monotonic_time();
+        }
+        else {
+            entry->valid = FALSE;
+        }
+        free(formatted_value);
+    }
+    const guint32 version = entry->version;
+    g_mutex_unlock(&vcp_cache_mutex);
+    return version;
+}
+
+/**
+ * @brief Whether a value was written by the service itself, rather than by other means such as the VDU's controls.
+ * @param edid_encoded the display's full base64 encoded EDID
+ * @param vcp_code the VCP-code
+ * @param value a value just read from the VDU
+ * @return TRUE if the service's most recent write set this value and no read has since seen a different one
+ */
+static gboolean vcp_cache_value_set_by_service(const char* edid_encoded, const uint8_t vcp_code, const uint16_t value) {
+    g_mutex_lock(&vcp_cache_mutex);
+    const Vcp_Cache_Entry* entry = vcp_cache_lookup(edid_encoded, vcp_code, FALSE);
+    const uint16_t mask = entry != NULL && entry->is_simple_nc ? 0x00ff : 0xffff;
+    const gboolean set_by_service = entry != NULL && entry->set_by_service
+                                    && (entry->set_value & mask) == (value & mask);
+    g_mutex_unlock(&vcp_cache_mutex);
+    return set_by_service;
+}
+
+/**
+ * @brief Invalidate all cached values for a display, bumping the version of any previously seen values.
+ * @param edid_encoded the display's full base64 encoded EDID, or NULL for all displays
+ */
+static void vcp_cache_invalidate(const char* edid_encoded) {
+    g_mutex_lock(&vcp_cache_mutex);
+    if (vcp_cache_table == NULL) {
+        g_mutex_unlock(&vcp_cache_mutex);
+        return;
+    }
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, vcp_cache_table);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        if (edid_encoded == NULL || strcmp(edid_encoded, key) == 0) {
+            Vcp_Cache* cache = value;
+            for (int i = 0; i < G_N_ELEMENTS(cache->entries); i++) {
+                Vcp_Cache_Entry* entry = &cache->entries[i];
+                if (entry->version != 0) {
+                    entry->version = ++vcp_cache_version_counter;
+                    entry->valid = FALSE;
+                    entry->prefetched_micros = 0;
+                }
+            }
+            if (g_log_get_debug_enabled()) {
+                g_debug("VCP cache invalidated edid=%.30s...", (char *) key);
+            }
+        }
+    }
+    g_mutex_unlock(&vcp_cache_mutex);
+}
+
+/**
+ * @brief Convert a raw libddcutil value to the 16 bit current and max values returned to clients.
+ * @param valrec the raw value
+ * @param is_simple_nc TRUE if the feature is Simple Non-Continuous
+ * @param flags method flags (checked for RETURN_RAW_VALUES)
+ * @param current_value output current value
+ * @param max_value output max value
+ */
+static void unpack_vcp_value(const DDCA_Non_Table_Vcp_Value* valrec, const gboolean is_simple_nc,
+                             const u_int32_t flags, uint16_t* current_value, uint16_t* max_value) {
+    // Override, return all bytes regardless
+    const bool return_all_bytes = return_raw_values || flags & RETURN_RAW_VALUES;
+    const bool low_byte_only = !return_all_bytes && is_simple_nc;
+    // For simple non-continuous types the high byte may be garbage for some models of VDU.
+    *current_value = low_byte_only ? valrec->sl : (valrec->sh << 8 | valrec->sl);
+    *max_value = low_byte_only ? valrec->ml : (valrec->mh << 8 | valrec->ml);
+}
+
+/**
+ * @brief Return a client's last seen value from the cache if the service can vouch that it's still current.
+ *
+ * The value is current if it cannot have been changed by the service or any event it has observed,
+ * and it was read or set within the last vcp_cache_max_age_micros.
+ *
+ * @param edid_encoded the display's full base64 encoded EDID
+ * @param vcp_code the VCP-code
+ * @param last_version the version last seen by the client, zero if none
+ * @param flags method flags (checked for RETURN_RAW_VALUES)
+ * @param current_value output current value
+ * @param max_value output max value
+ * @param formatted_value output g_malloced formatted value, may be NULL if not required
+ * @return TRUE if the value is unmodified and the outputs have been set
+ */
+static gboolean vcp_cache_get_unmodified(const char* edid_encoded, const uint8_t vcp_code,
+                                         const guint32 last_version, const u_int32_t flags,
+                                         uint16_t* current_value, uint16_t* max_value, char** formatted_value) {
+    g_mutex_lock(&vcp_cache_mutex);
+    const Vcp_Cache_Entry* entry = vcp_cache_lookup(edid_encoded, vcp_code, FALSE);
+    const gboolean unmodified = entry != NULL && last_version != 0 && entry->valid && entry->version == last_version
+                                && g_get_monotonic_time() - entry->updated_micros < vcp_cache_max_age_micros;
+    if (metrics_enabled) {
+        conditional_lookup_count++;
+        conditional_hit_count += unmodified ? 1 : 0;
+    }
+    if (unmodified) {
+        unpack_vcp_value(&entry->valrec, entry->is_simple_nc, flags, current_value, max_value);
+        if (formatted_value != NULL) {
+            *formatted_value = g_strdup(entry->formatted_value);
+        }
+    }
+    g_mutex_unlock(&vcp_cache_mutex);
+    return unmodified;
+}
+
+/**
+ * @brief Test whether a cached value is valid and younger than PREFETCH_TTL_MICROS.
+ * @param edid_encoded the display's full base64 encoded EDID
+ * @param vcp_code the VCP-code
+ * @return TRUE if fresh
+ */
+static gboolean vcp_cache_is_fresh(const char* edid_encoded, const uint8_t vcp_code) {
+    g_mutex_lock(&vcp_cache_mutex);
+    const Vcp_Cache_Entry* entry = vcp_cache_lookup(edid_encoded, vcp_code, FALSE);
+    const gboolean fresh = entry != NULL && entry->valid
+                           && g_get_monotonic_time() - entry->updated_micros < PREFETCH_TTL_MICROS;
+    g_mutex_unlock(&vcp_cache_mutex);
+    return fresh;
+}
+
+/**
+ * @brief Mark a freshly read value as predictively prefetched.
+ * @param edid_encoded the display's full base64 encoded EDID
+ * @param vcp_code the VCP-code
+ */
+static void vcp_cache_mark_prefetched(const char* edid_encoded, const uint8_t vcp_code) {
+    g_mutex_lock(&vcp_cache_mutex);
+    Vcp_Cache_Entry* entry = vcp_cache_lookup(edid_encoded, vcp_code, FALSE);
+    if (entry != NULL && entry->valid) {
+        entry->prefetched_micros = entry->updated_micros;
+    }
+    g_mutex_unlock(&vcp_cache_mutex);
+}
+
+/**
+ * @brief Use a predictively prefetched value in place of a live read, if one was read very recently.
+ *
+ * Each prefetched value is used at most once, after that, reads go to the VDU as usual.
+ *
+ * @param edid_encoded the display's full base64 encoded EDID
+ * @param vcp_code the VCP-code
+ * @param flags method flags (checked for RETURN_RAW_VALUES)
+ * @param current_value output current value
+ * @param max_value output max value
+ * @param formatted_value output g_malloced formatted value
+ * @return TRUE if a prefetched value was available and the outputs have been set
+ */
+static gboolean vcp_cache_take_prefetched(const char* edid_encoded, const uint8_t vcp_code, const u_int32_t flags,
+                                          uint16_t* current_value, uint16_t* max_value, char** formatted_value) {
+    g_mutex_lock(&vcp_cache_mutex);
+    Vcp_Cache_Entry* entry = vcp_cache_lookup(edid_encoded, vcp_code, FALSE);
+    const gboolean available = entry != NULL && entry->valid && entry->prefetched_micros != 0
+                               && g_get_monotonic_time() - entry->prefetched_micros < PREFETCH_TTL_MICROS;
+    if (available) {
+        unpack_vcp_value(&entry->valrec, entry->is_simple_nc, flags, current_value, max_value);
+        *formatted_value = g_strdup(entry->formatted_value);
+        entry->prefetched_micros = 0;
+        prefetch_hit_count++;
+    }
+    g_mutex_unlock(&vcp_cache_mutex);
+    return available;
+}
+
+/**
+ * @brief Return the last value read from a VDU, however old, along with its age.
+ *
+ * Unlike vcp_cache_get_unmodified, invalidated entries are returned, the caller reports them as stale.
+ *
+ * @param edid_encoded the display's full base64 encoded EDID
+ * @param vcp_code the VCP-code
+ * @param flags method flags (checked for RETURN_RAW_VALUES)
+ * @param current_value output current value
+ * @param max_value output max value
+ * @param formatted_value output g_malloced formatted value
+ * @param age_micros output time since the value was read or set
+ * @return TRUE if the value has been read at some time and the outputs have been set
+ */
+static gboolean vcp_cache_get_last_known(const char* edid_encoded, const uint8_t vcp_code, const u_int32_t flags,
+                                         uint16_t* current_value, uint16_t* max_value, char** formatted_value,
+                                         long* age_micros) {
+    g_mutex_lock(&vcp_cache_mutex);
+    const Vcp_Cache_Entry* entry = vcp_cache_lookup(edid_encoded, vcp_code, FALSE);
+    const gboolean known = entry != NULL && entry->formatted_value != NULL;  // Only set by reads
+    if (known) {
+        unpack_vcp_value(&entry->valrec, entry->is_simple_nc, flags, current_value, max_value);
+        *formatted_value = g_strdup(entry->formatted_value);
+        *age_micros = g_get_monotonic_time() - entry->updated_micros;
+    }
+    g_mutex_unlock(&vcp_cache_mutex);
+    return known;
+}
+
+/**
+ * @brief Read a VCP value from an open display, format it, and record it in the VCP value cache.
+ * @param disp_handle open display handle
+ * @param vdu_info the display's info
+ * @param vcp_code the VCP-code to read
+ * @param flags method flags (checked for RETURN_RAW_VALUES)
+ * @param current_value output current value
+ * @param max_value output max value
+ * @param formatted_value output g_malloced formatted value, NULL on failure
+ * @param version output cache version, may be NULL
+ * @return DDCRC_OK if successful
+ */
+static DDCA_Status read_vcp_value(DDCA_Display_Handle disp_handle, const DDCA_Display_Info* vdu_info,
+                                  const uint8_t vcp_code, const u_int32_t flags,
+                                  uint16_t* current_value, uint16_t* max_value, char** formatted_value,
+                                  guint32* version) {
+    *formatted_value = NULL;
+    DDCA_Non_Table_Vcp_Value valrec;
+    DDCA_Status status = i2c_get_non_table_vcp_value(disp_handle, vdu_info, vcp_code, &valrec);
+    if (status == DDCRC_OK) {
+        DDCA_Feature_Metadata* metadata_ptr;
+        status = i2c_get_feature_metadata_by_dh(disp_handle, vdu_info, vcp_code, true, &metadata_ptr);
+        if (status == DDCRC_OK) {
+            const gboolean is_simple_nc = (DDCA_SIMPLE_NC & metadata_ptr->feature_flags) != 0;
+            ddca_free_feature_metadata(metadata_ptr);
+            unpack_vcp_value(&valrec, is_simple_nc, flags, current_value, max_value);
+            char* ddca_formatted_value = NULL;
+            status = backend->format_non_table_vcp_value_by_dref(vcp_code, vdu_info->dref, &valrec,
+                                                                 &ddca_formatted_value);
+            if (status == DDCRC_OK) {
+                *formatted_value = g_strdup(ddca_formatted_value);
+                gchar* edid_encoded = edid_encode(vdu_info->edid_bytes);
+                const guint32 new_version =
+                    vcp_cache_store(edid_encoded, vcp_code, &valrec, is_simple_nc, ddca_formatted_value);
+                if (version != NULL) {
+                    *version = new_version;
+                }
+                g_free(edid_encoded);
+            }
+            free(ddca_formatted_value);
+        }
+        else {
+            g_info("metadata lookup failed for vcp_code=%d display_num=%d", vcp_code, vdu_info->dispno);
+        }
+    }
+    return status;
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * Request scheduling - worker threads, fair queueing, and single-flight deduplication
+ *
+ * Methods that perform per-display DDC/I2C transactions are run on a small set of worker threads
+ * rather than on the GMainLoop.  Calls are queued per D-Bus sender and the workers serve the senders
+ * round-robin, so a client that polls heavily cannot starve an interactive one.  Calls passing the
+ * PRIORITY flag are queued separately and served before any others.  Each sender may have at most
+ * scheduler_max_queue_depth calls waiting, further calls are shed with a QueueFull error.  A sender's
+ * next call doesn't start until its previous one has finished, so a client's calls, for example, a
+ * SetVcp followed by a GetVcp, take effect in the order they were made.
+ *
+ * Queued calls are discarded, without touching the DDC/I2C bus, if their caller has disconnected from
+ * the bus (tracked via NameOwnerChanged) or if the deadline passed in the upper bits of their flags
+ * has passed.  Otherwise, a sleeping VDU can accumulate a backlog of work nobody is waiting for.
+ *
+ * While a read is in flight, any identical request (same method and parameters) attaches to it as a
+ * follower and receives the same reply, so a burst of identical requests, for example, from several
+ * applets starting at login, results in only one DDC/I2C transaction.
+ *
+ * A call that works on several displays, such as Execute, is queued as a group of per-display tasks.
+ * The group is queued or shed as a whole, and is replied to when its last task finishes.  The tasks
+ * of a group may run concurrently, they are one call.
+ *
+ * Redetecting displays invalidates display references, so it is queued as a barrier job.  Once a
+ * barrier reaches the front, no further jobs start until the workers have drained, then the barrier
+ * runs alone holding display_refs_lock for writing.  Other jobs hold the lock for reading, as does
+ * the GMainLoop while it handles method calls and signals, so the GMainLoop never waits on a worker
+ * job, only on a redetect that has already started.
+ */
+
+#define WORKER_THREAD_COUNT 4
+#define DEFAULT_SCHEDULER_MAX_QUEUE_DEPTH 16
+#define INFLIGHT_KEY_DATA "ddcutil-service-inflight-key"
+#define REPLY_CLAIM_DATA "ddcutil-service-reply-claim"
+
+typedef void (*Scheduled_Method_Func)(GVariant* parameters, GDBusMethodInvocation* invocation);
+
+typedef enum {
+    TASK_GROUP_ACTIVE = 0,
+    TASK_GROUP_ORPHANED = 1,      // The caller has disconnected, remaining tasks are skipped
+    TASK_GROUP_EXPIRED = 2,       // The caller's deadline has passed, remaining tasks are skipped
+} Task_Group_State_Type;
+
+typedef struct Task_Group Task_Group;
+typedef void (*Task_Func)(Task_Group* group, gpointer task);
+typedef void (*Task_Group_Finish_Func)(Task_Group* group);
+
+/**
+ * A method call whose per-display work is queued as several tasks, so that the displays are served
+ * by the workers concurrently.  finish_func runs on the worker that completes the last task, it must
+ * reply to the invocation, unless the group was discarded, in which case the invocation has already
+ * been answered with a Discarded error and is NULL.
+ */
+struct Task_Group {
+    GDBusMethodInvocation* invocation;
+    gpointer data;                // The method's state, freed by finish_func
+    Task_Func task_func;
+    Task_Group_Finish_Func finish_func;
+    gint remaining;               // Atomic, tasks not yet finished
+    gint state;                   // Atomic, Task_Group_State_Type
+};
+
+/**
+ * A D-Bus sender's queues and statistics.
+ */
+typedef struct {
+    gchar* sender;
+    GQueue priority_queue;        // of Scheduled_Job*
+    GQueue normal_queue;          // of Scheduled_Job*
+    guint64 served_count;
+    guint64 shed_count;
+    guint64 total_wait_micros;
+    guint64 max_wait_micros;
+    guint running_count;          // Jobs taken by workers but not yet finished
+    Task_Group* running_group;    // The group of the running jobs, NULL if none or not a group
+    gboolean disconnected;        // The sender has left the bus, free once idle
+} Sender_Queues;
+
+typedef struct {
+    Scheduled_Method_Func func;
+    GDBusMethodInvocation* invocation;  // NULL for background jobs
+    GVariant* parameters;               // Background jobs only
+    Sender_Queues* sender_queues;       // NULL for background jobs
+    Task_Group* group;                  // Task jobs only, func is unused
+    gpointer task;                      // Task jobs only
+    gboolean barrier;                   // Runs alone, holding display_refs_lock for writing
+    long enqueued_micros;
+    long deadline_micros;         // Zero for none
+} Scheduled_Job;
+
+static int scheduler_max_queue_depth = DEFAULT_SCHEDULER_MAX_QUEUE_DEPTH;
+
+static GHashTable* sender_queues_table = NULL;  // sender -> Sender_Queues
+static GQueue priority_ring = G_QUEUE_INIT;     // Senders with priority jobs waiting, in round-robin order
+static GQueue normal_ring = G_QUEUE_INIT;       // Senders with normal jobs waiting, in round-robin order
+static GQueue background_queue = G_QUEUE_INIT;  // Service initiated jobs, served when no client is waiting
+static int background_running_count = 0;
+static int running_job_count = 0;               // Jobs of all kinds taken by workers but not yet finished
+static gboolean barrier_running = FALSE;
+static GMutex scheduler_mutex;                  // Protects all of the above
+static GCond scheduler_cond;
+static GThread* worker_threads[WORKER_THREAD_COUNT];
+static guint64 expired_discard_count = 0;
+static guint64 orphaned_discard_count = 0;
+
+static GRWLock display_refs_lock;  // Statically allocated, needs no init.
+
+static GHashTable* inflight_read_table = NULL;  // request key -> GPtrArray of follower invocations
+static GMutex inflight_read_mutex;              // Protects the table and the statistics below
+
+static guint64 read_request_count = 0;
+static guint64 read_dedup_hit_count = 0;
+
+/**
+ * @brief Reply to a read request and to any identical requests that attached to it while it was in flight.
+ *
+ * Read method implementations must use this in place of g_dbus_method_invocation_return_value.
+ *
+ * @param invocation the leading D-Bus method call
+ * @param result the result, if floating it is consumed
+ */
+static void return_read_result(GDBusMethodInvocation* invocation, GVariant* result) {
+    g_variant_ref_sink(result);
+    GPtrArray* followers = NULL;
+    gchar* key = g_object_steal_data(G_OBJECT(invocation), INFLIGHT_KEY_DATA);
+    if (key != NULL) {
+        g_mutex_lock(&inflight_read_mutex);
+        followers = g_hash_table_lookup(inflight_read_table, key);
+        g_hash_table_remove(inflight_read_table, key);  // Frees the table's copy of the key only
+        g_mutex_unlock(&inflight_read_mutex);
+        g_free(key);
+    }
+    g_dbus_method_invocation_return_value(invocation, result);
+    if (followers != NULL) {
+        for (int i = 0; i < followers->len; i++) {
+            g_dbus_method_invocation_return_value(g_ptr_array_index(followers, i), result);
+        }
+        g_ptr_array_free(followers, TRUE);
+    }
+    g_variant_unref(result);
+}
+
+/**
+ * Attached to an invocation that may be replied to by more than one party, for example, by a
+ * budget timer or by the live read that it raced against.
+ */
+typedef struct {
+    gint claimed;  // Atomic
+} Reply_Claim;
+
+/**
+ * @brief Claim the right to reply to an invocation.
+ *
+ * Each party that might reply to a shared invocation holds its own reference to it.  The winner
+ * replies, consuming its reference, the losers must just unref theirs.
+ *
+ * @param invocation the D-Bus method call
+ * @return TRUE if the caller may reply, FALSE if another party has already replied
+ */
+static gboolean claim_reply(GDBusMethodInvocation* invocation) {
+    Reply_Claim* claim = g_object_get_data(G_OBJECT(invocation), REPLY_CLAIM_DATA);
+    return claim == NULL || g_atomic_int_compare_and_exchange(&claim->claimed, 0, 1);
+}
+
+/**
+ * @brief Test whether a barrier job may start, if not, no other job may start either.  Requires scheduler_mutex.
+ * @param job the next job
+ * @return TRUE if the job isn't a barrier, or is and the workers have drained
+ */
+static gboolean barrier_may_start(const Scheduled_Job* job) {
+    return !job->barrier || running_job_count == 0;
+}
+
+/**
+ * @brief Take the next job, serving priority jobs first, and senders round-robin.  Requires scheduler_mutex.
+ *
+ * A sender whose previous call is still running is passed over, keeping its place in the round-robin,
+ * unless its next job is another task of the running group.  A service initiated barrier, such as the
+ * internal poll's redetect, is served before clients so that hotplug detection can't be held off.
+ *
+ * @return the job, or NULL if none can start
+ */
+static Scheduled_Job* scheduler_next_job(void) {
+    if (barrier_running) {
+        return NULL;
+    }
+    const Scheduled_Job* background_next = g_queue_peek_head(&background_queue);
+    if (background_next != NULL && background_next->barrier) {
+        if (!barrier_may_start(background_next)) {
+            return NULL;  // Draining
+        }
+        background_running_count++;
+        running_job_count++;
+        barrier_running = TRUE;
+        return g_queue_pop_head(&background_queue);
+    }
+    GQueue* rings[] = { &priority_ring, &normal_ring };
+    for (int i = 0; i < G_N_ELEMENTS(rings); i++) {
+        GQueue* ring = rings[i];
+        for (GList* link = ring->head; link != NULL; link = link->next) {
+            Sender_Queues* sender_queues = link->data;
+            GQueue* queue = ring == &priority_ring ? &sender_queues->priority_queue : &sender_queues->normal_queue;
+            const Scheduled_Job* next = g_queue_peek_head(queue);
+            if (sender_queues->running_count > 0
+                && (next->group == NULL || next->group != sender_queues->running_group)) {
+                continue;  // Started when its running call finishes
+            }
+            if (!barrier_may_start(next)) {
+                return NULL;  // Draining
+            }
+            Scheduled_Job* job = g_queue_pop_head(queue);
+            g_queue_delete_link(ring, link);
+            if (!g_queue_is_empty(queue)) {
+                g_queue_push_tail(ring, sender_queues);  // Back of the line for its next job
+            }
+            const guint64 wait_micros = g_get_monotonic_time() - job->enqueued_micros;
+            sender_queues->served_count++;
+            sender_queues->running_count++;
+            sender_queues->running_group = job->group;
+            sender_queues->total_wait_micros += wait_micros;
+            sender_queues->max_wait_micros = MAX(sender_queues->max_wait_micros, wait_micros);
+            running_job_count++;
+            barrier_running = job->barrier;
+            return job;
+        }
+    }
+    // Background jobs may not occupy every worker, one is always kept free for clients.
+    if (background_running_count < WORKER_THREAD_COUNT - 1 && background_next != NULL) {
+        background_running_count++;
+        running_job_count++;
+        return g_queue_pop_head(&background_queue);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Free a disconnected sender's queues once it has no jobs queued or running.  Requires scheduler_mutex.
+ * @param sender_queues the sender's queues
+ */
+static void sender_queues_free_if_finished(Sender_Queues* sender_queues) {
+    if (sender_queues->disconnected && sender_queues->running_count == 0
+        && g_queue_is_empty(&sender_queues->priority_queue) && g_queue_is_empty(&sender_queues->normal_queue)) {
+        g_hash_table_remove(sender_queues_table, sender_queues->sender);
+        g_free(sender_queues->sender);
+        g_free(sender_queues);
+    }
+}
+
+/**
+ * @brief Retire a job's in-flight read entry so that the job can be discarded.
+ *
+ * A job that has identical read requests attached to it can't be discarded, because those
+ * callers are still waiting on its reply.
+ *
+ * @param invocation the job's D-Bus method call
+ * @return TRUE if nothing depends on the job, FALSE if other callers are waiting on it
+ */
+static gboolean inflight_read_retire(GDBusMethodInvocation* invocation) {
+    gboolean retired = TRUE;
+    const gchar* key = g_object_get_data(G_OBJECT(invocation), INFLIGHT_KEY_DATA);
+    if (key != NULL) {
+        g_mutex_lock(&inflight_read_mutex);
+        GPtrArray* followers = g_hash_table_lookup(inflight_read_table, key);
+        if (followers != NULL && followers->len > 0) {
+            retired = FALSE;
+        }
+        else {
+            g_hash_table_remove(inflight_read_table, key);
+            if (followers != NULL) {
+                g_ptr_array_free(followers, TRUE);
+            }
+        }
+        g_mutex_unlock(&inflight_read_mutex);
+    }
+    return retired;
+}
+
+/**
+ * @brief Discard a job whose caller has gone or whose deadline has passed, unless other callers are waiting on it.
+ * @param job the job
+ * @param orphaned TRUE if the caller has disconnected from the bus
+ * @return TRUE if discarded, FALSE if the job must still be run
+ */
+static gboolean discard_job_if_dead(const Scheduled_Job* job, const gboolean orphaned) {
+    if (job->invocation == NULL) {  // Background job
+        return FALSE;
+    }
+    const gboolean expired = job->deadline_micros != 0 && g_get_monotonic_time() > job->deadline_micros;
+    if (!(orphaned || expired) || !inflight_read_retire(job->invocation)) {
+        return FALSE;
+    }
+    if (!claim_reply(job->invocation)) {  // Already answered, for example, from the cache by a budget timer
+        g_object_unref(job->invocation);
+        return TRUE;
+    }
+    const gchar* method_name = g_dbus_method_invocation_get_method_name(job->invocation);
+    const gchar* sender = job->sender_queues->sender;
+    g_mutex_lock(&scheduler_mutex);
+    if (orphaned) {
+        orphaned_discard_count++;
+    }
+    else {
+        expired_discard_count++;
+    }
+    g_mutex_unlock(&scheduler_mutex);
+    g_info("%s discarded, %s", method_name, orphaned ? "caller has disconnected" : "deadline has passed");
+    // Replying frees the invocation, the bus will drop the reply if the caller has gone.
+    g_dbus_method_invocation_return_error(job->invocation, service_error_quark, DDCUTIL_SERVICE_DISCARDED,
+                                          orphaned ? "Caller %s has disconnected" : "Deadline for %s has passed",
+                                          orphaned ? sender : method_name);
+    return TRUE;
+}
+
+/**
+ * @brief Decide whether a task may run, marking its group discarded if its caller has gone or its deadline has passed.
+ * @param job the task's job
+ * @param orphaned TRUE if the caller has disconnected from the bus
+ * @return TRUE if the task should run
+ */
+static gboolean task_group_admit(const Scheduled_Job* job, const gboolean orphaned) {
+    Task_Group* group = job->group;
+    const gboolean expired = job->deadline_micros != 0 && g_get_monotonic_time() > job->deadline_micros;
+    if ((orphaned || expired)
+        && g_atomic_int_compare_and_exchange(&group->state, TASK_GROUP_ACTIVE,
+                                             orphaned ? TASK_GROUP_ORPHANED : TASK_GROUP_EXPIRED)) {
+        g_mutex_lock(&scheduler_mutex);
+        if (orphaned) {
+            orphaned_discard_count++;
+        }
+        else {
+            expired_discard_count++;
+        }
+        g_mutex_unlock(&scheduler_mutex);
+        g_info("%s discarded, %s", g_dbus_method_invocation_get_method_name(group->invocation),
+               orphaned ? "caller has disconnected" : "deadline has passed");
+    }
+    return g_atomic_int_get(&group->state) == TASK_GROUP_ACTIVE;
+}
+
+/**
+ * @brief Answer a call belonging to a discarded task group with a Discarded error.
+ *
+ * Used for the group's invocation, and by finish functions for any further calls they hold.
+ *
+ * @param group the discarded group
+ * @param invocation the D-Bus method call, freed by the reply
+ */
+static void task_group_return_discarded(const Task_Group* group, GDBusMethodInvocation* invocation) {
+    const gboolean orphaned = g_atomic_int_get(&group->state) == TASK_GROUP_ORPHANED;
+    // Replying frees the invocation, the bus will drop the reply if the caller has gone.
+    g_dbus_method_invocation_return_error(invocation, service_error_quark, DDCUTIL_SERVICE_DISCARDED,
+                                          orphaned ? "Caller %s has disconnected" : "Deadline for %s has passed",
+                                          orphaned ? g_dbus_method_invocation_get_sender(invocation)
+                                                   : g_dbus_method_invocation_get_method_name(invocation));
+}
+
+/**
+ * @brief Account for a finished (or skipped) task, the last one finishes the group and frees it.
+ * @param group the task's group
+ */
+static void task_group_task_done(Task_Group* group) {
+    if (!g_atomic_int_dec_and_test(&group->remaining)) {
+        return;
+    }
+    if (g_atomic_int_get(&group->state) != TASK_GROUP_ACTIVE) {
+        task_group_return_discarded(group, group->invocation);
+        group->invocation = NULL;
+    }
+    group->finish_func(group);
+    g_free(group);
+}
+
+static gpointer worker_thread_func(gpointer data) {
+    while (TRUE) {
+        g_mutex_lock(&scheduler_mutex);
+        Scheduled_Job* job;
+        while ((job = scheduler_next_job()) == NULL) {
+            g_cond_wait(&scheduler_cond, &scheduler_mutex);
+        }
+        const gboolean orphaned = job->sender_queues != NULL && job->sender_queues->disconnected;
+        g_mutex_unlock(&scheduler_mutex);
+        // Copied, the invocation is freed by the reply.
+        gchar* method_name = job->invocation != NULL
+                                 ? g_strdup(g_dbus_method_invocation_get_method_name(job->invocation)) : NULL;
+        if (method_name != NULL) {
+            latency_record_method(method_name, "queue", job->enqueued_micros);
+        }
+        if (job->group != NULL ? task_group_admit(job, orphaned) : !discard_job_if_dead(job, orphaned)) {
+            const long start_micros = g_get_monotonic_time();
+            GVariant* parameters = job->invocation != NULL ? g_dbus_method_invocation_get_parameters(job->invocation)
+                                                           : job->parameters;
+            int trace_display;
+            uint8_t trace_vcp_code;
+            trace_call_begin(parameters, &trace_display, &trace_vcp_code);
+            USDT_PROBE(job__entry, method_name, trace_display, trace_vcp_code, 0, 0);
+            if (job->barrier) {
+                g_rw_lock_writer_lock(&display_refs_lock);  // Only the GMainLoop can hold it, briefly
+            }
+            else {
+                g_rw_lock_reader_lock(&display_refs_lock);
+            }
+            if (job->group != NULL) {
+                job->group->task_func(job->group, job->task);
+            }
+            else {
+                job->func(parameters, job->invocation);
+            }
+            if (job->barrier) {
+                g_rw_lock_writer_unlock(&display_refs_lock);
+            }
+            else {
+                g_rw_lock_reader_unlock(&display_refs_lock);
+            }
+            if (method_name != NULL) {
+                latency_record_method(method_name, "run", start_micros);
+                trace_call_end(TRACE_RUN, job->sender_queues->sender, method_name, trace_display, trace_vcp_code,
+                               start_micros);
+            }
+            USDT_PROBE(job__return, method_name, trace_display, trace_vcp_code,
+                       GPOINTER_TO_INT(g_private_get(&trace_thread_status)), g_get_monotonic_time() - start_micros);
+        }
+        if (job->group != NULL) {
+            task_group_task_done(job->group);  // Outside display_refs_lock, the last one replies
+        }
+        g_free(method_name);
+        g_mutex_lock(&scheduler_mutex);
+        running_job_count--;
+        if (job->barrier) {
+            barrier_running = FALSE;
+            g_cond_broadcast(&scheduler_cond);  // Everything held back by the barrier
+        }
+        else if (running_job_count == 0) {
+            g_cond_signal(&scheduler_cond);  // A barrier may be waiting for the workers to drain
+        }
+        if (job->sender_queues != NULL) {
+            Sender_Queues* sender_queues = job->sender_queues;
+            if (--sender_queues->running_count == 0) {
+                sender_queues->running_group = NULL;
+                if (!g_queue_is_empty(&sender_queues->priority_queue)
+                    || !g_queue_is_empty(&sender_queues->normal_queue)) {
+                    g_cond_signal(&scheduler_cond);  // Workers passed over its next call while this one ran
+                }
+            }
+            sender_queues_free_if_finished(sender_queues);
+        }
+        else {
+            background_running_count--;
+            g_variant_unref(job->parameters);
+            if (!g_queue_is_empty(&background_queue)) {
+                g_cond_signal(&scheduler_cond);  // A worker may have passed over it while at the background limit
+            }
+        }
+        g_mutex_unlock(&scheduler_mutex);
+        g_free(job);
+    }
+    return NULL;
+}
+
+static void watch_drop_sender(const gchar* sender);
+
+/**
+ * @brief NameOwnerChanged signal handler, marks the queues of senders that have left the bus.
+ *
+ * Their queued jobs are discarded as workers reach them, which costs no DDC/I2C traffic.
+ * Their VCP watches are dropped.
+ */
+static void on_name_owner_changed(GDBusConnection* connection, const gchar* sender_name, const gchar* object_path,
+                                  const gchar* interface_name, const gchar* signal_name, GVariant* parameters,
+                                  gpointer user_data) {
+    const gchar* name;
+    const gchar* old_owner;
+    const gchar* new_owner;
+    g_variant_get(parameters, "(&s&s&s)", &name, &old_owner, &new_owner);
+    if (name[0] != ':' || new_owner[0] != '\0') {  // Only interested in unique names that have gone
+        return;
+    }
+    g_mutex_lock(&scheduler_mutex);
+    Sender_Queues* sender_queues = sender_queues_table != NULL ? g_hash_table_lookup(sender_queues_table, name) : NULL;
+    if (sender_queues != NULL) {
+        if (sender_queues->priority_queue.length + sender_queues->normal_queue.length > 0) {
+            g_info("%s disconnected, discarding %u queued calls", name,
+                   sender_queues->priority_queue.length + sender_queues->normal_queue.length);
+        }
+        sender_queues->disconnected = TRUE;
+        sender_queues_free_if_finished(sender_queues);
+    }
+    g_mutex_unlock(&scheduler_mutex);
+    watch_drop_sender(name);
+}
+
+/**
+ * @brief Extract the flags from a method's parameters, by convention flags are always the last parameter.
+ * @param parameters inbound parameters
+ * @return the flags, zero if the last parameter isn't a uint32
+ */
+static u_int32_t get_method_flags(GVariant* parameters) {
+    const gsize n = g_variant_n_children(parameters);
+    if (n == 0) {
+        return 0;
+    }
+    GVariant* last = g_variant_get_child_value(parameters, n - 1);
+    const u_int32_t flags = g_variant_is_of_type(last, G_VARIANT_TYPE_UINT32) ? g_variant_get_uint32(last) : 0;
+    g_variant_unref(last);
+    return flags;
+}
+
+/**
+ * @brief Start the worker threads on first use.  Requires scheduler_mutex.
+ */
+static void scheduler_start_locked(void) {
+    if (sender_queues_table == NULL) {
+        sender_queues_table = g_hash_table_new(g_str_hash, g_str_equal);
+        for (int i = 0; i < WORKER_THREAD_COUNT; i++) {
+            worker_threads[i] = g_thread_new("worker", worker_thread_func, NULL);
+        }
+    }
+}
+
+/**
+ * @brief Queue a service initiated job.
+ * @param func the implementing function, it is passed a NULL invocation
+ * @param parameters the function's parameters, if floating it is consumed
+ * @param barrier TRUE to run the job alone, holding display_refs_lock for writing, ahead of client calls
+ */
+static void schedule_background_job(Scheduled_Method_Func func, GVariant* parameters, const gboolean barrier) {
+    Scheduled_Job* job = g_new0(Scheduled_Job, 1);
+    job->func = func;
+    job->barrier = barrier;
+    job->parameters = g_variant_ref_sink(parameters);
+    job->enqueued_micros = g_get_monotonic_time();
+    g_mutex_lock(&scheduler_mutex);
+    scheduler_start_locked();
+    if (barrier) {
+        g_queue_push_head(&background_queue, job);
+    }
+    else {
+        g_queue_push_tail(&background_queue, job);
+    }
+    g_cond_signal(&scheduler_cond);
+    g_mutex_unlock(&scheduler_mutex);
+}
+
+/**
+ * @brief Queue a service initiated job, it runs when no client calls are waiting.
+ * @param func the implementing function, it is passed a NULL invocation
+ * @param parameters the function's parameters, if floating it is consumed
+ */
+static void schedule_background(Scheduled_Method_Func func, GVariant* parameters) {
+    schedule_background_job(func, parameters, FALSE);
+}
+
+/**
+ * @brief Queue a service initiated barrier, it runs next, once the running jobs have finished.
+ * @param func the implementing function, it is passed a NULL invocation
+ * @param parameters the function's parameters, if floating it is consumed
+ */
+static void schedule_background_barrier(Scheduled_Method_Func func, GVariant* parameters) {
+    schedule_background_job(func, parameters, TRUE);
+}
+
+/**
+ * @brief Queue jobs for a method call on its sender's queues, or shed the call if the sender's queue is full.
+ * @param method_name the D-Bus method name
+ * @param invocation originating D-Bus method call
+ * @param func the method's implementing function, NULL for a task group
+ * @param group the task group, NULL for a single job
+ * @param tasks the group's tasks, one job is queued for each
+ * @param number_of_tasks the number of tasks, 1 for a single job
+ * @param barrier TRUE to run the job alone, holding display_refs_lock for writing
+ * @return TRUE if queued, FALSE if shed (an error has been returned to the caller)
+ */
+static gboolean scheduler_enqueue(const gchar* method_name, GDBusMethodInvocation* invocation,
+                                  Scheduled_Method_Func func, Task_Group* group, gpointer* tasks,
+                                  const guint number_of_tasks, const gboolean barrier) {
+    const gchar* sender = g_dbus_method_invocation_get_sender(invocation);
+    const u_int32_t flags = get_method_flags(g_dbus_method_invocation_get_parameters(invocation));
+    const gboolean priority = (flags & PRIORITY) != 0;
+
+    g_mutex_lock(&scheduler_mutex);
+    scheduler_start_locked();
+    Sender_Queues* sender_queues = g_hash_table_lookup(sender_queues_table, sender != NULL ? sender : "");
+    if (sender_queues == NULL) {
+        sender_queues = g_new0(Sender_Queues, 1);
+        sender_queues->sender = g_strdup(sender != NULL ? sender : "");
+        g_queue_init(&sender_queues->priority_queue);
+        g_queue_init(&sender_queues->normal_queue);
+        g_hash_table_insert(sender_queues_table, sender_queues->sender, sender_queues);
+    }
+    const guint depth = sender_queues->priority_queue.length + sender_queues->normal_queue.length;
+    if (depth >= scheduler_max_queue_depth) {
+        sender_queues->shed_count++;
+        g_mutex_unlock(&scheduler_mutex);
+        g_info("%s shed, %s has %u calls queued", method_name, sender, depth);
+        g_dbus_method_invocation_return_error(invocation, service_error_quark, DDCUTIL_SERVICE_QUEUE_FULL,
+                                              "Too many calls queued for %s, limit is %d",
+                                              sender, scheduler_max_queue_depth);
+        return FALSE;
+    }
+    const long enqueued_micros = g_get_monotonic_time();
+    const u_int32_t deadline_millis = FLAGS_DEADLINE_MILLIS(flags);
+    GQueue* queue = priority ? &sender_queues->priority_queue : &sender_queues->normal_queue;
+    GQueue* ring = priority ? &priority_ring : &normal_ring;
+    if (g_queue_is_empty(queue)) {
+        g_queue_push_tail(ring, sender_queues);  // Sender joins the round-robin
+    }
+    for (int i = 0; i < number_of_tasks; i++) {
+        Scheduled_Job* job = g_new0(Scheduled_Job, 1);
+        job->func = func;
+        job->invocation = invocation;
+        job->sender_queues = sender_queues;
+        job->group = group;
+        job->task = tasks != NULL ? tasks[i] : NULL;
+        job->barrier = barrier;
+        job->enqueued_micros = enqueued_micros;
+        job->deadline_micros = deadline_millis != 0 ? enqueued_micros + deadline_millis * (long) 1000 : 0;
+        g_queue_push_tail(queue, job);
+    }
+    if (number_of_tasks > 1) {
+        g_cond_broadcast(&scheduler_cond);
+    }
+    else {
+        g_cond_signal(&scheduler_cond);
+    }
+    g_mutex_unlock(&scheduler_mutex);
+    return TRUE;
+}
+
+/**
+ * @brief Queue a method call for a worker thread, or shed it if the sender's queue is full.
+ * @param method_name the D-Bus method name
+ * @param invocation originating D-Bus method call
+ * @param func the method's implementing function
+ * @return TRUE if queued, FALSE if shed (an error has been returned to the caller)
+ */
+static gboolean schedule_call(const gchar* method_name, GDBusMethodInvocation* invocation, Scheduled_Method_Func func) {
+    return scheduler_enqueue(method_name, invocation, func, NULL, NULL, 1, FALSE);
+}
+
+/**
+ * @brief Queue a method call that redetects displays as a barrier, or shed it if the sender's queue is full.
+ *
+ * The call waits its turn like any other, then runs once all running jobs have finished, with no other
+ * job running alongside it.
+ *
+ * @param method_name the D-Bus method name
+ * @param invocation originating D-Bus method call
+ * @param func the method's implementing function
+ * @return TRUE if queued, FALSE if shed (an error has been returned to the caller)
+ */
+static gboolean schedule_barrier_call(const gchar* method_name, GDBusMethodInvocation* invocation,
+                                      Scheduled_Method_Func func) {
+    return scheduler_enqueue(method_name, invocation, func, NULL, NULL, 1, TRUE);
+}
+
+/**
+ * @brief Queue a method call's per-display work as a group of tasks, or shed the call if the sender's queue is full.
+ *
+ * The tasks are queued together on the sender's queues, so the call is queued or shed as a whole, but its
+ * displays are served by the workers concurrently.  Each task runs with display_refs_lock held for reading, so
+ * tasks should locate their display by EDID rather than hold display references from the GMainLoop.
+ * With no tasks, finish_func is called immediately.
+ *
+ * @param method_name the D-Bus method name
+ * @param invocation originating D-Bus method call, replied to by finish_func
+ * @param data the method's state, freed by finish_func, or by the caller if the call is shed
+ * @param task_func performs one task
+ * @param finish_func replies once all the tasks have run
+ * @param tasks the tasks, owned by data
+ * @param number_of_tasks the number of tasks
+ * @return TRUE if queued, FALSE if shed (an error has been returned to the caller)
+ */
+static gboolean schedule_task_group(const gchar* method_name, GDBusMethodInvocation* invocation, gpointer data,
+                                    Task_Func task_func, Task_Group_Finish_Func finish_func,
+                                    gpointer* tasks, const guint number_of_tasks) {
+    Task_Group* group = g_new0(Task_Group, 1);
+    group->invocation = invocation;
+    group->data = data;
+    group->task_func = task_func;
+    group->finish_func = finish_func;
+    group->remaining = number_of_tasks;
+    if (number_of_tasks == 0) {
+        finish_func(group);
+        g_free(group);
+        return TRUE;
+    }
+    if (!scheduler_enqueue(method_name, invocation, NULL, group, tasks, number_of_tasks, FALSE)) {
+        g_free(group);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Schedule a read method, or attach the call to an identical one already in flight.
+ * @param method_name the D-Bus method name
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ * @param func the method's implementing function, it must reply via return_read_result()
+ */
+static void dispatch_read(const gchar* method_name, GVariant* parameters, GDBusMethodInvocation* invocation,
+                          Scheduled_Method_Func func) {
+    gchar* parameters_text = g_variant_print(parameters, FALSE);
+    gchar* key = g_strconcat(method_name, parameters_text, NULL);
+    g_free(parameters_text);
+
+    g_mutex_lock(&inflight_read_mutex);
+    if (inflight_read_table == NULL) {
+        inflight_read_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    }
+    read_request_count++;
+    GPtrArray* followers = g_hash_table_lookup(inflight_read_table, key);
+    if (followers != NULL) {
+        read_dedup_hit_count++;
+        g_ptr_array_add(followers, invocation);
+        g_mutex_unlock(&inflight_read_mutex);
+        if (g_log_get_debug_enabled()) {
+            g_debug("%s attached to identical request in flight", method_name);
+        }
+        g_free(key);
+        return;
+    }
+    g_hash_table_insert(inflight_read_table, g_strdup(key), g_ptr_array_new());
+    g_mutex_unlock(&inflight_read_mutex);
+    g_object_set_data_full(G_OBJECT(invocation), INFLIGHT_KEY_DATA, key, g_free);
+
+    if (!schedule_call(method_name, invocation, func)) {
+        // Shed - followers can't have attached yet, as the key was only just added.
+        g_object_steal_data(G_OBJECT(invocation), INFLIGHT_KEY_DATA);
+        g_mutex_lock(&inflight_read_mutex);
+        g_ptr_array_free(g_hash_table_lookup(inflight_read_table, key), TRUE);
+        g_hash_table_remove(inflight_read_table, key);
+        g_mutex_unlock(&inflight_read_mutex);
+        g_free(key);
+    }
+}
+
+/**
+ * @brief Build the value of the ServiceStatistics property.
+ * @return a{sv} dictionary of statistic names and values
+ */
+static GVariant* get_service_statistics(void) {
+    GVariantBuilder builder_instance;
+    GVariantBuilder* builder = &builder_instance;
+    g_variant_builder_init(builder, G_VARIANT_TYPE("a{sv}"));
+    g_mutex_lock(&inflight_read_mutex);
+    g_variant_builder_add(builder, "{sv}", "read_requests", g_variant_new_uint64(read_request_count));
+    g_variant_builder_add(builder, "{sv}", "read_dedup_hits", g_variant_new_uint64(read_dedup_hit_count));
+    g_mutex_unlock(&inflight_read_mutex);
+
+    GVariantBuilder senders_builder_instance;
+    GVariantBuilder* senders_builder = &senders_builder_instance;
+    g_variant_builder_init(senders_builder, G_VARIANT_TYPE("a{s(uuttttt)}"));
+    g_mutex_lock(&scheduler_mutex);
+    if (sender_queues_table != NULL) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, sender_queues_table);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            const Sender_Queues* sq = value;
+            g_variant_builder_add(senders_builder, "{s(uuttttt)}", sq->sender,
+                                  sq->priority_queue.length, sq->normal_queue.length,
+                                  sq->served_count, sq->shed_count,
+                                  sq->served_count > 0 ? sq->total_wait_micros / sq->served_count : 0,
+                                  sq->max_wait_micros, sq->total_wait_micros);
+        }
+    }
+    g_mutex_unlock(&scheduler_mutex);
+    // Per sender: queued priority, queued normal, served, shed, mean wait, max wait, total wait (microseconds).
+    g_variant_builder_add(builder, "{sv}", "sender_queues", g_variant_builder_end(senders_builder));
+    g_mutex_lock(&scheduler_mutex);
+    g_variant_builder_add(builder, "{sv}", "expired_discards", g_variant_new_uint64(expired_discard_count));
+    g_variant_builder_add(builder, "{sv}", "orphaned_discards", g_variant_new_uint64(orphaned_discard_count));
+    g_mutex_unlock(&scheduler_mutex);
+    g_variant_builder_add(builder, "{sv}", "i2c_buses", get_rate_limit_statistics());
+    return g_variant_builder_end(builder);
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * Background prefetch
+ *
+ * When enabled by --prefetch, the service reads each display's capabilities and a few commonly used
+ * VCP values in the background after startup, detection, and connection events.  This warms the
+ * libddcutil capabilities cache and the service's VCP value cache before a client, for example, a
+ * settings dialog, asks for them.  Prefetch jobs are queued behind all client calls and never occupy
+ * every worker, displays are prefetched in parallel, and each bus is still subject to rate limiting.
+ */
+
+static gboolean prefetch_enabled = FALSE;
+
+static const uint8_t prefetch_vcp_codes[] = {0x10, 0x12, 0x14, 0x60, 0x62};  // Brightness, contrast, ...
+
+static GHashTable* prefetched_edids = NULL;  // base64 EDID set, displays prefetched since they connected
+
+/**
+ * @brief Background job that prefetches one display.
+ * @param parameters (s) the display's full base64 encoded EDID
+ * @param invocation always NULL
+ */
+static void prefetch_display(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    const char* edid_encoded;
+    g_variant_get(parameters, "(&s)", &edid_encoded);
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Status status = get_display_info(-1, edid_encoded, &info_list, &vdu_info, FALSE);
+    if (status == DDCRC_OK) {
+        DDCA_Display_Handle disp_handle;
+        status = i2c_open_display(vdu_info, &disp_handle);
+        if (status == DDCRC_OK) {
+            char* caps_text = NULL;
+            DDCA_Capabilities* parsed_capabilities_ptr = NULL;
+            status = i2c_get_capabilities_string(disp_handle, vdu_info, &caps_text);
+            if (status == DDCRC_OK) {
+                status = ddca_parse_capabilities_string(caps_text, &parsed_capabilities_ptr);
+            }
+            int prefetched_count = 0;
+            for (int i = 0; status == DDCRC_OK && i < G_N_ELEMENTS(prefetch_vcp_codes); i++) {
+                for (int j = 0; j < parsed_capabilities_ptr->vcp_code_ct; j++) {
+                    if (parsed_capabilities_ptr->vcp_codes[j].feature_code == prefetch_vcp_codes[i]) {
+                        uint16_t current_value, max_value;
+                        char* formatted_value;
+                        if (read_vcp_value(disp_handle, vdu_info, prefetch_vcp_codes[i], 0,
+                                           &current_value, &max_value, &formatted_value, NULL) == DDCRC_OK) {
+                            prefetched_count++;
+                        }
+                        g_free(formatted_value);
+                        break;
+                    }
+                }
+            }
+            if (parsed_capabilities_ptr != NULL) {
+                ddca_free_parsed_capabilities(parsed_capabilities_ptr);
+            }
+            free(caps_text);
+            backend->close_display(disp_handle);
+            g_info("Prefetch display_num=%d edid=%.30s... capabilities %s, %d values",
+                   vdu_info->dispno, edid_encoded, status == DDCRC_OK ? "read" : "failed", prefetched_count);
+        }
+    }
+    if (status != DDCRC_OK) {
+        // Probably just asleep or turned off
+        g_info("Prefetch failed for edid=%.30s... status=%d", edid_encoded, status);
+    }
+    backend->free_display_info_list(info_list);
+}
+
+/**
+ * @brief Queue prefetch jobs for the connected displays.  Called from the main thread.
+ * @param new_only only prefetch displays not prefetched since they connected
+ */
+static void prefetch_displays(const gboolean new_only) {
+    if (!prefetch_enabled) {
+        return;
+    }
+    DDCA_Display_Info_List* dlist = NULL;
+    if (get_display_info_list(FALSE, &dlist, "Prefetch") != DDCRC_OK) {
+        return;
+    }
+    // Rebuild the set from the current displays, so disconnected displays are prefetched if they return.
+    GHashTable* current_edids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    for (int i = 0; i < dlist->ct; i++) {
+        gchar* edid_encoded = edid_encode(dlist->info[i].edid_bytes);
+        if (!new_only || prefetched_edids == NULL || !g_hash_table_contains(prefetched_edids, edid_encoded)) {
+            schedule_background(prefetch_display, g_variant_new("(s)", edid_encoded));
+        }
+        g_hash_table_add(current_edids, edid_encoded);
+    }
+    backend->free_display_info_list(dlist);
+    if (prefetched_edids != NULL) {
+        g_hash_table_destroy(prefetched_edids);
+    }
+    prefetched_edids = current_edids;
+}
+
+/*
+ * Predictive prefetch
+ *
+ * Clients tend to read VCP-codes in predictable groups, for example, brightness followed by contrast.
+ * For each display the service counts how often a client read of one code is followed, within
+ * CO_ACCESS_WINDOW_MICROS, by a read of another.  After serving a read, any code that has followed
+ * it at least PREDICT_MIN_COUNT times and on at least half of the occasions is prefetched by a
+ * background job.  A prefetched value stands in for the next live read of that code if it occurs
+ * within PREFETCH_TTL_MICROS.  The hit rate is reported by the ServicePrefetchHitRate property.
+ */
+
+#define CO_ACCESS_WINDOW_MICROS 3000000
+#define PREDICT_MIN_COUNT 3
+
+typedef struct {
+    uint8_t last_code;
+    long last_micros;             // Zero if no previous read
+    GHashTable* pair_counts;      // (from_code << 8 | to_code) -> count
+    guint from_counts[256];       // How often each code was followed by another within the window
+} Co_Access;
+
+static GHashTable* co_access_table = NULL;  // base64 EDID -> Co_Access
+static GHashTable* prefetch_pending = NULL; // "edid:code" of queued predictive prefetches
+static GMutex co_access_mutex;              // Protects the above and the counter below
+static guint64 predictive_prefetch_count = 0;
+
+static void co_access_free(gpointer data) {
+    Co_Access* co_access = data;
+    g_hash_table_destroy(co_access->pair_counts);
+    g_free(co_access);
+}
+
+/**
+ * @brief Background job that prefetches one VCP-code.
+ * @param parameters (sy) the display's full base64 encoded EDID and the VCP-code
+ * @param invocation always NULL
+ */
+static void prefetch_vcp_code(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    const char* edid_encoded;
+    uint8_t vcp_code;
+    g_variant_get(parameters, "(&sy)", &edid_encoded, &vcp_code);
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Status status = get_display_info(-1, edid_encoded, &info_list, &vdu_info, FALSE);
+    if (status == DDCRC_OK && !vcp_cache_is_fresh(edid_encoded, vcp_code)) {  // Not read while queued
+        DDCA_Display_Handle disp_handle;
+        status = i2c_open_display(vdu_info, &disp_handle);
+        if (status == DDCRC_OK) {
+            uint16_t current_value, max_value;
+            char* formatted_value;
+            status = read_vcp_value(disp_handle, vdu_info, vcp_code, 0,
+                                    &current_value, &max_value, &formatted_value, NULL);
+            backend->close_display(disp_handle);
+            g_free(formatted_value);
+            if (status == DDCRC_OK) {
+                vcp_cache_mark_prefetched(edid_encoded, vcp_code);
+            }
+        }
+    }
+    backend->free_display_info_list(info_list);
+    gchar* key = g_strdup_printf("%s:%d", edid_encoded, vcp_code);
+    g_mutex_lock(&co_access_mutex);
+    g_hash_table_remove(prefetch_pending, key);
+    g_mutex_unlock(&co_access_mutex);
+    g_free(key);
+}
+
+/**
+ * @brief Learn from a client read of a VCP-code and prefetch the codes likely to be read next.
+ * @param vdu_info the display
+ * @param vcp_code the VCP-code the client read
+ */
+static void co_access_observe(const DDCA_Display_Info* vdu_info, const uint8_t vcp_code) {
+    if (!prefetch_enabled) {
+        return;
+    }
+    gchar* edid_encoded = edid_encode(vdu_info->edid_bytes);
+    uint8_t predicted_codes[256];
+    int predicted_count = 0;
+    const long now = g_get_monotonic_time();
+    g_mutex_lock(&co_access_mutex);
+    if (co_access_table == NULL) {
+        co_access_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, co_access_free);
+        prefetch_pending = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    }
+    Co_Access* co_access = g_hash_table_lookup(co_access_table, edid_encoded);
+    if (co_access == NULL) {
+        co_access = g_new0(Co_Access, 1);
+        co_access->pair_counts = g_hash_table_new(g_direct_hash, g_direct_equal);
+        g_hash_table_insert(co_access_table, g_strdup(edid_encoded), co_access);
+    }
+    if (co_access->last_micros != 0 && now - co_access->last_micros < CO_ACCESS_WINDOW_MICROS
+        && co_access->last_code != vcp_code) {
+        const gpointer pair = GUINT_TO_POINTER(co_access->last_code << 8 | vcp_code);
+        const guint count = GPOINTER_TO_UINT(g_hash_table_lookup(co_access->pair_counts, pair));
+        g_hash_table_insert(co_access->pair_counts, pair, GUINT_TO_POINTER(count + 1));
+        co_access->from_counts[co_access->last_code]++;
+    }
+    co_access->last_code = vcp_code;
+    co_access->last_micros = now;
+    const guint from_count = co_access->from_counts[vcp_code];
+    for (int next_code = 0; from_count >= PREDICT_MIN_COUNT && next_code < 256; next_code++) {
+        const guint count = GPOINTER_TO_UINT(g_hash_table_lookup(co_access->pair_counts,
+                                                                 GUINT_TO_POINTER(vcp_code << 8 | next_code)));
+        if (count >= PREDICT_MIN_COUNT && count * 2 >= from_count) {
+            predicted_codes[predicted_count++] = next_code;
+        }
+    }
+    g_mutex_unlock(&co_access_mutex);
+
+    for (int i = 0; i < predicted_count; i++) {
+        if (vcp_cache_is_fresh(edid_encoded, predicted_codes[i])) {
+            continue;
+        }
+        gchar* key = g_strdup_printf("%s:%d", edid_encoded, predicted_codes[i]);
+        g_mutex_lock(&co_access_mutex);
+        const gboolean queued = g_hash_table_contains(prefetch_pending, key);
+        if (!queued) {
+            g_hash_table_add(prefetch_pending, key);
+            predictive_prefetch_count++;
+        }
+        g_mutex_unlock(&co_access_mutex);
+        if (queued) {
+            g_free(key);
+        }
+        else {
+            if (g_log_get_debug_enabled()) {
+                g_debug("Predictive prefetch vcp_code=%d after %d edid=%.30s...",
+                        predicted_codes[i], vcp_code, edid_encoded);
+            }
+            schedule_background(prefetch_vcp_code, g_variant_new("(sy)", edid_encoded, predicted_codes[i]));
+        }
+    }
+    g_free(edid_encoded);
+}
+
+/**
+ * @brief Compute the value of the ServicePrefetchHitRate property.
+ * @return the fraction of predictive prefetches used by clients, zero if there have been none
+ */
+static double get_prefetch_hit_rate(void) {
+    g_mutex_lock(&co_access_mutex);
+    const guint64 prefetches = predictive_prefetch_count;
+    g_mutex_unlock(&co_access_mutex);
+    g_mutex_lock(&vcp_cache_mutex);
+    const guint64 hits = prefetch_hit_count;
+    g_mutex_unlock(&vcp_cache_mutex);
+    return prefetches > 0 ? (double) hits / (double) prefetches : 0.0;
+}
+
+extern char** environ;
+
+/**
+ * @brief Implement the DdcutilService Restart method
+ *
+ * Restarts the service. This function must terminate the current
+ * process and fork a new one so that dca_init() can then be called
+ * to apply libopts, syslog_level and opts.
+ *
+ * @param parameters containing the new libopts, syslog_level and opts (suu)
+ * @param invocation the originating D-Bus call - returning a value to it before terminating the current process.
+ */
+static void restart(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    if (lock_configuration) {
+        g_dbus_method_invocation_return_error(invocation, service_error_quark, DDCUTIL_SERVICE_CONFIGURATION_LOCKED,
+            "Failed to restart the service: configuration locked by --lock command line argument.");
+        return;
+    }
+    char* libopts;
+    u_int32_t syslog_level;
+    u_int32_t opts;
+    g_variant_get(parameters, "(suu)", &libopts, &syslog_level, &opts);
+    char* message_text = get_status_message(DDCRC_OK);
+    g_message("DdcaInit syslog_level=%x opts=%x libopts=%s", syslog_level, opts, libopts);
+    GVariant* result = g_variant_new("(is)", DDCRC_OK, message_text);
+    g_dbus_method_invocation_return_value(invocation, result);
+
+    gchar** argv;
+#if defined(LIBDDCUTIL_HAS_OPTION_ARGUMENTS)
+    gchar* args_str = "";
+    if (syslog_level != 0) {
+        args_str = g_strdup_printf("%s --ddca-syslog-level=%d", args_str, syslog_level);
+    }
+    if (opts != 0) {
+        args_str = g_strdup_printf("%s --ddca-init-options=%d", args_str, opts);
+    }
+    args_str = g_strdup_printf("%s -- %s", args_str, libopts);
+    argv = g_strsplit(args_str, " ", -1);
+#else
+  gchar *no_args = { NULL };
+  argv = &no_args;
+#endif
+
+    // If running under dbus-daemon a respawn is not necessary except that
+    // we want to pass arguments.
+    const struct sigaction arg = {
+        .sa_handler = SIG_IGN,
+        .sa_flags = SA_NOCLDWAIT // Never wait for termination of a child process.
+    };
+    sigaction(SIGCHLD, &arg, NULL);
+
+    pid_t spawn_pid;
+    posix_spawn(&spawn_pid, server_executable, NULL, NULL, argv, environ);
+    exit(0);
+}
+
+/**
+ * @brief Redetect displays, invalidating the current display refs.
+ *
+ * Requires display_refs_lock held for writing, so call it from a barrier job, never from the GMainLoop,
+ * which would have to wait for every running job to finish.
+ *
+ * @return the libddcutil status
+ */
+static DDCA_Status redetect_displays(void) {
+    const long start_micros = g_get_monotonic_time();
+    const DDCA_Status status = backend->redetect_displays();
+    USDT_PROBE(redetect, "redetect", -1, 0, status, g_get_monotonic_time() - start_micros);
+    return status;
+}
+
+#if defined(LIBDDCUTIL_HAS_CHANGES_CALLBACK)
+static void display_status_event_callback(DDCA_Display_Status_Event event);
+#endif
+
+/**
+ * @brief Add the Detect method's struct for each display in a list.
+ * @param detected_displays_builder builder for a(iiisssqsu)
+ * @param dlist the displays
+ */
+static void add_detected_displays(GVariantBuilder* detected_displays_builder, const DDCA_Display_Info_List* dlist) {
+    for (int ndx = 0; ndx < dlist->ct; ndx++) {
+        const DDCA_Display_Info *vdu_info = &dlist->info[ndx];
+        gchar *safe_mfg_id = sanitize_utf8(vdu_info->mfg_id);
+        gchar *safe_model = sanitize_utf8(vdu_info->model_name); //"xxxxwww\xF0\xA4\xADiii" );
+        gchar *safe_sn = sanitize_utf8(vdu_info->sn);
+        gchar *edid_encoded = edid_encode(vdu_info->edid_bytes);
+        g_info("Detect: detected %s %s %s display_num=%d edid=%.30s...",
+               safe_mfg_id, safe_model, safe_sn, vdu_info->dispno, edid_encoded);
+        g_variant_builder_add(
+                detected_displays_builder,
+                "(iiisssqsu)",
+                vdu_info->dispno, vdu_info->usb_bus, vdu_info->usb_device,
+                safe_mfg_id, safe_model, safe_sn,
+                vdu_info->product_code,
+                edid_encoded,
+                edid_to_binary_serial_number(vdu_info->edid_bytes));
+        g_free(safe_mfg_id);
+        g_free(safe_model);
+        g_free(safe_sn);
+        g_free(edid_encoded);
+    }
+}
+
+/**
+ * @brief Implements the DdcutilService Detect method
+ *
+ * Passes a list of display structs back to the invocation.
+ *
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void detect(GVariant* parameters, GDBusMethodInvocation* invocation, gboolean list_only) {
+    u_int32_t flags;
+    g_variant_get(parameters, "(u)", &flags);
+
+    int vdu_count = 0;
+
+    // GVariantBuilder: see https://docs.gtk.org/glib/struct.VariantBuilder.html
+    GVariantBuilder detected_displays_builder_instance; // Allocate on the stack for easier memory management.
+    GVariantBuilder* detected_displays_builder = &detected_displays_builder_instance;
+    g_variant_builder_init(detected_displays_builder, G_VARIANT_TYPE("a(iiisssqsu)"));
+
+    g_info("Detect flags=%x", flags);
+
+    DDCA_Status detect_status = DDCRC_OK;
+    char* detect_message_text = NULL;
+
+    if (!list_only) {
+        detect_status = redetect_displays();
+        vcp_cache_invalidate(NULL);  // Everything may have changed
+        prefetch_displays(FALSE);
+    }
+
+    if (detect_status != DDCRC_OK) {
+        detect_message_text = get_status_message(detect_status);
+        g_warning("Detect: ddca_redetect_displays failed status=%d message=%s", detect_status, detect_message_text);
+    }
+    else {
+        DDCA_Display_Info_List *dlist = NULL;
+        const int detect_all = (flags & DETECT_ALL) || (flags & EDID_PREFIX);  // Accept either because of old API error
+        detect_status = get_display_info_list(detect_all, &dlist, "Detect");
+        detect_message_text = get_status_message(detect_status);
+        if (detect_status != DDCRC_OK) {
+            g_warning("Detect: ddca_get_display_info_list2 failed status=%d message=%s",
+                      detect_status, detect_message_text);
+        } else {
+            vdu_count = dlist->ct;
+#if defined(TEST_LAPTOP_BOGUS_VDU)
+            g_variant_builder_add(
+                detected_displays_builder,
+                "(iiisssqsu)",
+                -1, -1, 0,
+                g_strdup(""), g_strdup(""), g_strdup(""),
+                0,
+                g_strdup("123456789-123456789-123456789-123456789-123456789-123456789-123456789-123456789-123456789"
+                "-123456789-123456789-123456789-12345678"),
+                0);
+            vdu_count++;
+#endif
+            add_detected_displays(detected_displays_builder, dlist);
+            backend->free_display_info_list(dlist);
+        }
+    }
+
+    GVariant* result = g_variant_new("(ia(iiisssqsu)is)",
+                                     vdu_count, detected_displays_builder, detect_status, detect_message_text);
+
+    g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result.
+    free(detect_message_text);
+}
+
+/**
+ * @brief Implements the DdcutilService Detect method, run as a barrier job
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void detect_with_redetect(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    detect(parameters, invocation, FALSE);
+}
+
+/**
+ * @brief Implements the DdcutilService GetVcp method
+ *
+ * Passes a single VCP value to the invocation.
+ *
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void get_vcp(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    int display_number;
+    char* edid_encoded;
+    uint8_t vcp_code;
+    u_int32_t flags;
+
+    g_variant_get(parameters, "(isyu)", &display_number, &edid_encoded, &vcp_code, &flags);
+
+    g_info("GetVcp vcp_code=%d display_num=%d, edid=%.30s...", vcp_code, display_number, edid_encoded);
+
+    uint16_t current_value = 0;
+    uint16_t max_value = 0;
+    char* formatted_value = NULL;
+
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
+    if (status == DDCRC_OK) {
+        gchar* vdu_edid_encoded = edid_encode(vdu_info->edid_bytes);
+        const gboolean prefetched = vcp_cache_take_prefetched(vdu_edid_encoded, vcp_code, flags,
+                                                              &current_value, &max_value, &formatted_value);
+        g_free(vdu_edid_encoded);
+        DDCA_Display_Handle disp_handle;
+        if (prefetched) {
+            g_info("GetVcp vcp_code=%d display_num=%d served from prefetch", vcp_code, display_number);
+        }
+        else if ((status = i2c_open_display(vdu_info, &disp_handle)) == DDCRC_OK) {
+            status = read_vcp_value(disp_handle, vdu_info, vcp_code, flags,
+                                    &current_value, &max_value, &formatted_value, NULL);
+            if (status != DDCRC_OK) {
+                // Probably just asleep or turned off
+                g_info("GetVcp failed for vcp_code=%d display_num=%d edid=%.30s... status=%d",
+                       vcp_code, display_number, edid_encoded, status);
+            }
+            backend->close_display(disp_handle);
+        }
+        else {
+            g_warning("GetVcp open failed for vcp_code=%d display_num=%d edid=%.30s... status=%d",
+                      vcp_code, display_number, edid_encoded, status);
+        }
+        if (status == DDCRC_OK) {
+            co_access_observe(vdu_info, vcp_code);
+        }
+    }
+    else {
+        g_warning("GetVcp get_display_info failed for vcp_code=%d display_num=%d edid=%.30s...",
+                  vcp_code, display_number, edid_encoded);
+    }
+    char* message_text = get_status_message(status);
+    GVariant* result = g_variant_new(
+        "(qqsis)", current_value, max_value, formatted_value ? formatted_value : "", status, message_text);
+    return_read_result(invocation, result);
+    backend->free_display_info_list(info_list);
+    g_free(formatted_value);
+    free(edid_encoded);
+    free(message_text);
+}
+
+/**
+ * @brief Implements the DdcutilService GetMultipleVcp method
+ *
+ * Passes back an array of VCP values to the invocation.
+ *
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void get_multiple_vcp(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    int display_number;
+    char* edid_encoded;
+    u_int32_t flags;
+
+    GVariantIter* vcp_code_iter;
+    g_variant_get(parameters, "(isayu)", &display_number, &edid_encoded, &vcp_code_iter, &flags);
+
+    g_info("GetMultipleVcp display_num=%d, edid=%.30s...", display_number, edid_encoded);
+
+    const gsize number_of_vcp_codes = g_variant_iter_n_children(vcp_code_iter);
+    const u_int8_t vcp_codes[number_of_vcp_codes];
+    for (int i = 0; g_variant_iter_loop(vcp_code_iter, "y", &vcp_codes[i]); i++) {
+    }
+    g_variant_iter_free(vcp_code_iter);
+
+    GVariantBuilder value_array_builder_instance;
+    GVariantBuilder* value_array_builder = &value_array_builder_instance;
+    g_variant_builder_init(value_array_builder, G_VARIANT_TYPE("a(yqqs)"));
+
+    ddca_enable_verify(TRUE);
+
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
+    if (status == DDCRC_OK) {
+        gchar* vdu_edid_encoded = edid_encode(vdu_info->edid_bytes);
+        DDCA_Display_Handle disp_handle;
+        status = i2c_open_display(vdu_info, &disp_handle);
+        if (status == DDCRC_OK) {
+            for (int i = 0; i < number_of_vcp_codes; i++) {
+                const u_int8_t vcp_code = vcp_codes[i];
+                uint16_t current_value, max_value;
+                char* formatted_value;
+                status = vcp_cache_take_prefetched(vdu_edid_encoded, vcp_code, flags,
+                                                   &current_value, &max_value, &formatted_value)
+                         ? DDCRC_OK
+                         : read_vcp_value(disp_handle, vdu_info, vcp_code, flags,
+                                          &current_value, &max_value, &formatted_value, NULL);
+                if (status == DDCRC_OK) {
+                    g_variant_builder_add(value_array_builder, "(yqqs)",
+                                          vcp_code, current_value, max_value, formatted_value);
+                    g_free(formatted_value);
+                    co_access_observe(vdu_info, vcp_code);
+                }
+                else {
+                    // Probably just asleep or turned off
+                    g_info("GetMultipleVcp failed for vcp_code=%d display_num=%d edid=%.30s...",
+                           vcp_code, display_number, edid_encoded);
+                }
+            }
+            backend->close_display(disp_handle);
+        }
+        else {
+            g_info("GetMultipleVcp open failed for display_num=%d edid=%.30s...",
+                   display_number, edid_encoded);
+        }
+        g_free(vdu_edid_encoded);
+    }
+    else {
+        g_info("GetMultipleVcp get_display_info failed for display_num=%d edid=%.30s...",
+               display_number, edid_encoded);
+    }
+    g_info("GetMultipleVcp open looks ok for display_num=%d edid=%.30s...",
+               display_number, edid_encoded);
+    char* message_text = get_status_message(status);
+    GVariant* result = g_variant_new("(a(yqqs)is)", value_array_builder, status, message_text);
+    return_read_result(invocation, result);
+    backend->free_display_info_list(info_list);
+    g_free(edid_encoded);
+    free(message_text);
+}
+
+/**
+ * @brief Implements the DdcutilService GetVcpConditional method
+ *
+ * As for GetVcp, but if the client's last seen version is still current, the cached value is
+ * returned as not-modified without accessing the VDU.
+ *
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void get_vcp_conditional(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    int display_number;
+    char* edid_encoded;
+    uint8_t vcp_code;
+    u_int32_t last_version;
+    u_int32_t flags;
+
+    g_variant_get(parameters, "(isyuu)", &display_number, &edid_encoded, &vcp_code, &last_version, &flags);
+
+    g_info("GetVcpConditional vcp_code=%d last_version=%u display_num=%d, edid=%.30s...",
+           vcp_code, last_version, display_number, edid_encoded);
+
+    uint16_t current_value = 0;
+    uint16_t max_value = 0;
+    char* formatted_value = NULL;
+    guint32 version = 0;
+    gboolean modified = TRUE;
+
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
+    if (status == DDCRC_OK) {
+        gchar* vdu_edid_encoded = edid_encode(vdu_info->edid_bytes);
+        const gboolean unmodified = vcp_cache_get_unmodified(vdu_edid_encoded, vcp_code, last_version, flags,
+                                                             &current_value, &max_value, &formatted_value);
+        g_free(vdu_edid_encoded);
+        if (unmodified) {
+            modified = FALSE;
+            version = last_version;
+        }
+        else {
+            DDCA_Display_Handle disp_handle;
+            status = i2c_open_display(vdu_info, &disp_handle);
+            if (status == DDCRC_OK) {
+                status = read_vcp_value(disp_handle, vdu_info, vcp_code, flags,
+                                        &current_value, &max_value, &formatted_value, &version);
+                backend->close_display(disp_handle);
+                modified = status != DDCRC_OK || version != last_version;
+            }
+        }
+    }
+    if (status != DDCRC_OK) {
+        // Probably just asleep or turned off
+        g_info("GetVcpConditional failed for vcp_code=%d display_num=%d edid=%.30s... status=%d",
+               vcp_code, display_number, edid_encoded, status);
+    }
+    char* message_text = get_status_message(status);
+    GVariant* result = g_variant_new("(qqsubis)",
+                                     current_value, max_value, formatted_value ? formatted_value : "",
+                                     version, modified, status, message_text);
+    return_read_result(invocation, result);
+    backend->free_display_info_list(info_list);
+    g_free(formatted_value);
+    g_free(edid_encoded);
+    free(message_text);
+}
+
+/**
+ * @brief Implements the DdcutilService GetMultipleVcpConditional method
+ *
+ * As for GetMultipleVcp, but each VCP-code is paired with the client's last seen version.
+ * The VDU is only opened if at least one of the values can't be vouched for from the cache.
+ *
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void get_multiple_vcp_conditional(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    int display_number;
+    char* edid_encoded;
+    u_int32_t flags;
+
+    GVariantIter* vcp_code_iter;
+    g_variant_get(parameters, "(isa(yu)u)", &display_number, &edid_encoded, &vcp_code_iter, &flags);
+
+    g_info("GetMultipleVcpConditional display_num=%d, edid=%.30s...", display_number, edid_encoded);
+
+    const gsize number_of_vcp_codes = g_variant_iter_n_children(vcp_code_iter);
+    u_int8_t vcp_codes[number_of_vcp_codes];
+    u_int32_t last_versions[number_of_vcp_codes];
+    for (int i = 0; g_variant_iter_loop(vcp_code_iter, "(yu)", &vcp_codes[i], &last_versions[i]); i++) {
+    }
+    g_variant_iter_free(vcp_code_iter);
+
+    GVariantBuilder value_array_builder_instance;
+    GVariantBuilder* value_array_builder = &value_array_builder_instance;
+    g_variant_builder_init(value_array_builder, G_VARIANT_TYPE("a(yqqsub)"));
+
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
+    if (status == DDCRC_OK) {
+        gchar* vdu_edid_encoded = edid_encode(vdu_info->edid_bytes);
+        DDCA_Display_Handle disp_handle = NULL;
+        for (int i = 0; i < number_of_vcp_codes; i++) {
+            const u_int8_t vcp_code = vcp_codes[i];
+            uint16_t current_value, max_value;
+            char* formatted_value;
+            if (vcp_cache_get_unmodified(vdu_edid_encoded, vcp_code, last_versions[i], flags,
+                                         &current_value, &max_value, &formatted_value)) {
+                g_variant_builder_add(value_array_builder, "(yqqsub)",
+                                      vcp_code, current_value, max_value, formatted_value,
+                                      last_versions[i], FALSE);
+                g_free(formatted_value);
+                continue;
+            }
+            if (disp_handle == NULL) {  // Open on first use only
+                status = i2c_open_display(vdu_info, &disp_handle);
+                if (status != DDCRC_OK) {
+                    disp_handle = NULL;
+                    g_info("GetMultipleVcpConditional open failed for display_num=%d edid=%.30s...",
+                           display_number, edid_encoded);
+                    break;
+                }
+            }
+            guint32 version = 0;
+            status = read_vcp_value(disp_handle, vdu_info, vcp_code, flags,
+                                    &current_value, &max_value, &formatted_value, &version);
+            if (status == DDCRC_OK) {
+                g_variant_builder_add(value_array_builder, "(yqqsub)",
+                                      vcp_code, current_value, max_value, formatted_value,
+                                      version, version != last_versions[i]);
+                g_free(formatted_value);
+            }
+            else {
+                // Probably just asleep or turned off
+                g_info("GetMultipleVcpConditional failed for vcp_code=%d display_num=%d edid=%.30s...",
+                       vcp_code, display_number, edid_encoded);
+            }
+        }
+        if (disp_handle != NULL) {
+            backend->close_display(disp_handle);
+        }
+        g_free(vdu_edid_encoded);
+    }
+    else {
+        g_info("GetMultipleVcpConditional get_display_info failed for display_num=%d edid=%.30s...",
+               display_number, edid_encoded);
+    }
+    char* message_text = get_status_message(status);
+    GVariant* result = g_variant_new("(a(yqqsub)is)", value_array_builder, status, message_text);
+    return_read_result(invocation, result);
+    backend->free_display_info_list(info_list);
+    g_free(edid_encoded);
+    free(message_text);
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * Latency budget reads.
+ *
+ * GetVcpWithBudget and GetMultipleVcpWithBudget schedule a live read and start a timer for the
+ * client's budget.  If the timer fires first and the service has previously read the values, the
+ * last known values are returned marked stale, along with their age.  The live read carries on
+ * regardless, and refreshes the VCP value cache when it completes.  If a value has never been read,
+ * the client has to wait for the live read.
+ */
+
+/**
+ * @brief Reply to a budget read from the live read, unless the budget timer has already replied.
+ * @param invocation the D-Bus method call
+ * @param result the result, if floating it is consumed
+ */
+static void return_budget_result(GDBusMethodInvocation* invocation, GVariant* result) {
+    if (claim_reply(invocation)) {
+        g_dbus_method_invocation_return_value(invocation, result);
+    }
+    else {
+        if (g_log_get_debug_enabled()) {
+            g_debug("%s live read completed after budget, cache refreshed",
+                    g_dbus_method_invocation_get_method_name(invocation));
+        }
+        g_variant_unref(g_variant_ref_sink(result));
+        g_object_unref(invocation);
+    }
+}
+
+/**
+ * @brief Implements the live read of the DdcutilService GetVcpWithBudget method
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void get_vcp_with_budget(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    int display_number;
+    char* edid_encoded;
+    uint8_t vcp_code;
+    u_int32_t budget_millis;
+    u_int32_t flags;
+
+    g_variant_get(parameters, "(isyuu)", &display_number, &edid_encoded, &vcp_code, &budget_millis, &flags);
+
+    g_info("GetVcpWithBudget vcp_code=%d budget=%ums display_num=%d, edid=%.30s...",
+           vcp_code, budget_millis, display_number, edid_encoded);
+
+    uint16_t current_value = 0;
+    uint16_t max_value = 0;
+    char* formatted_value = NULL;
+
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
+    if (status == DDCRC_OK) {
+        DDCA_Display_Handle disp_handle;
+        status = i2c_open_display(vdu_info, &disp_handle);
+        if (status == DDCRC_OK) {
+            status = read_vcp_value(disp_handle, vdu_info, vcp_code, flags,
+                                    &current_value, &max_value, &formatted_value, NULL);
+            backend->close_display(disp_handle);
+        }
+    }
+    if (status != DDCRC_OK) {
+        // Probably just asleep or turned off
+        g_info("GetVcpWithBudget failed for vcp_code=%d display_num=%d edid=%.30s... status=%d",
+               vcp_code, display_number, edid_encoded, status);
+    }
+    char* message_text = get_status_message(status);
+    GVariant* result = g_variant_new("(qqsbuis)", current_value, max_value, formatted_value ? formatted_value : "",
+                                     FALSE, 0, status, message_text);
+    return_budget_result(invocation, result);
+    backend->free_display_info_list(info_list);
+    g_free(formatted_value);
+    g_free(edid_encoded);
+    free(message_text);
+}
+
+/**
+ * @brief Implements the live read of the DdcutilService GetMultipleVcpWithBudget method
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void get_multiple_vcp_with_budget(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    int display_number;
+    char* edid_encoded;
+    u_int32_t budget_millis;
+    u_int32_t flags;
+
+    GVariantIter* vcp_code_iter;
+    g_variant_get(parameters, "(isayuu)", &display_number, &edid_encoded, &vcp_code_iter, &budget_millis, &flags);
+
+    g_info("GetMultipleVcpWithBudget budget=%ums display_num=%d, edid=%.30s...",
+           budget_millis, display_number, edid_encoded);
+
+    GVariantBuilder value_array_builder_instance;
+    GVariantBuilder* value_array_builder = &value_array_builder_instance;
+    g_variant_builder_init(value_array_builder, G_VARIANT_TYPE("a(yqqsbu)"));
+
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
+    if (status == DDCRC_OK) {
+        DDCA_Display_Handle disp_handle;
+        status = i2c_open_display(vdu_info, &disp_handle);
+        if (status == DDCRC_OK) {
+            u_int8_t vcp_code;
+            while (g_variant_iter_loop(vcp_code_iter, "y", &vcp_code)) {
+                uint16_t current_value, max_value;
+                char* formatted_value;
+                status = read_vcp_value(disp_handle, vdu_info, vcp_code, flags,
+                                        &current_value, &max_value, &formatted_value, NULL);
+                if (status == DDCRC_OK) {
+                    g_variant_builder_add(value_array_builder, "(yqqsbu)",
+                                          vcp_code, current_value, max_value, formatted_value, FALSE, 0);
+                    g_free(formatted_value);
+                }
+                else {
+                    // Probably just asleep or turned off
+                    g_info("GetMultipleVcpWithBudget failed for vcp_code=%d display_num=%d edid=%.30s...",
+                           vcp_code, display_number, edid_encoded);
+                }
+            }
+            backend->close_display(disp_handle);
+        }
+    }
+    if (status != DDCRC_OK) {
+        g_info("GetMultipleVcpWithBudget failed for display_num=%d edid=%.30s... status=%d",
+               display_number, edid_encoded, status);
+    }
+    g_variant_iter_free(vcp_code_iter);
+    char* message_text = get_status_message(status);
+    GVariant* result = g_variant_new("(a(yqqsbu)is)", value_array_builder, status, message_text);
+    return_budget_result(invocation, result);
+    backend->free_display_info_list(info_list);
+    g_free(edid_encoded);
+    free(message_text);
+}
+
+/**
+ * @brief Build a stale reply for a budget read from the last known values.
+ * @param invocation the D-Bus method call
+ * @return the result, or NULL if any of the requested values have never been read
+ */
+static GVariant* build_budget_stale_result(GDBusMethodInvocation* invocation) {
+    GVariant* parameters = g_dbus_method_invocation_get_parameters(invocation);
+    const gboolean multiple = g_strcmp0(g_dbus_method_invocation_get_method_name(invocation),
+                                        "GetMultipleVcpWithBudget") == 0;
+    int display_number;
+    const char* edid_encoded;
+    GVariant* vcp_codes_variant = NULL;
+    uint8_t vcp_code = 0;
+    u_int32_t budget_millis;
+    u_int32_t flags;
+    if (multiple) {
+        g_variant_get(parameters, "(i&s@ayuu)", &display_number, &edid_encoded, &vcp_codes_variant,
+                      &budget_millis, &flags);
+    }
+    else {
+        g_variant_get(parameters, "(i&syuu)", &display_number, &edid_encoded, &vcp_code, &budget_millis, &flags);
+    }
+
+    GVariant* result = NULL;
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    g_rw_lock_reader_lock(&display_refs_lock);
+    const DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info,
+                                                flags & EDID_PREFIX);
+    gchar* vdu_edid_encoded = status == DDCRC_OK ? edid_encode(vdu_info->edid_bytes) : NULL;
+    backend->free_display_info_list(info_list);
+    g_rw_lock_reader_unlock(&display_refs_lock);
+    if (vdu_edid_encoded == NULL) {
+        return NULL;
+    }
+    char* message_text = get_status_message(DDCRC_OK);
+    uint16_t current_value, max_value;
+    char* formatted_value;
+    long age_micros;
+    if (multiple) {
+        GVariantBuilder value_array_builder_instance;
+        GVariantBuilder* value_array_builder = &value_array_builder_instance;
+        g_variant_builder_init(value_array_builder, G_VARIANT_TYPE("a(yqqsbu)"));
+        gboolean all_known = TRUE;
+        GVariantIter iter;
+        g_variant_iter_init(&iter, vcp_codes_variant);
+        while (all_known && g_variant_iter_next(&iter, "y", &vcp_code)) {
+            all_known = vcp_cache_get_last_known(vdu_edid_encoded, vcp_code, flags,
+                                                 &current_value, &max_value, &formatted_value, &age_micros);
+            if (all_known) {
+                g_variant_builder_add(value_array_builder, "(yqqsbu)", vcp_code, current_value, max_value,
+                                      formatted_value, TRUE, (u_int32_t) (age_micros / 1000));
+                g_free(formatted_value);
+            }
+        }
+        if (all_known) {
+            result = g_variant_new("(a(yqqsbu)is)", value_array_builder, DDCRC_OK, message_text);
+        }
+        else {
+            g_variant_builder_clear(value_array_builder);
+        }
+        g_variant_unref(vcp_codes_variant);
+    }
+    else if (vcp_cache_get_last_known(vdu_edid_encoded, vcp_code, flags,
+                                      &current_value, &max_value, &formatted_value, &age_micros)) {
+        result = g_variant_new("(qqsbuis)", current_value, max_value, formatted_value,
+                               TRUE, (u_int32_t) (age_micros / 1000), DDCRC_OK, message_text);
+        g_free(formatted_value);
+    }
+    free(message_text);
+    g_free(vdu_edid_encoded);
+    return result;
+}
+
+/**
+ * @brief Budget timer callback, replies with the last known values if the live read hasn't replied yet.
+ * @param user_data the invocation, the timer holds a reference
+ * @return G_SOURCE_REMOVE
+ */
+static gboolean budget_expired(gpointer user_data) {
+    GDBusMethodInvocation* invocation = user_data;
+    GVariant* result = build_budget_stale_result(invocation);
+    if (result == NULL) {  // Never read, the client will have to wait for the live read.
+        return G_SOURCE_REMOVE;
+    }
+    if (claim_reply(invocation)) {
+        g_info("%s budget expired, replying with last known values",
+               g_dbus_method_invocation_get_method_name(invocation));
+        g_dbus_method_invocation_return_value(g_object_ref(invocation), result);  // Consumes the extra reference
+    }
+    else {
+        g_variant_unref(g_variant_ref_sink(result));
+    }
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * @brief Schedule the live read for a budget read method and start its budget timer.
+ * @param method_name the D-Bus method name
+ * @param parameters inbound parameters, the budget is the second last
+ * @param invocation originating D-Bus method call
+ * @param func the live read function, it must reply via return_budget_result()
+ */
+static void dispatch_budget_read(const gchar* method_name, GVariant* parameters, GDBusMethodInvocation* invocation,
+                                 Scheduled_Method_Func func) {
+    GVariant* budget_variant = g_variant_get_child_value(parameters, g_variant_n_children(parameters) - 2);
+    const u_int32_t budget_millis = g_variant_get_uint32(budget_variant);
+    g_variant_unref(budget_variant);
+    if (budget_millis == 0) {  // No budget, just a live read
+        schedule_call(method_name, invocation, func);
+        return;
+    }
+    g_object_set_data_full(G_OBJECT(invocation), REPLY_CLAIM_DATA, g_new0(Reply_Claim, 1), g_free);
+    g_object_ref(invocation);  // For the timer, taken first in case the live read replies immediately
+    if (schedule_call(method_name, invocation, func)) {
+        g_timeout_add_full(G_PRIORITY_DEFAULT, budget_millis, budget_expired, invocation, g_object_unref);
+    }
+    else {
+        g_object_unref(invocation);
+    }
+}
+
+/**
+ * @brief Emit a VcpValueChanged signal.
+ * @param display_number the display number passed by the client
+ * @param edid_encoded the EDID passed by the client
+ * @param vcp_code the VCP-code that was set
+ * @param new_value the value that was set
+ * @param client_name the D-Bus unique name of the client that set the value
+ * @param client_context the context passed by the client, may be empty
+ * @param signal_flags flags to pass with the signal, zero for an ordinary set
+ */
+static void emit_vcp_value_changed(const int display_number, const char* edid_encoded,
+                                   const uint8_t vcp_code, const uint16_t new_value,
+                                   const char* client_name, const char* client_context,
+                                   const u_int32_t signal_flags) {
+    GError* local_error = NULL;
+    const long start_micros = g_get_monotonic_time();
+    const gboolean emitted = g_dbus_connection_emit_signal(dbus_connection,
+                                                           NULL,
+                                                           "/com/ddcutil/DdcutilObject",
+                                                           "com.ddcutil.DdcutilInterface",
+                                                           "VcpValueChanged",
+                                                           g_variant_new("(isyqssu)",
+                                                                         display_number, edid_encoded, vcp_code,
+                                                                         new_value, client_name, client_context,
+                                                                         signal_flags),
+                                                           &local_error);
+    USDT_PROBE(signal__vcp_value_changed, client_name, display_number, vcp_code, emitted ? DDCRC_OK : DDCRC_OTHER,
+               g_get_monotonic_time() - start_micros);
+    if (!emitted) {
+        g_warning("Signal VcpValueChanged: failed %s", local_error != NULL ? local_error->message : "");
+        g_free(local_error);}
+    else {
+        if (g_log_get_debug_enabled()) {
+            g_debug("Signal VcpValueChanged: succeeded display=%d edid=%.30ss... vcp_code=%d value=%d client=%s "
+                "client_context='%s'", display_number, edid_encoded, vcp_code, new_value, client_name, client_context);
+        }
+    }
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * OSD change watcher
+ *
+ * Changes made with a VDU's own on-screen-display buttons are invisible to the service.  MCCS defines
+ * VCP 0x02 (New Control Value), which a VDU sets to 0x02 when the user changes a control, and 0x52
+ * (Active Control), a FIFO of the codes that changed.  When enabled by --osd-watch-interval, a
+ * background job reads only 0x02 from each display per interval.  When it is set, the job drains 0x52,
+ * reads each changed code, emits VcpValueChanged with the client name "OSD", and resets 0x02.
+ * Displays that don't support 0x02 are skipped until the next display connection event.
+ */
+
+#define VCP_NEW_CONTROL_VALUE 0x02
+#define VCP_ACTIVE_CONTROL 0x52
+#define NEW_CONTROL_VALUE_NONE 0x01
+#define NEW_CONTROL_VALUE_PRESENT 0x02
+#define ACTIVE_CONTROL_FIFO_MAX 16  // Guard against a VDU that never reports an empty FIFO
+#define OSD_CLIENT_NAME "OSD"
+
+static guint osd_watch_interval_seconds = 0;  // Zero to disable
+static GHashTable* osd_unsupported_edids = NULL;  // base64 EDID set
+static GMutex osd_watch_mutex;                    // Protects osd_unsupported_edids
+static gint osd_watch_queued = 0;                 // Atomic, prevents polls piling up behind a slow bus
+
+/**
+ * @brief Check one display for OSD changes, emitting VcpValueChanged for each changed code.
+ * @param vdu_info the display
+ */
+static void osd_watch_display(const DDCA_Display_Info* vdu_info) {
+    gchar* edid_encoded = edid_encode(vdu_info->edid_bytes);
+    g_mutex_lock(&osd_watch_mutex);
+    const gboolean unsupported = g_hash_table_contains(osd_unsupported_edids, edid_encoded);
+    g_mutex_unlock(&osd_watch_mutex);
+    DDCA_Display_Handle disp_handle;
+    if (unsupported || i2c_open_display(vdu_info, &disp_handle) != DDCRC_OK) {
+        g_free(edid_encoded);
+        return;
+    }
+    DDCA_Non_Table_Vcp_Value valrec;
+    DDCA_Status status = i2c_get_non_table_vcp_value(disp_handle, vdu_info, VCP_NEW_CONTROL_VALUE, &valrec);
+    if (status == DDCRC_REPORTED_UNSUPPORTED || status == DDCRC_DETERMINED_UNSUPPORTED) {
+        g_message("OSD watch: display_num=%d edid=%.30s... does not support VCP 0x02, not watching",
+                  vdu_info->dispno, edid_encoded);
+        g_mutex_lock(&osd_watch_mutex);
+        g_hash_table_add(osd_unsupported_edids, g_strdup(edid_encoded));
+        g_mutex_unlock(&osd_watch_mutex);
+    }
+    else if (status == DDCRC_OK && valrec.sl == NEW_CONTROL_VALUE_PRESENT) {
+        for (int i = 0; i < ACTIVE_CONTROL_FIFO_MAX; i++) {
+            if (i2c_get_non_table_vcp_value(disp_handle, vdu_info, VCP_ACTIVE_CONTROL, &valrec) != DDCRC_OK || valrec.sl == 0) {
+                break;
+            }
+            const uint8_t vcp_code = valrec.sl;
+            uint16_t current_value, max_value;
+            char* formatted_value;
+            if (read_vcp_value(disp_handle, vdu_info, vcp_code, 0,
+                               &current_value, &max_value, &formatted_value, NULL) == DDCRC_OK) {
+                g_info("OSD watch: display_num=%d vcp_code=0x%02x changed to %d",
+                       vdu_info->dispno, vcp_code, current_value);
+                emit_vcp_value_changed(vdu_info->dispno, edid_encoded, vcp_code, current_value,
+                                       OSD_CLIENT_NAME, "", 0);
+                g_free(formatted_value);
+            }
+        }
+        i2c_set_non_table_vcp_value(disp_handle, vdu_info, VCP_NEW_CONTROL_VALUE, 0, NEW_CONTROL_VALUE_NONE);
+    }
+    backend->close_display(disp_handle);
+    g_free(edid_encoded);
+}
+
+/**
+ * @brief Background job that checks every display for OSD changes.
+ * @param parameters unused
+ * @param invocation always NULL
+ */
+static void osd_watch_poll(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    DDCA_Display_Info_List* dlist = NULL;
+    if (get_display_info_list(FALSE, &dlist, NULL) == DDCRC_OK) {
+        for (int i = 0; i < dlist->ct; i++) {
+            osd_watch_display(&dlist->info[i]);
+        }
+        backend->free_display_info_list(dlist);
+    }
+    g_atomic_int_set(&osd_watch_queued, 0);
+}
+
+/**
+ * @brief GMainLoop timeout that queues the OSD watch job, unless the previous one is still pending.
+ * @param user_data unused
+ * @return G_SOURCE_CONTINUE
+ */
+static gboolean osd_watch_timeout(gpointer user_data) {
+    if (g_atomic_int_compare_and_exchange(&osd_watch_queued, 0, 1)) {
+        schedule_background(osd_watch_poll, g_variant_new("()"));
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+/**
+ * @brief Forget which displays lack VCP 0x02, called after connection events in case displays have changed.
+ */
+static void osd_watch_reset(void) {
+    g_mutex_lock(&osd_watch_mutex);
+    if (osd_unsupported_edids != NULL) {
+        g_hash_table_remove_all(osd_unsupported_edids);
+    }
+    g_mutex_unlock(&osd_watch_mutex);
+}
+
+/**
+ * @brief Start the OSD watcher if enabled.
+ */
+static void osd_watch_start(void) {
+    if (osd_watch_interval_seconds == 0) {
+        return;
+    }
+    osd_unsupported_edids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    g_timeout_add_seconds(osd_watch_interval_seconds, osd_watch_timeout, NULL);
+    g_message("OSD watch: checking VCP 0x02 every %u seconds", osd_watch_interval_seconds);
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * VCP watches - one shared poll per display for all subscribers
+ *
+ * Clients call WatchVcp to register interest in a display's VCP-code along with the maximum latency
+ * they will accept for hearing of a change.  The service polls each watched display at the tightest
+ * latency requested for it, reading all of the display's watched codes in one background job, and
+ * emits VcpValueChanged, with the client name "WATCH", when a read finds a value that differs from
+ * what the watch last saw.  That holds even if another read, for example, a client's GetVcp, saw the
+ * change first.  Values written by the service's own set methods are already signalled and are marked
+ * in the VCP cache, so they are not signalled again.  Watches are dropped when the subscriber leaves
+ * the bus.
+ */
+
+#define WATCH_MIN_LATENCY_MILLIS 200
+#define WATCH_CLIENT_NAME "WATCH"
+
+typedef struct {
+    gchar* edid_encoded;          // Full base64 EDID, key in watch_table
+    int display_number;           // Display number when the first watch was registered, for signals
+    GHashTable* subscriptions;    // "sender:code" -> GUINT_TO_POINTER(max_latency_millis)
+    guint interval_millis;
+    guint source_id;
+    gboolean poll_queued;
+    gboolean seen[256];           // Whether last_values[code] is known
+    uint16_t last_values[256];
+} Watch_Display;
+
+static GHashTable* watch_table = NULL;  // base64 EDID -> Watch_Display
+static GMutex watch_mutex;              // Protects watch_table and its contents
+
+static void watch_display_free(gpointer data) {
+    Watch_Display* watch = data;
+    if (watch->source_id != 0) {
+        g_source_remove(watch->source_id);
+    }
+    g_hash_table_destroy(watch->subscriptions);
+    g_free(watch->edid_encoded);
+    g_free(watch);
+}
+
+/**
+ * @brief Background job that polls a watched display's codes.
+ * @param parameters (s) the display's full base64 encoded EDID
+ * @param invocation always NULL
+ */
+static void watch_poll_display(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    const char* edid_encoded;
+    g_variant_get(parameters, "(&s)", &edid_encoded);
+    gboolean codes[256] = {FALSE};
+    int display_number = -1;
+    g_mutex_lock(&watch_mutex);
+    Watch_Display* watch = watch_table != NULL ? g_hash_table_lookup(watch_table, edid_encoded) : NULL;
+    if (watch != NULL) {
+        watch->poll_queued = FALSE;
+        display_number = watch->display_number;
+        GHashTableIter iter;
+        gpointer key;
+        g_hash_table_iter_init(&iter, watch->subscriptions);
+        while (g_hash_table_iter_next(&iter, &key, NULL)) {
+            codes[atoi(strrchr(key, ':') + 1)] = TRUE;
+        }
+    }
+    g_mutex_unlock(&watch_mutex);
+    if (watch == NULL) {  // Unwatched while queued
+        return;
+    }
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Display_Handle disp_handle;
+    if (get_display_info(-1, edid_encoded, &info_list, &vdu_info, FALSE) == DDCRC_OK
+        && i2c_open_display(vdu_info, &disp_handle) == DDCRC_OK) {
+        for (int vcp_code = 0; vcp_code < 256; vcp_code++) {
+            if (!codes[vcp_code]) {
+                continue;
+            }
+            uint16_t current_value, max_value;
+            char* formatted_value;
+            if (read_vcp_value(disp_handle, vdu_info, vcp_code, 0,
+                               &current_value, &max_value, &formatted_value, NULL) != DDCRC_OK) {
+                continue;  // Probably just asleep or turned off
+            }
+            g_free(formatted_value);
+            const gboolean set_by_service = vcp_cache_value_set_by_service(edid_encoded, vcp_code, current_value);
+            g_mutex_lock(&watch_mutex);
+            watch = g_hash_table_lookup(watch_table, edid_encoded);
+            // Signal if the value differs from what this watch last saw, unless the service set it.
+            const gboolean changed = watch != NULL && watch->seen[vcp_code] && !set_by_service
+                                     && watch->last_values[vcp_code] != current_value;
+            if (watch != NULL) {
+                watch->seen[vcp_code] = TRUE;
+                watch->last_values[vcp_code] = current_value;
+            }
+            g_mutex_unlock(&watch_mutex);
+            if (changed) {
+                emit_vcp_value_changed(display_number, edid_encoded, vcp_code, current_value,
+                                       WATCH_CLIENT_NAME, "", 0);
+            }
+        }
+        backend->close_display(disp_handle);
+    }
+    backend->free_display_info_list(info_list);
+}
+
+static gboolean watch_timeout(gpointer user_data) {
+    Watch_Display* watch = user_data;
+    g_mutex_lock(&watch_mutex);
+    const gboolean queue = !watch->poll_queued;
+    watch->poll_queued = TRUE;
+    g_mutex_unlock(&watch_mutex);
+    if (queue) {  // Don't let polls pile up behind a slow or busy bus
+        schedule_background(watch_poll_display, g_variant_new("(s)", watch->edid_encoded));
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+/**
+ * @brief Reschedule a display's poll at the tightest latency of its watches.  Requires watch_mutex.
+ * @param watch the display's watches
+ */
+static void watch_reschedule(Watch_Display* watch) {
+    guint interval_millis = G_MAXUINT;
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, watch->subscriptions);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        interval_millis = MIN(interval_millis, GPOINTER_TO_UINT(value));
+    }
+    if (interval_millis != watch->interval_millis) {
+        if (watch->source_id != 0) {
+            g_source_remove(watch->source_id);
+        }
+        watch->interval_millis = interval_millis;
+        watch->source_id = g_timeout_add(interval_millis, watch_timeout, watch);
+        g_info("Watch: polling edid=%.30s... every %ums", watch->edid_encoded, interval_millis);
+    }
+}
+
+/**
+ * @brief Drop all the watches of a sender that has left the bus.
+ * @param sender the sender's unique name
+ */
+static void watch_drop_sender(const gchar* sender) {
+    gchar* prefix = g_strconcat(sender, ":", NULL);
+    g_mutex_lock(&watch_mutex);
+    if (watch_table != NULL) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, watch_table);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            Watch_Display* watch = value;
+            GHashTableIter sub_iter;
+            gpointer key;
+            g_hash_table_iter_init(&sub_iter, watch->subscriptions);
+            while (g_hash_table_iter_next(&sub_iter, &key, NULL)) {
+                if (g_str_has_prefix(key, prefix)) {
+                    g_hash_table_iter_remove(&sub_iter);
+                }
+            }
+            if (g_hash_table_size(watch->subscriptions) == 0) {
+                g_hash_table_iter_remove(&iter);  // Frees the watch
+            }
+            else {
+                watch_reschedule(watch);
+            }
+        }
+    }
+    g_mutex_unlock(&watch_mutex);
+    g_free(prefix);
+}
+
+/**
+ * @brief Implements the DdcutilService WatchVcp and UnwatchVcp methods
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ * @param watch TRUE for WatchVcp, FALSE for UnwatchVcp
+ */
+static void watch_vcp(GVariant* parameters, GDBusMethodInvocation* invocation, const gboolean watch) {
+    int display_number;
+    char* edid_encoded;
+    uint8_t vcp_code;
+    u_int32_t max_latency_millis = 0;
+    u_int32_t flags;
+    if (watch) {
+        g_variant_get(parameters, "(isyuu)", &display_number, &edid_encoded, &vcp_code, &max_latency_millis, &flags);
+    }
+    else {
+        g_variant_get(parameters, "(isyu)", &display_number, &edid_encoded, &vcp_code, &flags);
+    }
+    const gchar* sender = g_dbus_method_invocation_get_sender(invocation);
+    g_info("%s vcp_code=%d max_latency=%ums display_num=%d, edid=%.30s... sender=%s",
+           watch ? "WatchVcp" : "UnwatchVcp", vcp_code, max_latency_millis, display_number, edid_encoded, sender);
+
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
+    if (status == DDCRC_OK) {
+        gchar* vdu_edid_encoded = edid_encode(vdu_info->edid_bytes);
+        gchar* key = g_strdup_printf("%s:%d", sender, vcp_code);
+        g_mutex_lock(&watch_mutex);
+        if (watch_table == NULL) {
+            watch_table = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, watch_display_free);
+        }
+        Watch_Display* watch_display = g_hash_table_lookup(watch_table, vdu_edid_encoded);
+        if (watch) {
+            if (watch_display == NULL) {
+                watch_display = g_new0(Watch_Display, 1);
+                watch_display->edid_encoded = g_strdup(vdu_edid_encoded);
+                watch_display->display_number = vdu_info->dispno;
+                watch_display->subscriptions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+                g_hash_table_insert(watch_table, watch_display->edid_encoded, watch_display);
+            }
+            const guint latency = MAX(max_latency_millis, WATCH_MIN_LATENCY_MILLIS);
+            g_hash_table_insert(watch_display->subscriptions, key, GUINT_TO_POINTER(latency));  // Takes the key
+            key = NULL;
+            watch_reschedule(watch_display);
+        }
+        else if (watch_display == NULL || !g_hash_table_remove(watch_display->subscriptions, key)) {
+            status = DDCRC_ARG;  // Not watched by this sender
+        }
+        else if (g_hash_table_size(watch_display->subscriptions) == 0) {
+            g_hash_table_remove(watch_table, vdu_edid_encoded);  // Frees the watch
+        }
+        else {
+            watch_reschedule(watch_display);
+        }
+        g_mutex_unlock(&watch_mutex);
+        g_free(key);
+        g_free(vdu_edid_encoded);
+    }
+    char* message_text = get_status_message(status);
+    g_dbus_method_invocation_return_value(invocation, g_variant_new("(is)", status, message_text));
+    backend->free_display_info_list(info_list);
+    g_free(edid_encoded);
+    free(message_text);
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ * Ramps - smooth transitions scheduled by the service
+ *
+ * Each ramp moves one display's VCP-code from its current value to a target value over a duration.
+ * Each intermediate write runs as a background job on a worker thread, the GMainLoop only times the
+ * steps.  Each step is paced by the measured latency of the previous write, so a slow VDU gets fewer
+ * larger steps rather than a backlog of writes.  The display is opened for each step so that other
+ * method calls can interleave with a running ramp.  Intermediate writes are not verified and don't
+ * signal; VcpValueChanged is emitted when the ramp starts (with the target value) and when it ends.
+ *
+ * ramp_mutex is never held across DDC/I2C I/O.  Cancelling marks the ramp, waits for any write in
+ * progress to finish, so the canceller's own write can't be overtaken by it, and then removes the ramp.
+ * A step timer that fires after its ramp has gone finds nothing to do.
+ */
+
+typedef enum {
+    RAMP_CURVE_LINEAR = 0,
+    RAMP_CURVE_EASE_IN_OUT = 1,
+    RAMP_CURVE_QUADRATIC = 2,  // Slow start, better matches perceived brightness
+} Ramp_Curve_Type;
+
+/**
+ * Bit flags passed in the flags argument of VcpValueChanged signals emitted by ramps.
+ */
+typedef enum {
+    SIGNAL_RAMP_STARTED = 1,    // The value is the ramp's target
+    SIGNAL_RAMP_COMPLETED = 2,
+    SIGNAL_RAMP_CANCELLED = 4,  // The value is the last value written before cancellation
+} Ramp_Signal_Flags_Type;
+
+#define RAMP_MIN_STEP_MILLIS 20
+
+typedef struct {
+    guint id;                     // Unique, passed to ramp_step so it can check the ramp is still live
+    gchar* key;                   // base64 EDID and VCP-code, key in ramp_table
+    gchar* edid_encoded;          // the display's full base64 encoded EDID
+    int display_number;
+    uint8_t vcp_code;
+    uint16_t start_value;
+    uint16_t target_value;
+    uint16_t last_value;          // Last value written
+    uint8_t curve;
+    u_int32_t flags;
+    long start_micros;
+    long duration_micros;
+    gboolean step_running;        // A step's write is in progress on a worker thread
+    gboolean cancelled;           // Being cancelled, the step in progress must not continue the ramp
+    gchar* client_name;
+} Ramp;
+
+static GHashTable* ramp_table = NULL;  // key -> Ramp
+static GMutex ramp_mutex;              // Protects ramp_table and the ramps in it
+static GCond ramp_cond;                // Signalled when a step's write finishes
+static guint ramp_id_counter = 0;
+
+static void ramp_free(gpointer data) {
+    Ramp* ramp = data;
+    g_free(ramp->key);
+    g_free(ramp->edid_encoded);
+    g_free(ramp->client_name);
+    g_free(ramp);
+}
+
+/**
+ * @brief Cancel a running ramp for a display's VCP-code, if any.  Requires ramp_mutex.
+ *
+ * Waits for a step's write in progress to finish, so must not be called from the GMainLoop.
+ *
+ * @param edid_encoded the display's full base64 encoded EDID
+ * @param vcp_code the VCP-code
+ */
+static void ramp_cancel_locked(const char* edid_encoded, const uint8_t vcp_code) {
+    if (ramp_table == NULL) {
+        return;
+    }
+    gchar* key = g_strdup_printf("%s:%d", edid_encoded, vcp_code);
+    Ramp* ramp;
+    while ((ramp = g_hash_table_lookup(ramp_table, key)) != NULL && ramp->step_running) {
+        ramp->cancelled = TRUE;
+        g_cond_wait(&ramp_cond, &ramp_mutex);
+    }
+    if (ramp != NULL) {
+        g_info("RampVcp cancelled vcp_code=%d display_num=%d at value=%d",
+               ramp->vcp_code, ramp->display_number, ramp->last_value);
+        emit_vcp_value_changed(ramp->display_number, ramp->edid_encoded, ramp->vcp_code, ramp->last_value,
+                               ramp->client_name, "", SIGNAL_RAMP_CANCELLED);
+        g_hash_table_remove(ramp_table, key);  // Frees the ramp
+    }
+    g_free(key);
+}
+
+/**
+ * @brief Cancel a running ramp for a display's VCP-code, if any.  Can be called from any worker thread.
+ * @param edid_encoded the display's full base64 encoded EDID
+ * @param vcp_code the VCP-code
+ */
+static void ramp_cancel(const char* edid_encoded, const uint8_t vcp_code) {
+    g_mutex_lock(&ramp_mutex);
+    ramp_cancel_locked(edid_encoded, vcp_code);
+    g_mutex_unlock(&ramp_mutex);
+}
+
+static gboolean ramp_has_id(gpointer key, gpointer value, gpointer user_data) {
+    return ((Ramp*) value)->id == GPOINTER_TO_UINT(user_data);
+}
+
+/**
+ * @brief Map the linear progress of a ramp through its curve.
+ * @param curve the Ramp_Curve_Type
+ * @param t progress from 0.0 to 1.0
+ * @return eased progress from 0.0 to 1.0
+ */
+static double ramp_curve(const uint8_t curve, const double t) {
+    switch (curve) {
+        case RAMP_CURVE_EASE_IN_OUT:
+            return t * t * (3.0 - 2.0 * t);
+        case RAMP_CURVE_QUADRATIC:
+            return t * t;
+        default:
+            return t;
+    }
+}
+
+static gboolean ramp_step_timeout(gpointer user_data);
+
+/**
+ * @brief Background job that performs one step of a ramp and schedules the next.
+ * @param parameters (u) the Ramp's id
+ * @param invocation NULL, background job
+ */
+static void ramp_step(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    guint id;
+    g_variant_get(parameters, "(u)", &id);
+    g_mutex_lock(&ramp_mutex);
+    Ramp* ramp = ramp_table != NULL ? g_hash_table_find(ramp_table, ramp_has_id, GUINT_TO_POINTER(id)) : NULL;
+    if (ramp == NULL || ramp->cancelled) {  // Cancelled while this step was waiting to run
+        g_mutex_unlock(&ramp_mutex);
+        return;
+    }
+    const long now = g_get_monotonic_time();
+    const double t = ramp->duration_micros <= 0 ? 1.0 : MIN(1.0, (double) (now - ramp->start_micros) / ramp->duration_micros);
+    const gboolean final_step = t >= 1.0;
+    const uint16_t value = final_step
+        ? ramp->target_value
+        : (uint16_t) (ramp->start_value + (ramp->target_value - ramp->start_value) * ramp_curve(ramp->curve, t) + 0.5);
+    const gboolean write_needed = value != ramp->last_value || final_step;
+    // Copied, so that the lock needn't be held during the write.
+    gchar* edid_encoded = g_strdup(ramp->edid_encoded);
+    const uint8_t vcp_code = ramp->vcp_code;
+    const u_int32_t flags = ramp->flags;
+    ramp->step_running = TRUE;
+    g_mutex_unlock(&ramp_mutex);
+
+    DDCA_Status status = DDCRC_OK;
+    long write_micros = 0;
+    if (write_needed) {
+        DDCA_Display_Info_List* info_list = NULL;
+        DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+        status = get_display_info(-1, edid_encoded, &info_list, &vdu_info, FALSE);
+        if (status == DDCRC_OK) {
+            DDCA_Display_Handle disp_handle;
+            status = i2c_open_display(vdu_info, &disp_handle);
+            if (status == DDCRC_OK) {
+                // Only verify the final value
+                ddca_enable_verify(final_step && !(flags & NO_VERIFY));
+                const long write_start = g_get_monotonic_time();
+                status = i2c_set_non_table_vcp_value(disp_handle, vdu_info, vcp_code, value >> 8, value & 0x00ff);
+                write_micros = g_get_monotonic_time() - write_start;
+                backend->close_display(disp_handle);
+                if (status == DDCRC_OK) {
+                    vcp_cache_store_set_value(edid_encoded, vdu_info->dref, vcp_code, value);
+                }
+            }
+        }
+        backend->free_display_info_list(info_list);
+    }
+    g_free(edid_encoded);
+
+    g_mutex_lock(&ramp_mutex);
+    // Still in the table, a canceller waits for step_running to clear before removing it.
+    ramp->step_running = FALSE;
+    if (status == DDCRC_OK) {
+        ramp->last_value = value;
+    }
+    if (ramp->cancelled) {
+        g_debug("RampVcp step for vcp_code=%d display_num=%d finished after cancellation",
+                ramp->vcp_code, ramp->display_number);  // The canceller signals and removes the ramp
+    }
+    else if (final_step || status != DDCRC_OK) {
+        if (status != DDCRC_OK) {
+            // Probably just asleep or turned off
+            g_info("RampVcp failed for vcp_code=%d display_num=%d value=%d status=%d",
+                   ramp->vcp_code, ramp->display_number, value, status);
+        }
+        emit_vcp_value_changed(ramp->display_number, ramp->edid_encoded, ramp->vcp_code, ramp->last_value,
+                               ramp->client_name, "",
+                               status == DDCRC_OK ? SIGNAL_RAMP_COMPLETED : SIGNAL_RAMP_CANCELLED);
+        g_hash_table_remove(ramp_table, ramp->key);  // Frees the ramp
+    }
+    else {
+        // Pace the next step to the VDU, giving other method calls a chance to run in between.
+        const guint interval_millis = MAX(RAMP_MIN_STEP_MILLIS, write_micros / 1000);
+        g_timeout_add(interval_millis, ramp_step_timeout, GUINT_TO_POINTER(id));
+    }
+    g_cond_broadcast(&ramp_cond);
+    g_mutex_unlock(&ramp_mutex);
+}
+
+/**
+ * @brief Timeout callback that queues the next step of a ramp for a worker thread.
+ * @param user_data the Ramp's id
+ * @return G_SOURCE_REMOVE, each step schedules its successor
+ */
+static gboolean ramp_step_timeout(gpointer user_data) {
+    schedule_background(ramp_step, g_variant_new("(u)", GPOINTER_TO_UINT(user_data)));
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * @brief Implements the DdcutilService RampVcp method
+ *
+ * Starts a ramp for each of the displays passed, replacing any ramp already running
+ * for the same display and VCP-code.  Returns once the ramps have started.
+ *
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void ramp_vcp(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    GVariantIter* display_iter;
+    uint8_t vcp_code;
+    uint16_t target_value;
+    u_int32_t duration_millis;
+    uint8_t curve;
+    u_int32_t flags;
+    g_variant_get(parameters, "(a(is)yquyu)", &display_iter, &vcp_code, &target_value, &duration_millis, &curve, &flags);
+
+    g_info("RampVcp vcp_code=%d target=%d duration=%ums curve=%d displays=%" G_GSIZE_FORMAT,
+           vcp_code, target_value, duration_millis, curve, g_variant_iter_n_children(display_iter));
+
+    g_mutex_lock(&ramp_mutex);
+    if (ramp_table == NULL) {
+        ramp_table = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, ramp_free);
+    }
+    g_mutex_unlock(&ramp_mutex);
+    GVariantBuilder results_builder_instance;
+    GVariantBuilder* results_builder = &results_builder_instance;
+    g_variant_builder_init(results_builder, G_VARIANT_TYPE("a(isqi)"));
+
+    DDCA_Status status = DDCRC_OK;
+    const gchar* client_name = g_dbus_method_invocation_get_sender(invocation);
+    int display_number;
+    char* edid_encoded;
+    while (g_variant_iter_next(display_iter, "(is)", &display_number, &edid_encoded)) {
+        uint16_t start_value = 0;
+        uint16_t max_value = 0;
+        DDCA_Display_Info_List* info_list = NULL;
+        DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+        DDCA_Status display_status = curve > RAMP_CURVE_QUADRATIC
+                                     ? DDCRC_ARG
+                                     : get_display_info(display_number, edid_encoded, &info_list, &vdu_info,
+                                                        flags & EDID_PREFIX);
+        if (display_status == DDCRC_OK) {
+            DDCA_Display_Handle disp_handle;
+            display_status = i2c_open_display(vdu_info, &disp_handle);
+            if (display_status == DDCRC_OK) {
+                char* formatted_value;
+                display_status = read_vcp_value(disp_handle, vdu_info, vcp_code, flags,
+                                                &start_value, &max_value, &formatted_value, NULL);
+                g_free(formatted_value);
+                backend->close_display(disp_handle);
+            }
+        }
+        if (display_status == DDCRC_OK) {
+            gchar* vdu_edid_encoded = edid_encode(vdu_info->edid_bytes);
+            g_mutex_lock(&ramp_mutex);
+            ramp_cancel_locked(vdu_edid_encoded, vcp_code);
+            Ramp* ramp = g_new0(Ramp, 1);
+            ramp->id = ++ramp_id_counter;
+            ramp->key = g_strdup_printf("%s:%d", vdu_edid_encoded, vcp_code);
+            ramp->edid_encoded = vdu_edid_encoded;
+            ramp->display_number = vdu_info->dispno;
+            ramp->vcp_code = vcp_code;
+            ramp->start_value = start_value;
+            ramp->last_value = start_value;
+            ramp->target_value = MIN(target_value, max_value);
+            ramp->curve = curve;
+            ramp->flags = flags;
+            ramp->start_micros = g_get_monotonic_time();
+            ramp->duration_micros = (long) duration_millis * 1000;
+            ramp->client_name = g_strdup(client_name);
+            g_timeout_add(RAMP_MIN_STEP_MILLIS, ramp_step_timeout, GUINT_TO_POINTER(ramp->id));
+            g_hash_table_insert(ramp_table, ramp->key, ramp);
+            emit_vcp_value_changed(ramp->display_number, ramp->edid_encoded, vcp_code, ramp->target_value,
+                                   client_name, "", SIGNAL_RAMP_STARTED);
+            g_mutex_unlock(&ramp_mutex);
+        }
+        else {
+            // Probably just asleep or turned off
+            g_info("RampVcp failed to start for vcp_code=%d display_num=%d edid=%.30s... status=%d",
+                   vcp_code, display_number, edid_encoded, display_status);
+            if (status == DDCRC_OK) {
+                status = display_status;  // Report the first failure overall
+            }
+        }
+        g_variant_builder_add(results_builder, "(isqi)", display_number, edid_encoded, start_value, display_status);
+        backend->free_display_info_list(info_list);
+        g_free(edid_encoded);
+    }
+    g_variant_iter_free(display_iter);
+
+    char* message_text = get_status_message(status);
+    GVariant* result = g_variant_new("(a(isqi)is)", results_builder, status, message_text);
+    g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result
+    free(message_text);
+}
+
+/**
+ * @brief Implements the DdcutilService SetVCP method
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ * @param with_client_context whether the invocation includes a client-context string.
+ */
+static void set_vcp(GVariant* parameters, GDBusMethodInvocation* invocation, const bool with_client_context) {
+    int display_number;
+    char* edid_encoded;
+    uint8_t vcp_code;
+    uint16_t new_value;
+    u_int32_t flags;
+    char* client_context;
+    char* call_name;
+
+    if (with_client_context) {
+        call_name = "SetVcpWithContext";
+        g_variant_get(parameters, "(isyqsu)",
+                      &display_number, &edid_encoded, &vcp_code, &new_value, &client_context, &flags);
+    }
+    else {
+        call_name = "SetVcp";
+        g_variant_get(parameters, "(isyqu)", &display_number, &edid_encoded, &vcp_code, &new_value, &flags);
+        client_context = g_strdup("");
+    }
+
+    const bool verify = !(flags & NO_VERIFY);
+    // Always explicitly default to verify - ensures all libddcutil versions behave the same way
+    ddca_enable_verify(verify);
+
+    g_info("%s vcp_code=%d value=%d display_num=%d edid=%.30s... verify=%s client_context='%s'",
+           call_name, vcp_code, new_value, display_number, edid_encoded, BOOL_STR(verify), client_context);
+
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
+    if (status == DDCRC_OK) {
+        gchar* vdu_edid_encoded = edid_encode(vdu_info->edid_bytes);
+        ramp_cancel(vdu_edid_encoded, vcp_code);  // An explicit set overrides any ramp in progress
+        g_free(vdu_edid_encoded);
+        DDCA_Display_Handle disp_handle;
+        status = i2c_open_display(vdu_info, &disp_handle);
+        if (status == DDCRC_OK) {
+            const uint8_t low_byte = new_value & 0x00ff;
+            const uint8_t high_byte = new_value >> 8;
+            status = i2c_set_non_table_vcp_value(disp_handle, vdu_info, vcp_code, high_byte, low_byte);
+            backend->close_display(disp_handle);
+            if (status == DDCRC_OK) {
+                gchar* vdu_edid_encoded = edid_encode(vdu_info->edid_bytes);
+                vcp_cache_store_set_value(vdu_edid_encoded, vdu_info->dref, vcp_code, new_value);
+                g_free(vdu_edid_encoded);
+            }
+        }
+    }
+    if (status == DDCRC_OK) {
+        emit_vcp_value_changed(display_number, edid_encoded, vcp_code, new_value,
+                               g_dbus_method_invocation_get_sender(invocation), client_context, 0);
+    }
+    else {
+        // Probably just asleep or turned off
+        g_info("%s failed for vcp_code=%d value=%d display_num=%d edid=%.30s...",
+               call_name, vcp_code, new_value, display_number, edid_encoded);
+    }
+    char* message_text = get_status_message(status);
+    GVariant* result = g_variant_new("(is)", status, message_text);
+    g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result
+    backend->free_display_info_list(info_list);
+    g_free(edid_encoded);
+    g_free(client_context);
+    free(message_text);
+}
+
+/**
+ * @brief Emit a VcpValuesChanged signal for several values set on one display.
+ * @param display_number the display number passed by the client
+ * @param edid_encoded the EDID passed by the client
+ * @param vcp_codes the VCP-codes that were set
+ * @param new_values the values that were set
+ * @param statuses per-code statuses, only codes with DDCRC_OK are included
+ * @param number_of_values the number of codes
+ * @param client_name the D-Bus unique name of the client that set the values
+ * @param client_context the context passed by the client, may be empty
+ */
+static void emit_vcp_values_changed(const int display_number, const char* edid_encoded,
+                                    const uint8_t* vcp_codes, const uint16_t* new_values,
+                                    const DDCA_Status* statuses, const int number_of_values,
+                                    const char* client_name, const char* client_context) {
+    GVariantBuilder value_array_builder_instance;
+    GVariantBuilder* value_array_builder = &value_array_builder_instance;
+    g_variant_builder_init(value_array_builder, G_VARIANT_TYPE("a(yq)"));
+    int changed_count = 0;
+    for (int i = 0; i < number_of_values; i++) {
+        if (statuses[i] == DDCRC_OK) {
+            g_variant_builder_add(value_array_builder, "(yq)", vcp_codes[i], new_values[i]);
+            changed_count++;
+        }
+    }
+    if (changed_count == 0) {
+        g_variant_builder_clear(value_array_builder);
+        return;
+    }
+    GError* local_error = NULL;
+    const long start_micros = g_get_monotonic_time();
+    const gboolean emitted = g_dbus_connection_emit_signal(dbus_connection,
+                                                           NULL,
+                                                           "/com/ddcutil/DdcutilObject",
+                                                           "com.ddcutil.DdcutilInterface",
+                                                           "VcpValuesChanged",
+                                                           g_variant_new("(isa(yq)ssu)",
+                                                                         display_number, edid_encoded,
+                                                                         value_array_builder,
+                                                                         client_name, client_context, 0),
+                                                           &local_error);
+    USDT_PROBE(signal__vcp_values_changed, client_name, display_number, 0, emitted ? DDCRC_OK : DDCRC_OTHER,
+               g_get_monotonic_time() - start_micros);
+    if (!emitted) {
+        g_warning("Signal VcpValuesChanged: failed %s", local_error != NULL ? local_error->message : "");
+        g_free(local_error);
+    }
+    else {
+        if (g_log_get_debug_enabled()) {
+            g_debug("Signal VcpValuesChanged: succeeded display=%d edid=%.30ss... count=%d client=%s "
+                "client_context='%s'", display_number, edid_encoded, changed_count, client_name, client_context);
+        }
+    }
+}
+
+/**
+ * @brief Read back a VCP value to check that a write took effect.
+ *
+ * For Simple Non-Continuous features only the low byte is compared (the high byte may be garbage).
+ *
+ * @param disp_handle open display handle
+ * @param vdu_info the display's info
+ * @param vcp_code the VCP-code that was written
+ * @param new_value the value that was written
+ * @return DDCRC_OK if matched, DDCRC_VERIFY if not, or the status of a failed read
+ */
+static DDCA_Status verify_vcp_value(DDCA_Display_Handle disp_handle, const DDCA_Display_Info* vdu_info,
+                                    const uint8_t vcp_code, const uint16_t new_value) {
+    DDCA_Non_Table_Vcp_Value valrec;
+    DDCA_Status status = i2c_read_non_table_vcp_value(disp_handle, vdu_info, vcp_code, &valrec, "verify");
+    if (status == DDCRC_OK) {
+        DDCA_Feature_Metadata* metadata_ptr;
+        status = i2c_get_feature_metadata_by_dh(disp_handle, vdu_info, vcp_code, true, &metadata_ptr);
+        if (status == DDCRC_OK) {
+            const gboolean is_simple_nc = (DDCA_SIMPLE_NC & metadata_ptr->feature_flags) != 0;
+            ddca_free_feature_metadata(metadata_ptr);
+            if (valrec.sl != (new_value & 0x00ff) || (!is_simple_nc && valrec.sh != new_value >> 8)) {
+                status = DDCRC_VERIFY;
+            }
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief Write several VCP values to one display on a single open handle.
+ *
+ * Each write is performed without libddcutil verify and retry.  Unless NO_VERIFY is passed, all the
+ * values are read back once the writes are complete, a mismatch results in DDCRC_VERIFY for that code.
+ * Any ramps running for the codes are cancelled first, an explicit set overrides them.  Must be called
+ * from a worker thread, cancelling a ramp may wait for its step in progress.
+ *
+ * @param vdu_info the display's info
+ * @param vcp_codes the VCP-codes to set
+ * @param new_values the values to set
+ * @param number_of_values the number of codes
+ * @param flags method flags (checked for NO_VERIFY)
+ * @param statuses output per-code statuses
+ * @return DDCRC_OK if all succeeded, otherwise the first failure
+ */
+static DDCA_Status write_vcp_values(const DDCA_Display_Info* vdu_info,
+                                    const uint8_t* vcp_codes, const uint16_t* new_values, const int number_of_values,
+                                    const u_int32_t flags, DDCA_Status* statuses) {
+    gchar* edid_encoded = edid_encode(vdu_info->edid_bytes);
+    for (int i = 0; i < number_of_values; i++) {
+        ramp_cancel(edid_encoded, vcp_codes[i]);
+    }
+    DDCA_Display_Handle disp_handle;
+    DDCA_Status status = i2c_open_display(vdu_info, &disp_handle);
+    if (status != DDCRC_OK) {
+        for (int i = 0; i < number_of_values; i++) {
+            statuses[i] = status;
+        }
+        g_free(edid_encoded);
+        return status;
+    }
+    ddca_enable_verify(false);  // Verify at the end, not per write
+    for (int i = 0; i < number_of_values; i++) {
+        statuses[i] = i2c_set_non_table_vcp_value(disp_handle, vdu_info, vcp_codes[i], new_values[i] >> 8, new_values[i] & 0x00ff);
+        if (statuses[i] == DDCRC_OK) {
+            vcp_cache_store_set_value(edid_encoded, vdu_info->dref, vcp_codes[i], new_values[i]);
+        }
+    }
+    if (!(flags & NO_VERIFY)) {
+        for (int i = 0; i < number_of_values; i++) {
+            if (statuses[i] == DDCRC_OK) {
+                statuses[i] = verify_vcp_value(disp_handle, vdu_info, vcp_codes[i], new_values[i]);
+                if (statuses[i] != DDCRC_OK) {
+                    g_info("Verify failed for vcp_code=%d display_num=%d value=%d status=%d",
+                           vcp_codes[i], vdu_info->dispno, new_values[i], statuses[i]);
+                }
+            }
+        }
+    }
+    backend->close_display(disp_handle);
+    g_free(edid_encoded);
+    for (int i = 0; i < number_of_values; i++) {
+        if (statuses[i] != DDCRC_OK) {
+            status = statuses[i];
+            break;
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief Implements the DdcutilService SetMultipleVcp method
+ *
+ * Sets several VCP values on one display using a single open handle, then emits
+ * one VcpValuesChanged signal for all the values successfully set.
+ *
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void set_multiple_vcp(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    int display_number;
+    char* edid_encoded;
+    u_int32_t flags;
+
+    GVariantIter* vcp_value_iter;
+    g_variant_get(parameters, "(isa(yq)u)", &display_number, &edid_encoded, &vcp_value_iter, &flags);
+
+    g_info("SetMultipleVcp display_num=%d, edid=%.30s... verify=%s",
+           display_number, edid_encoded, BOOL_STR(!(flags & NO_VERIFY)));
+
+    const gsize number_of_values = g_variant_iter_n_children(vcp_value_iter);
+    uint8_t vcp_codes[number_of_values + 1];  // +1 avoids a zero length array
+    uint16_t new_values[number_of_values + 1];
+    DDCA_Status statuses[number_of_values + 1];
+    for (int i = 0; g_variant_iter_loop(vcp_value_iter, "(yq)", &vcp_codes[i], &new_values[i]); i++) {
+    }
+    g_variant_iter_free(vcp_value_iter);
+
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
+    if (status == DDCRC_OK) {
+        status = write_vcp_values(vdu_info, vcp_codes, new_values, number_of_values, flags, statuses);
+        emit_vcp_values_changed(display_number, edid_encoded, vcp_codes, new_values, statuses, number_of_values,
+                                g_dbus_method_invocation_get_sender(invocation), "");
+    }
+    else {
+        for (int i = 0; i < number_of_values; i++) {
+            statuses[i] = status;
+        }
+    }
+    if (status != DDCRC_OK) {
+        // Probably just asleep or turned off
+        g_info("SetMultipleVcp failed for display_num=%d edid=%.30s... status=%d",
+               display_number, edid_encoded, status);
+    }
+    GVariantBuilder status_array_builder_instance;
+    GVariantBuilder* status_array_builder = &status_array_builder_instance;
+    g_variant_builder_init(status_array_builder, G_VARIANT_TYPE("a(yi)"));
+    for (int i = 0; i < number_of_values; i++) {
+        g_variant_builder_add(status_array_builder, "(yi)", vcp_codes[i], statuses[i]);
+    }
+    char* message_text = get_status_message(status);
+    GVariant* result = g_variant_new("(a(yi)is)", status_array_builder, status, message_text);
+    g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result
+    backend->free_display_info_list(info_list);
+    g_free(edid_encoded);
+    free(message_text);
+}
+
+/**
+ * Operations that can be passed to the Execute method.
+ */
+typedef enum {
+    EXECUTE_GET_VCP = 0,
+    EXECUTE_SET_VCP = 1,
+} Execute_Op_Type;
+
+/**
+ * One operation in an Execute batch, along with its result.
+ */
+typedef struct {
+    int display_number;
+    gchar* edid_encoded;
+    uint8_t op;
+    uint8_t vcp_code;
+    uint16_t value;               // Value to set, or value returned by a get
+    u_int32_t flags;
+    uint16_t max_value;
+    gchar* formatted_value;
+    DDCA_Status status;
+} Execute_Op;
+
+/**
+ * The operations in an Execute batch that target one display, in the order they were passed.
+ */
+typedef struct {
+    gchar* edid_encoded;          // the display's full base64 encoded EDID
+    GPtrArray* ops;               // of Execute_Op*, not owned
+} Execute_Group;
+
+/**
+ * The state of an Execute call while its groups are run by the workers.
+ */
+typedef struct {
+    Execute_Op* ops;
+    gsize number_of_ops;
+    Execute_Group* groups;
+    guint number_of_groups;
+    gpointer* tasks;              // Pointers to the groups, for schedule_task_group()
+    gchar* client_name;
+    gchar* client_context;
+} Execute_Call;
+
+static void execute_call_free(Execute_Call* call) {
+    for (int i = 0; i < call->number_of_ops; i++) {
+        g_free(call->ops[i].edid_encoded);
+        g_free(call->ops[i].formatted_value);
+    }
+    for (int i = 0; i < call->number_of_groups; i++) {
+        g_free(call->groups[i].edid_encoded);
+        g_ptr_array_free(call->groups[i].ops, TRUE);
+    }
+    g_free(call->ops);
+    g_free(call->groups);
+    g_free(call->tasks);
+    g_free(call->client_name);
+    g_free(call->client_context);
+    g_free(call);
+}
+
+/**
+ * @brief Task that performs the operations for one display on a single open handle.
+ * @param group the Execute call's task group
+ * @param task an Execute_Group
+ */
+static void execute_group_task(Task_Group* group, gpointer task) {
+    const Execute_Group* execute_group = task;
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    DDCA_Display_Handle disp_handle;
+    DDCA_Status open_status = get_display_info(-1, execute_group->edid_encoded, &info_list, &vdu_info, FALSE);
+    if (open_status == DDCRC_OK) {
+        open_status = i2c_open_display(vdu_info, &disp_handle);
+    }
+    for (int i = 0; i < execute_group->ops->len; i++) {
+        Execute_Op* op = g_ptr_array_index(execute_group->ops, i);
+        if (open_status != DDCRC_OK) {
+            op->status = open_status;
+            continue;
+        }
+        if (op->op == EXECUTE_GET_VCP) {
+            op->status = read_vcp_value(disp_handle, vdu_info, op->vcp_code, op->flags,
+                                        &op->value, &op->max_value, &op->formatted_value, NULL);
+        }
+        else {
+            ramp_cancel(execute_group->edid_encoded, op->vcp_code);  // An explicit set overrides any ramp in progress
+            // Verify is thread-local in libddcutil, so each op can have its own setting.
+            ddca_enable_verify(!(op->flags & NO_VERIFY));
+            op->status = i2c_set_non_table_vcp_value(disp_handle, vdu_info, op->vcp_code, op->value >> 8, op->value & 0x00ff);
+            if (op->status == DDCRC_OK) {
+                vcp_cache_store_set_value(execute_group->edid_encoded, vdu_info->dref, op->vcp_code, op->value);
+            }
+        }
+        if (op->status != DDCRC_OK) {
+            // Probably just asleep or turned off
+            g_info("Execute %s failed for vcp_code=%d display_num=%d status=%d",
+                   op->op == EXECUTE_GET_VCP ? "get" : "set", op->vcp_code, op->display_number, op->status);
+        }
+    }
+    if (open_status == DDCRC_OK) {
+        backend->close_display(disp_handle);
+    }
+    backend->free_display_info_list(info_list);
+}
+
+/**
+ * @brief Reply to an Execute call once all of its groups have run, and signal its successful sets.
+ * @param group the Execute call's task group
+ */
+static void execute_finish(Task_Group* group) {
+    Execute_Call* call = group->data;
+    Execute_Op* ops = call->ops;
+    DDCA_Status status = DDCRC_OK;
+    GVariantBuilder result_array_builder_instance;
+    GVariantBuilder* result_array_builder = &result_array_builder_instance;
+    g_variant_builder_init(result_array_builder, G_VARIANT_TYPE("a(yqqsis)"));
+    for (int i = 0; i < call->number_of_ops; i++) {
+        if (status == DDCRC_OK && ops[i].status != DDCRC_OK) {
+            status = ops[i].status;  // Report the first failure overall
+        }
+        if (ops[i].op == EXECUTE_GET_VCP && ops[i].status != DDCRC_OK) {
+            ops[i].value = 0;  // Not the value passed in, which is meaningless for a get
+            ops[i].max_value = 0;
+        }
+        char* op_message_text = get_status_message(ops[i].status);
+        g_variant_builder_add(result_array_builder, "(yqqsis)",
+                              ops[i].vcp_code, ops[i].value, ops[i].max_value,
+                              ops[i].formatted_value != NULL ? ops[i].formatted_value : "",
+                              ops[i].status, op_message_text);
+        free(op_message_text);
+        if (ops[i].op == EXECUTE_SET_VCP && ops[i].status == DDCRC_OK) {
+            emit_vcp_value_changed(ops[i].display_number, ops[i].edid_encoded, ops[i].vcp_code, ops[i].value,
+                                   call->client_name, call->client_context, 0);
+        }
+    }
+    if (group->invocation != NULL) {
+        char* message_text = get_status_message(status);
+        GVariant* result = g_variant_new("(a(yqqsis)is)", result_array_builder, status, message_text);
+        g_dbus_method_invocation_return_value(group->invocation, result); // Think this frees the result
+        free(message_text);
+    }
+    else {
+        g_variant_builder_clear(result_array_builder);  // Discarded, already answered
+    }
+    execute_call_free(call);
+}
+
+/**
+ * @brief Implements the DdcutilService Execute method
+ *
+ * Performs a batch of gets and sets in one call.  Operations on the same display are
+ * performed in the order passed using a single open handle.  Each display's operations
+ * are queued as one task for the worker threads, so operations on different displays
+ * proceed concurrently.  The reply is sent, and the VcpValueChanged signals for any
+ * successful sets are emitted together, once the whole batch has completed.
+ *
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void execute(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    GVariantIter* op_iter;
+    char* client_context;
+    u_int32_t flags;
+    g_variant_get(parameters, "(a(isyyqu)su)", &op_iter, &client_context, &flags);
+
+    Execute_Call* call = g_new0(Execute_Call, 1);
+    call->number_of_ops = g_variant_iter_n_children(op_iter);
+    call->ops = g_new0(Execute_Op, call->number_of_ops);
+    call->client_name = g_strdup(g_dbus_method_invocation_get_sender(invocation));
+    call->client_context = client_context;
+    Execute_Op* ops = call->ops;
+    for (int i = 0; g_variant_iter_next(op_iter, "(isyyqu)", &ops[i].display_number, &ops[i].edid_encoded,
+                                        &ops[i].op, &ops[i].vcp_code, &ops[i].value, &ops[i].flags); i++) {
+        if (ops[i].op != EXECUTE_GET_VCP && ops[i].op != EXECUTE_SET_VCP) {
+            ops[i].status = DDCRC_ARG;
+        }
+    }
+    g_variant_iter_free(op_iter);
+
+    g_info("Execute operations=%" G_GSIZE_FORMAT " client_context='%s'", call->number_of_ops, client_context);
+
+    DDCA_Display_Info_List* info_list = NULL;
+    const DDCA_Status status = get_display_info_list(0, &info_list, "Execute");
+    if (status == DDCRC_OK) {
+        // Group the operations by display, preserving the order within each group.
+        Execute_Group* groups = g_new0(Execute_Group, info_list->ct);
+        for (int i = 0; i < call->number_of_ops; i++) {
+            if (ops[i].status != DDCRC_OK) {
+                continue;
+            }
+            DDCA_Display_Info* vdu_info = find_display_info(info_list, ops[i].display_number, ops[i].edid_encoded,
+                                                            ops[i].flags & EDID_PREFIX);
+            if (vdu_info == NULL) {
+                ops[i].status = DDCRC_INVALID_DISPLAY;
+                continue;
+            }
+            Execute_Group* execute_group = &groups[vdu_info - info_list->info];
+            if (execute_group->ops == NULL) {
+                execute_group->edid_encoded = edid_encode(vdu_info->edid_bytes);
+                execute_group->ops = g_ptr_array_new();
+            }
+            g_ptr_array_add(execute_group->ops, &ops[i]);
+        }
+        // Compact to the displays that have operations.
+        call->groups = g_new0(Execute_Group, info_list->ct);
+        call->tasks = g_new0(gpointer, info_list->ct);
+        for (int i = 0; i < info_list->ct; i++) {
+            if (groups[i].ops != NULL) {
+                call->groups[call->number_of_groups] = groups[i];
+                call->tasks[call->number_of_groups] = &call->groups[call->number_of_groups];
+                call->number_of_groups++;
+            }
+        }
+        g_free(groups);
+    }
+    else {
+        for (int i = 0; i < call->number_of_ops; i++) {
+            ops[i].status = status;
+        }
+    }
+    backend->free_display_info_list(info_list);
 
-    g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result.
-    free(detect_message_text);
+    if (!schedule_task_group("Execute", invocation, call, execute_group_task, execute_finish,
+                             call->tasks, call->number_of_groups)) {
+        execute_call_free(call);  // Shed, an error has been returned
+    }
 }
 
 /**
- * @brief Implements the DdcutilService GetVcp method
- *
- * Passes a single VCP value to the invocation.
- *
- * @param parameters inbound parameters
- * @param invocation originating D-Bus method call
+ * AdjustVcp calls for the same display and VCP-code that arrive within this interval are accumulated
+ * and applied as one read-modify-write.  Key-repeat typically runs at 25-40 ms, so a burst of repeats
+ * collapses into a single write.
  */
-static void get_vcp(GVariant* parameters, GDBusMethodInvocation* invocation) {
-    int display_number;
-    char* edid_encoded;
+#define ADJUST_COALESCE_MILLIS 50
+
+#define ADJUST_CLIENT_CONTEXT "AdjustVcp"  // The client-context of VcpValueChanged signals from AdjustVcp
+
+/**
+ * Accumulated AdjustVcp calls waiting to be applied to one display's VCP-code.
+ */
+typedef struct {
+    gchar* key;                   // base64 EDID and VCP-code, key in adjust_pending_table
+    gchar* edid_encoded;          // the display's full base64 encoded EDID
     uint8_t vcp_code;
-    u_int32_t flags;
+    int total_delta;              // Sum of the deltas of all held calls
+    gboolean clamp;               // From the most recent call
+    u_int32_t flags;              // From the most recent call
+    gchar* client_name;           // From the most recent call
+    GPtrArray* invocations;       // Held GDBusMethodInvocation*, replied to once the write completes
+    int display_number;           // Results, set by adjust_vcp_task
+    uint16_t new_value;
+    uint16_t max_value;
+    DDCA_Status status;
+} Adjust_Pending;
 
-    g_variant_get(parameters, "(isyu)", &display_number, &edid_encoded, &vcp_code, &flags);
+static GHashTable* adjust_pending_table = NULL;  // key -> Adjust_Pending
 
-    g_info("GetVcp vcp_code=%d display_num=%d, edid=%.30s...", vcp_code, display_number, edid_encoded);
+static void adjust_pending_free(gpointer data) {
+    Adjust_Pending* pending = data;
+    g_free(pending->key);
+    g_free(pending->edid_encoded);
+    g_free(pending->client_name);
+    g_ptr_array_free(pending->invocations, TRUE);
+    g_free(pending);
+}
 
-    uint16_t current_value = 0;
-    uint16_t max_value = 0;
-    char* formatted_value = NULL;
+/**
+ * @brief Task that applies the accumulated delta as one read-modify-write.
+ * @param group the task group, its invocation is the most recent held call
+ * @param task the Adjust_Pending
+ */
+static void adjust_vcp_task(Task_Group* group, gpointer task) {
+    Adjust_Pending* pending = task;
+    ramp_cancel(pending->edid_encoded, pending->vcp_code);  // An explicit change overrides any ramp in progress
 
     DDCA_Display_Info_List* info_list = NULL;
     DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
-    DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
+    DDCA_Status status = get_display_info(-1, pending->edid_encoded, &info_list, &vdu_info, FALSE);
     if (status == DDCRC_OK) {
+        pending->display_number = vdu_info->dispno;
         DDCA_Display_Handle disp_handle;
-        status = ddca_open_display2(vdu_info->dref, 1, &disp_handle);
+        status = i2c_open_display(vdu_info, &disp_handle);
         if (status == DDCRC_OK) {
-            static DDCA_Non_Table_Vcp_Value valrec;
-            status = ddca_get_non_table_vcp_value(disp_handle, vcp_code, &valrec);
+            uint16_t current_value;
+            char* formatted_value;
+            status = read_vcp_value(disp_handle, vdu_info, pending->vcp_code, pending->flags,
+                                    &current_value, &pending->max_value, &formatted_value, NULL);
+            g_free(formatted_value);
             if (status == DDCRC_OK) {
-                DDCA_Feature_Metadata* metadata_ptr;
-                status = ddca_get_feature_metadata_by_dh(vcp_code, disp_handle, true, &metadata_ptr);
-                if (status == DDCRC_OK) {
-                    // Override, return all bytes regardless
-                    const bool return_all_bytes = return_raw_values || flags & RETURN_RAW_VALUES;
-                    const bool low_byte_only = !return_all_bytes && (DDCA_SIMPLE_NC & metadata_ptr->feature_flags);
-                    // For simple non-continuous types the high byte may be garbage for some models of VDU.
-                    current_value = low_byte_only ? valrec.sl : (valrec.sh << 8 | valrec.sl);
-                    max_value = low_byte_only ? valrec.ml : (valrec.mh << 8 | valrec.ml);
-                    status = ddca_format_non_table_vcp_value_by_dref(vcp_code, vdu_info->dref, &valrec,
-                                                                     &formatted_value);
-                    free(metadata_ptr);
+                const int target = current_value + pending->total_delta;
+                if (pending->clamp) {
+                    pending->new_value = CLAMP(target, 0, pending->max_value);
+                }
+                else if (target < 0 || target > pending->max_value) {
+                    status = DDCRC_ARG;
                 }
                 else {
-                    g_warning("GetVcp metadata lookup failed for vcp_code=%d display_num=%d edid=%.30s...",
-                              vcp_code, display_number, edid_encoded);
+                    pending->new_value = target;
                 }
             }
-            ddca_close_display(disp_handle);
-        }
-        else {
-            g_warning("GetVcp open failed for vcp_code=%d display_num=%d edid=%.30s... status=%d",
-                      vcp_code, display_number, edid_encoded, status);
+            if (status == DDCRC_OK && pending->new_value != current_value) {
+                ddca_enable_verify(!(pending->flags & NO_VERIFY));
+                status = i2c_set_non_table_vcp_value(disp_handle, vdu_info, pending->vcp_code,
+                                                     pending->new_value >> 8, pending->new_value & 0x00ff);
+                if (status == DDCRC_OK) {
+                    vcp_cache_store_set_value(pending->edid_encoded, vdu_info->dref, pending->vcp_code,
+                                              pending->new_value);
+                    emit_vcp_value_changed(pending->display_number, pending->edid_encoded, pending->vcp_code,
+                                           pending->new_value, pending->client_name, ADJUST_CLIENT_CONTEXT, 0);
+                }
+            }
+            else if (status == DDCRC_OK) {
+                pending->new_value = current_value;  // Already at the limit, nothing to write
+            }
+            backend->close_display(disp_handle);
         }
     }
+    if (status != DDCRC_OK) {
+        // Probably just asleep or turned off, or out of range without clamping
+        g_info("AdjustVcp failed for vcp_code=%d delta=%d display_num=%d edid=%.30s... status=%d",
+               pending->vcp_code, pending->total_delta, pending->display_number, pending->edid_encoded, status);
+        pending->new_value = 0;
+        pending->max_value = 0;
+    }
     else {
-        g_warning("GetVcp get_display_info failed for vcp_code=%d display_num=%d edid=%.30s...",
-                  vcp_code, display_number, edid_encoded);
+        g_info("AdjustVcp vcp_code=%d delta=%d calls=%d display_num=%d new_value=%d",
+               pending->vcp_code, pending->total_delta, pending->invocations->len, pending->display_number,
+               pending->new_value);
     }
-    char* message_text = get_status_message(status);
-    GVariant* result = g_variant_new(
-        "(qqsis)", current_value, max_value, formatted_value ? formatted_value : "", status, message_text);
-    g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result
-    ddca_free_display_info_list(info_list);
-    if (formatted_value != NULL) {
-        free(formatted_value);
+    pending->status = status;
+    backend->free_display_info_list(info_list);
+}
+
+/**
+ * @brief Reply to all the held AdjustVcp calls once the write has completed.
+ * @param group the task group
+ */
+static void adjust_vcp_finish(Task_Group* group) {
+    Adjust_Pending* pending = group->data;
+    char* message_text = get_status_message(pending->status);
+    // The most recent call is the group's invocation, it was answered already if the group was discarded.
+    const guint held = group->invocation != NULL ? pending->invocations->len : pending->invocations->len - 1;
+    for (int i = 0; i < held; i++) {
+        GDBusMethodInvocation* invocation = g_ptr_array_index(pending->invocations, i);
+        if (group->invocation == NULL) {
+            task_group_return_discarded(group, invocation);
+        }
+        else {
+            GVariant* result = g_variant_new("(qqis)", pending->new_value, pending->max_value, pending->status,
+                                             message_text);
+            g_dbus_method_invocation_return_value(invocation, result);
+        }
     }
-    free(edid_encoded);
     free(message_text);
+    adjust_pending_free(pending);
 }
 
 /**
- * @brief Implements the DdcutilService GetMultipleVcp method
+ * @brief Timeout callback that queues the accumulated delta for a worker thread.
  *
- * Passes back an array of VCP values to the invocation.
+ * The write is queued as the most recent held call, so its sender's fairness, PRIORITY flag and
+ * deadline apply.
+ *
+ * @param user_data the Adjust_Pending
+ * @return G_SOURCE_REMOVE, one shot
+ */
+static gboolean adjust_vcp_apply(gpointer user_data) {
+    Adjust_Pending* pending = user_data;
+    g_hash_table_steal(adjust_pending_table, pending->key);  // Further calls will start a new accumulation
+    GDBusMethodInvocation* latest = g_ptr_array_index(pending->invocations, pending->invocations->len - 1);
+    gpointer task = pending;
+    if (!schedule_task_group("AdjustVcp", latest, pending, adjust_vcp_task, adjust_vcp_finish, &task, 1)) {
+        // Shed, the most recent call has been answered, the others get the same error.
+        for (int i = 0; i < pending->invocations->len - 1; i++) {
+            GDBusMethodInvocation* invocation = g_ptr_array_index(pending->invocations, i);
+            g_dbus_method_invocation_return_error(invocation, service_error_quark, DDCUTIL_SERVICE_QUEUE_FULL,
+                                                  "Too many calls queued for %s, limit is %d",
+                                                  g_dbus_method_invocation_get_sender(invocation),
+                                                  scheduler_max_queue_depth);
+        }
+        adjust_pending_free(pending);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * @brief Implements the DdcutilService AdjustVcp method
+ *
+ * Adjusts a VCP value relative to its current value.  Calls for the same display and VCP-code
+ * are accumulated for ADJUST_COALESCE_MILLIS and then queued for a worker thread, which applies
+ * them as one read-modify-write on a single open handle.  The reply is deferred until the write
+ * completes, and all held calls receive the same final value.
  *
  * @param parameters inbound parameters
  * @param invocation originating D-Bus method call
  */
-static void get_multiple_vcp(GVariant* parameters, GDBusMethodInvocation* invocation) {
+static void adjust_vcp(GVariant* parameters, GDBusMethodInvocation* invocation) {
     int display_number;
     char* edid_encoded;
+    uint8_t vcp_code;
+    int16_t delta;
+    gboolean clamp;
     u_int32_t flags;
 
-    GVariantIter* vcp_code_iter;
-    g_variant_get(parameters, "(isayu)", &display_number, &edid_encoded, &vcp_code_iter, &flags);
+    g_variant_get(parameters, "(isynbu)", &display_number, &edid_encoded, &vcp_code, &delta, &clamp, &flags);
 
-    g_info("GetMultipleVcp display_num=%d, edid=%.30s...", display_number, edid_encoded);
+    g_info("AdjustVcp vcp_code=%d delta=%d clamp=%s display_num=%d edid=%.30s...",
+           vcp_code, delta, BOOL_STR(clamp), display_number, edid_encoded);
 
-    const gsize number_of_vcp_codes = g_variant_iter_n_children(vcp_code_iter);
-    const u_int8_t vcp_codes[number_of_vcp_codes];
-    for (int i = 0; g_variant_iter_loop(vcp_code_iter, "y", &vcp_codes[i]); i++) {
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    const DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
+    if (status != DDCRC_OK) {
+        char* message_text = get_status_message(status);
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(qqis)", 0, 0, status, message_text));
+        free(message_text);
     }
-    g_variant_iter_free(vcp_code_iter);
+    else {
+        if (adjust_pending_table == NULL) {
+            adjust_pending_table = g_hash_table_new(g_str_hash, g_str_equal);
+        }
+        gchar* vdu_edid_encoded = edid_encode(vdu_info->edid_bytes);
+        gchar* key = g_strdup_printf("%s:%d", vdu_edid_encoded, vcp_code);
+        Adjust_Pending* pending = g_hash_table_lookup(adjust_pending_table, key);
+        if (pending == NULL) {
+            pending = g_new0(Adjust_Pending, 1);
+            pending->key = key;
+            pending->edid_encoded = vdu_edid_encoded;
+            pending->vcp_code = vcp_code;
+            pending->display_number = -1;
+            pending->invocations = g_ptr_array_new();
+            g_hash_table_insert(adjust_pending_table, pending->key, pending);
+            g_timeout_add(ADJUST_COALESCE_MILLIS, adjust_vcp_apply, pending);
+        }
+        else {
+            g_free(key);
+            g_free(vdu_edid_encoded);
+        }
+        pending->total_delta += delta;
+        pending->clamp = clamp;
+        pending->flags = flags;
+        g_free(pending->client_name);
+        pending->client_name = g_strdup(g_dbus_method_invocation_get_sender(invocation));
+        g_ptr_array_add(pending->invocations, invocation);  // Reply is deferred to adjust_vcp_apply
+    }
+    backend->free_display_info_list(info_list);
+    g_free(edid_encoded);
+}
 
-    GVariantBuilder value_array_builder_instance;
-    GVariantBuilder* value_array_builder = &value_array_builder_instance;
-    g_variant_builder_init(value_array_builder, G_VARIANT_TYPE("a(yqqs)"));
+/* ----------------------------------------------------------------------------------------------------
+ * Presets
+ *
+ * A preset is a named set of VCP values for one or more displays.  Presets are persisted in a
+ * GKeyFile, one group per preset.  Each key in a group is a display selector, each value is a list
+ * of code:value pairs, for example:
+ *
+ *     [night]
+ *     all=0x10:20;0x12:40;
+ *     edid-AP////////AHJ...=0x10:10;
+ *     display-2=0x14:5;
+ *
+ * A selector is "all", "display-N", or "edid-PREFIX" (a base64 EDID prefix, trailing padding removed
+ * because '=' cannot appear in a key).  When applying a preset, the entries are applied in file order,
+ * so a later entry overrides an earlier one for the same VCP-code.
+ */
 
-    ddca_enable_verify(TRUE);
+#define PRESETS_SELECTOR_ALL "all"
+#define PRESETS_SELECTOR_DISPLAY_PREFIX "display-"
+#define PRESETS_SELECTOR_EDID_PREFIX "edid-"
 
-    DDCA_Display_Info_List* info_list = NULL;
-    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
-    DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
-    if (status == DDCRC_OK) {
-        DDCA_Display_Handle disp_handle;
-        status = ddca_open_display2(vdu_info->dref, 1, &disp_handle);
-        if (status == DDCRC_OK) {
-            for (int i = 0; i < number_of_vcp_codes; i++) {
-                const u_int8_t vcp_code = vcp_codes[i];
-                static DDCA_Non_Table_Vcp_Value valrec;
-                status = ddca_get_non_table_vcp_value(disp_handle, vcp_code, &valrec);
-                if (status == DDCRC_OK) {
-                    DDCA_Feature_Metadata* metadata_ptr;
-                    status = ddca_get_feature_metadata_by_dh(vcp_code, disp_handle, true, &metadata_ptr);
-                    if (status == DDCRC_OK) {
-                        // Override, return all bytes regardless
-                        const bool return_all_bytes = return_raw_values || flags & RETURN_RAW_VALUES;
-                        const bool low_byte_only = !return_all_bytes && (DDCA_SIMPLE_NC & metadata_ptr->feature_flags);
-                        // For simple non-continuous types the high byte may be garbage for some models of VDU.
-                        const uint16_t current_value = low_byte_only ? valrec.sl : (valrec.sh << 8 | valrec.sl);
-                        const uint16_t max_value = low_byte_only ? valrec.ml : (valrec.mh << 8 | valrec.ml);
-                        char* formatted_value;
-                        status = ddca_format_non_table_vcp_value_by_dref(vcp_code, vdu_info->dref, &valrec,
-                                                                        &formatted_value);
-                        g_variant_builder_add(value_array_builder, "(yqqs)",
-                                            vcp_code, current_value, max_value, formatted_value);
-                        free(formatted_value);
-                        ddca_free_feature_metadata(metadata_ptr);
-                    }
-                    else {
-                        g_info("GetMultipleVcp metadata lookup failed for vcp_code=%d display_num=%d edid=%.30s...",
-                               vcp_code, display_number, edid_encoded);
-                    }
-                }
-                else {
-                    // Probably just asleep or turned off
-                    g_info("GetMultipleVcp failed for vcp_code=%d display_num=%d edid=%.30s...",
-                           vcp_code, display_number, edid_encoded);
-                }
+static GKeyFile* presets_key_file = NULL;
+
+static gchar* presets_file_path(void) {
+    return g_build_filename(g_get_user_config_dir(), "ddcutil-service", "presets.ini", NULL);
+}
+
+/**
+ * @brief Return the presets, loading them from $XDG_CONFIG_HOME on first use.
+ * @return the presets key file
+ */
+static GKeyFile* presets_get(void) {
+    if (presets_key_file == NULL) {
+        presets_key_file = g_key_file_new();
+        gchar* path = presets_file_path();
+        GError* local_error = NULL;
+        if (!g_key_file_load_from_file(presets_key_file, path, G_KEY_FILE_KEEP_COMMENTS, &local_error)) {
+            if (!g_error_matches(local_error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+                g_warning("Presets: failed to load %s: %s", path, local_error->message);
             }
-            ddca_close_display(disp_handle);
+            g_error_free(local_error);
         }
         else {
-            g_info("GetMultipleVcp open failed for display_num=%d edid=%.30s...",
-                   display_number, edid_encoded);
+            g_message("Presets: loaded %s", path);
+        }
+        g_free(path);
+    }
+    return presets_key_file;
+}
+
+/**
+ * @brief Persist the presets to $XDG_CONFIG_HOME.
+ * @param error location for a GError
+ * @return TRUE if saved
+ */
+static gboolean presets_save(GError** error) {
+    gchar* path = presets_file_path();
+    gchar* dir = g_path_get_dirname(path);
+    g_mkdir_with_parents(dir, 0700);
+    const gboolean saved = g_key_file_save_to_file(presets_get(), path, error);
+    g_free(dir);
+    g_free(path);
+    return saved;
+}
+
+/**
+ * @brief Convert a display number or EDID into a preset selector.
+ * @param display_number display number, used if edid_encoded is empty
+ * @param edid_encoded base64 EDID or prefix, may be empty
+ * @return g_malloced selector, "all" if neither is specified
+ */
+static gchar* presets_selector(const int display_number, const char* edid_encoded) {
+    if (edid_encoded != NULL && strlen(edid_encoded) > 0) {
+        gchar* selector = g_strconcat(PRESETS_SELECTOR_EDID_PREFIX, edid_encoded, NULL);
+        for (char* end = selector + strlen(selector) - 1; *end == '='; end--) {
+            *end = '\0';
+        }
+        return selector;
+    }
+    if (display_number > 0) {
+        return g_strdup_printf(PRESETS_SELECTOR_DISPLAY_PREFIX "%d", display_number);
+    }
+    return g_strdup(PRESETS_SELECTOR_ALL);
+}
+
+/**
+ * @brief Test whether a preset selector matches a display.
+ * @param selector the selector
+ * @param vdu_info the display
+ * @return TRUE if matched
+ */
+static gboolean presets_selector_matches(const char* selector, const DDCA_Display_Info* vdu_info) {
+    if (strcmp(selector, PRESETS_SELECTOR_ALL) == 0) {
+        return TRUE;
+    }
+    if (g_str_has_prefix(selector, PRESETS_SELECTOR_DISPLAY_PREFIX)) {
+        return atoi(selector + strlen(PRESETS_SELECTOR_DISPLAY_PREFIX)) == vdu_info->dispno;
+    }
+    if (g_str_has_prefix(selector, PRESETS_SELECTOR_EDID_PREFIX)) {
+        const char* edid_prefix = selector + strlen(PRESETS_SELECTOR_EDID_PREFIX);
+        gchar* edid_encoded = edid_encode(vdu_info->edid_bytes);
+        const gboolean matched = strncmp(edid_prefix, edid_encoded, strlen(edid_prefix)) == 0;
+        g_free(edid_encoded);
+        return matched;
+    }
+    return FALSE;
+}
+
+/**
+ * @brief Parse one "code:value" entry from a preset.
+ * @param text the entry
+ * @param vcp_code output VCP-code
+ * @param value output value
+ * @return TRUE if parsed
+ */
+static gboolean presets_parse_value(const char* text, uint8_t* vcp_code, uint16_t* value) {
+    char* end;
+    const guint64 code = g_ascii_strtoull(text, &end, 0);
+    if (end == text || *end != ':' || code > 0xff) {
+        return FALSE;
+    }
+    const char* value_text = end + 1;
+    const guint64 number = g_ascii_strtoull(value_text, &end, 0);
+    if (end == value_text || *end != '\0' || number > 0xffff) {
+        return FALSE;
+    }
+    *vcp_code = code;
+    *value = number;
+    return TRUE;
+}
+
+/**
+ * @brief Implements the DdcutilService SetPreset method
+ *
+ * Creates or replaces a named preset and persists it.
+ *
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void set_preset(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    char* preset_name;
+    GVariantIter* entry_iter;
+    u_int32_t flags;
+    g_variant_get(parameters, "(sa(isa(yq))u)", &preset_name, &entry_iter, &flags);
+
+    g_info("SetPreset name=%s entries=%" G_GSIZE_FORMAT, preset_name, g_variant_iter_n_children(entry_iter));
+
+    DDCA_Status status = DDCRC_OK;
+    if (strlen(preset_name) == 0 || strpbrk(preset_name, "[]\n") != NULL) {
+        status = DDCRC_ARG;
+    }
+    else {
+        GKeyFile* presets = presets_get();
+        g_key_file_remove_group(presets, preset_name, NULL);
+        int display_number;
+        char* edid_encoded;
+        GVariantIter* value_iter;
+        while (g_variant_iter_next(entry_iter, "(isa(yq))", &display_number, &edid_encoded, &value_iter)) {
+            GString* values_text = g_string_new(NULL);
+            uint8_t vcp_code;
+            uint16_t value;
+            while (g_variant_iter_next(value_iter, "(yq)", &vcp_code, &value)) {
+                g_string_append_printf(values_text, "0x%02x:%u;", vcp_code, value);
+            }
+            gchar* selector = presets_selector(display_number, edid_encoded);
+            g_key_file_set_value(presets, preset_name, selector, values_text->str);
+            g_free(selector);
+            g_string_free(values_text, TRUE);
+            g_variant_iter_free(value_iter);
+            g_free(edid_encoded);
         }
     }
+    g_variant_iter_free(entry_iter);
+
+    GError* local_error = NULL;
+    if (status == DDCRC_OK && !presets_save(&local_error)) {
+        g_dbus_method_invocation_return_error(invocation, service_error_quark, DDCUTIL_SERVICE_PRESET_SAVE_FAILED,
+                                              "Failed to save preset %s: %s", preset_name, local_error->message);
+        g_error_free(local_error);
+    }
     else {
-        g_info("GetMultipleVcp get_display_info failed for display_num=%d edid=%.30s...",
-               display_number, edid_encoded);
+        char* message_text = get_status_message(status);
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(is)", status, message_text));
+        free(message_text);
     }
-    g_info("GetMultipleVcp open looks ok for display_num=%d edid=%.30s...",
-               display_number, edid_encoded);
-    char* message_text = get_status_message(status);
-    GVariant* result = g_variant_new("(a(yqqs)is)", value_array_builder, status, message_text);
-    g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result
-    ddca_free_display_info_list(info_list);
-    g_free(edid_encoded);
-    free(message_text);
+    g_free(preset_name);
 }
 
 /**
- * @brief Implements the DdcutilService SetVCP method
+ * @brief Implements the DdcutilService DeletePreset method
  * @param parameters inbound parameters
  * @param invocation originating D-Bus method call
- * @param with_client_context whether the invocation includes a client-context string.
  */
-static void set_vcp(GVariant* parameters, GDBusMethodInvocation* invocation, const bool with_client_context) {
+static void delete_preset(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    char* preset_name;
+    u_int32_t flags;
+    g_variant_get(parameters, "(su)", &preset_name, &flags);
+
+    g_info("DeletePreset name=%s", preset_name);
+
+    const DDCA_Status status = g_key_file_remove_group(presets_get(), preset_name, NULL) ? DDCRC_OK : DDCRC_ARG;
+    GError* local_error = NULL;
+    if (status == DDCRC_OK && !presets_save(&local_error)) {
+        g_dbus_method_invocation_return_error(invocation, service_error_quark, DDCUTIL_SERVICE_PRESET_SAVE_FAILED,
+                                              "Failed to delete preset %s: %s", preset_name, local_error->message);
+        g_error_free(local_error);
+    }
+    else {
+        char* message_text = get_status_message(status);
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(is)", status, message_text));
+        free(message_text);
+    }
+    g_free(preset_name);
+}
+
+/**
+ * @brief Implements the DdcutilService ListPresets method
+ *
+ * Returns all the presets, each as an array of display selectors and values.  A selector is
+ * returned as a display number and EDID prefix, or -1 and an empty EDID for all displays.
+ *
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void list_presets(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    u_int32_t flags;
+    g_variant_get(parameters, "(u)", &flags);
+
+    GVariantBuilder presets_builder_instance;
+    GVariantBuilder* presets_builder = &presets_builder_instance;
+    g_variant_builder_init(presets_builder, G_VARIANT_TYPE("a{sa(isa(yq))}"));
+
+    GKeyFile* presets = presets_get();
+    gchar** preset_names = g_key_file_get_groups(presets, NULL);
+    for (int i = 0; preset_names[i] != NULL; i++) {
+        GVariantBuilder entries_builder_instance;
+        GVariantBuilder* entries_builder = &entries_builder_instance;
+        g_variant_builder_init(entries_builder, G_VARIANT_TYPE("a(isa(yq))"));
+        gchar** selectors = g_key_file_get_keys(presets, preset_names[i], NULL, NULL);
+        for (int j = 0; selectors != NULL && selectors[j] != NULL; j++) {
+            int display_number = -1;
+            const char* edid_prefix = "";
+            if (g_str_has_prefix(selectors[j], PRESETS_SELECTOR_DISPLAY_PREFIX)) {
+                display_number = atoi(selectors[j] + strlen(PRESETS_SELECTOR_DISPLAY_PREFIX));
+            }
+            else if (g_str_has_prefix(selectors[j], PRESETS_SELECTOR_EDID_PREFIX)) {
+                edid_prefix = selectors[j] + strlen(PRESETS_SELECTOR_EDID_PREFIX);
+            }
+            GVariantBuilder values_builder_instance;
+            GVariantBuilder* values_builder = &values_builder_instance;
+            g_variant_builder_init(values_builder, G_VARIANT_TYPE("a(yq)"));
+            gchar** values = g_key_file_get_string_list(presets, preset_names[i], selectors[j], NULL, NULL);
+            for (int k = 0; values != NULL && values[k] != NULL; k++) {
+                uint8_t vcp_code;
+                uint16_t value;
+                if (presets_parse_value(values[k], &vcp_code, &value)) {
+                    g_variant_builder_add(values_builder, "(yq)", vcp_code, value);
+                }
+            }
+            g_strfreev(values);
+            g_variant_builder_add(entries_builder, "(isa(yq))", display_number, edid_prefix, values_builder);
+        }
+        g_strfreev(selectors);
+        g_variant_builder_add(presets_builder, "{sa(isa(yq))}", preset_names[i], entries_builder);
+    }
+    g_strfreev(preset_names);
+
+    g_dbus_method_invocation_return_value(invocation, g_variant_new("(a{sa(isa(yq))})", presets_builder));
+}
+
+/**
+ * The values from a preset for one display, applied by a worker thread.
+ */
+typedef struct {
+    gchar* edid_encoded;          // the display's full base64 encoded EDID
     int display_number;
-    char* edid_encoded;
-    uint8_t vcp_code;
-    uint16_t new_value;
+    int number_of_values;
+    uint8_t vcp_codes[256];       // In the order first encountered in the preset
+    uint16_t new_values[256];
+    DDCA_Status statuses[256];
     u_int32_t flags;
-    char* client_context;
-    char* call_name;
+    DDCA_Status status;
+} Preset_Display_Task;
 
-    if (with_client_context) {
-        call_name = "SetVcpWithContext";
-        g_variant_get(parameters, "(isyqsu)",
-                      &display_number, &edid_encoded, &vcp_code, &new_value, &client_context, &flags);
+/**
+ * The state of an ApplyPreset call while its displays are written by the workers.
+ */
+typedef struct {
+    gchar* preset_name;
+    gchar* client_name;
+    Preset_Display_Task* tasks;
+    guint number_of_tasks;
+    gpointer* task_pointers;      // For schedule_task_group()
+} Apply_Preset_Call;
+
+static void apply_preset_call_free(Apply_Preset_Call* call) {
+    for (int i = 0; i < call->number_of_tasks; i++) {
+        g_free(call->tasks[i].edid_encoded);
+    }
+    g_free(call->tasks);
+    g_free(call->task_pointers);
+    g_free(call->preset_name);
+    g_free(call->client_name);
+    g_free(call);
+}
+
+/**
+ * @brief Task that writes a preset's values to one display.
+ * @param group the ApplyPreset call's task group
+ * @param data a Preset_Display_Task
+ */
+static void apply_preset_task(Task_Group* group, gpointer data) {
+    Preset_Display_Task* task = data;
+    DDCA_Display_Info_List* info_list = NULL;
+    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
+    task->status = get_display_info(-1, task->edid_encoded, &info_list, &vdu_info, FALSE);
+    if (task->status == DDCRC_OK) {
+        task->status = write_vcp_values(vdu_info, task->vcp_codes, task->new_values, task->number_of_values,
+                                        task->flags, task->statuses);
     }
     else {
-        call_name = "SetVcp";
-        g_variant_get(parameters, "(isyqu)", &display_number, &edid_encoded, &vcp_code, &new_value, &flags);
-        client_context = g_strdup("");
+        for (int i = 0; i < task->number_of_values; i++) {
+            task->statuses[i] = task->status;
+        }
+    }
+    backend->free_display_info_list(info_list);
+}
+
+/**
+ * @brief Signal each display's changes and reply to an ApplyPreset call once all its displays have been written.
+ * @param group the ApplyPreset call's task group
+ */
+static void apply_preset_finish(Task_Group* group) {
+    Apply_Preset_Call* call = group->data;
+    DDCA_Status status = DDCRC_OK;
+    GVariantBuilder results_builder_instance;
+    GVariantBuilder* results_builder = &results_builder_instance;
+    g_variant_builder_init(results_builder, G_VARIANT_TYPE("a(isa(yi)i)"));
+    for (int i = 0; i < call->number_of_tasks; i++) {
+        Preset_Display_Task* task = &call->tasks[i];
+        emit_vcp_values_changed(task->display_number, task->edid_encoded, task->vcp_codes, task->new_values,
+                                task->statuses, task->number_of_values, call->client_name, call->preset_name);
+        GVariantBuilder status_array_builder_instance;
+        GVariantBuilder* status_array_builder = &status_array_builder_instance;
+        g_variant_builder_init(status_array_builder, G_VARIANT_TYPE("a(yi)"));
+        for (int j = 0; j < task->number_of_values; j++) {
+            g_variant_builder_add(status_array_builder, "(yi)", task->vcp_codes[j], task->statuses[j]);
+        }
+        g_variant_builder_add(results_builder, "(isa(yi)i)",
+                              task->display_number, task->edid_encoded, status_array_builder, task->status);
+        if (task->status != DDCRC_OK) {
+            // Probably just asleep or turned off
+            g_info("ApplyPreset %s failed for display_num=%d status=%d",
+                   call->preset_name, task->display_number, task->status);
+            if (status == DDCRC_OK) {
+                status = task->status;  // Report the first failure overall
+            }
+        }
+    }
+    if (group->invocation != NULL) {
+        char* message_text = get_status_message(status);
+        GVariant* result = g_variant_new("(a(isa(yi)i)is)", results_builder, status, message_text);
+        g_dbus_method_invocation_return_value(group->invocation, result); // Think this frees the result
+        free(message_text);
+    }
+    else {
+        g_variant_builder_clear(results_builder);  // Discarded, already answered
     }
+    apply_preset_call_free(call);
+}
 
-    const bool verify = !(flags & NO_VERIFY);
-    // Always explicitly default to verify - ensures all libddcutil versions behave the same way
-    ddca_enable_verify(verify);
+/**
+ * @brief Implements the DdcutilService ApplyPreset method
+ *
+ * Applies a named preset to all the connected displays it selects.  Each display's values are
+ * queued as one task for the worker threads and written using one open handle, so the time taken
+ * doesn't grow with the number of displays.  The reply is sent once every display has been written.
+ * One VcpValuesChanged signal is emitted per display, with the preset name as the client-context.
+ *
+ * @param parameters inbound parameters
+ * @param invocation originating D-Bus method call
+ */
+static void apply_preset(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    char* preset_name;
+    u_int32_t flags;
+    g_variant_get(parameters, "(su)", &preset_name, &flags);
 
-    g_info("%s vcp_code=%d value=%d display_num=%d edid=%.30s... verify=%s client_context='%s'",
-           call_name, vcp_code, new_value, display_number, edid_encoded, BOOL_STR(verify), client_context);
+    g_info("ApplyPreset name=%s", preset_name);
 
+    GKeyFile* presets = presets_get();
     DDCA_Display_Info_List* info_list = NULL;
-    DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
-    DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
+    DDCA_Status status = g_key_file_has_group(presets, preset_name) ? DDCRC_OK : DDCRC_ARG;
     if (status == DDCRC_OK) {
-        DDCA_Display_Handle disp_handle;
-        status = ddca_open_display2(vdu_info->dref, 1, &disp_handle);
-        if (status == DDCRC_OK) {
-            const uint8_t low_byte = new_value & 0x00ff;
-            const uint8_t high_byte = new_value >> 8;
-            status = ddca_set_non_table_vcp_value(disp_handle, vcp_code, high_byte, low_byte);
-            ddca_close_display(disp_handle);
-        }
+        status = get_display_info_list(0, &info_list, "ApplyPreset");
     }
-    if (status == DDCRC_OK) {
-        GError* local_error = NULL;
-        const gchar* client_name = g_dbus_method_invocation_get_sender(invocation);
-        if (!g_dbus_connection_emit_signal(dbus_connection,
-                                           NULL,
-                                           "/com/ddcutil/DdcutilObject",
-                                           "com.ddcutil.DdcutilInterface",
-                                           "VcpValueChanged",
-                                           g_variant_new("(isyqssu)",
-                                                         display_number, edid_encoded, vcp_code, new_value,
-                                                         client_name, client_context, 0),
-                                           &local_error)) {
-            g_warning("Signal VcpValueChanged: failed %s", local_error != NULL ? local_error->message : "");
-            g_free(local_error);}
-        else {
-            if (g_log_get_debug_enabled()) {
-                g_debug("Signal VcpValueChanged: succeeded display=%d edid=%.30ss... vcp_code=%d value=%d client=%s "
-                    "client_context='%s'", display_number, edid_encoded, vcp_code, new_value, client_name, client_context);
+    if (status != DDCRC_OK) {
+        g_info("ApplyPreset %s failed status=%d", preset_name, status);
+        GVariantBuilder results_builder_instance;
+        GVariantBuilder* results_builder = &results_builder_instance;
+        g_variant_builder_init(results_builder, G_VARIANT_TYPE("a(isa(yi)i)"));
+        char* message_text = get_status_message(status);
+        GVariant* result = g_variant_new("(a(isa(yi)i)is)", results_builder, status, message_text);
+        g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result
+        backend->free_display_info_list(info_list);
+        g_free(preset_name);
+        free(message_text);
+        return;
+    }
+
+    // The presets are only used from the GMainLoop, so the values for each display are gathered here.
+    Apply_Preset_Call* call = g_new0(Apply_Preset_Call, 1);
+    call->preset_name = preset_name;
+    call->client_name = g_strdup(g_dbus_method_invocation_get_sender(invocation));
+    call->tasks = g_new0(Preset_Display_Task, info_list->ct);
+    call->task_pointers = g_new0(gpointer, info_list->ct);
+    gchar** selectors = g_key_file_get_keys(presets, preset_name, NULL, NULL);
+    for (int i = 0; i < info_list->ct; i++) {
+        const DDCA_Display_Info* vdu_info = &info_list->info[i];
+        Preset_Display_Task* task = &call->tasks[call->number_of_tasks];
+        task->flags = flags;
+        int index_of_code[256];
+        memset(index_of_code, -1, sizeof(index_of_code));
+        for (int j = 0; selectors != NULL && selectors[j] != NULL; j++) {
+            if (!presets_selector_matches(selectors[j], vdu_info)) {
+                continue;
+            }
+            gchar** values = g_key_file_get_string_list(presets, preset_name, selectors[j], NULL, NULL);
+            for (int k = 0; values != NULL && values[k] != NULL; k++) {
+                uint8_t vcp_code;
+                uint16_t value;
+                if (!presets_parse_value(values[k], &vcp_code, &value)) {
+                    g_warning("ApplyPreset: ignoring invalid value '%s' in preset %s", values[k], preset_name);
+                    continue;
+                }
+                if (index_of_code[vcp_code] < 0) {
+                    index_of_code[vcp_code] = task->number_of_values++;
+                    task->vcp_codes[index_of_code[vcp_code]] = vcp_code;
+                }
+                task->new_values[index_of_code[vcp_code]] = value;  // Later entries override earlier
             }
+            g_strfreev(values);
+        }
+        if (task->number_of_values > 0) {
+            task->edid_encoded = edid_encode(vdu_info->edid_bytes);
+            task->display_number = vdu_info->dispno;
+            call->task_pointers[call->number_of_tasks++] = task;
+        }
+        else {
+            memset(task, 0, sizeof(Preset_Display_Task));  // Reused for the next display
         }
     }
-    else {
-        // Probably just asleep or turned off
-        g_info("%s failed for vcp_code=%d value=%d display_num=%d edid=%.30s...",
-               call_name, vcp_code, new_value, display_number, edid_encoded);
+    g_strfreev(selectors);
+    backend->free_display_info_list(info_list);
+
+    if (!schedule_task_group("ApplyPreset", invocation, call, apply_preset_task, apply_preset_finish,
+                             call->task_pointers, call->number_of_tasks)) {
+        apply_preset_call_free(call);  // Shed, an error has been returned
     }
-    char* message_text = get_status_message(status);
-    GVariant* result = g_variant_new("(is)", status, message_text);
-    g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result
-    ddca_free_display_info_list(info_list);
-    g_free(edid_encoded);
-    g_free(client_context);
-    free(message_text);
+}
+
+static void set_vcp_without_context(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    set_vcp(parameters, invocation, FALSE);
+}
+
+static void set_vcp_with_context(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    set_vcp(parameters, invocation, TRUE);
 }
 
 /**
@@ -900,23 +6623,106 @@ static void get_capabilities_string(GVariant* parameters, GDBusMethodInvocation*
     DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
 
     if (status == DDCRC_OK) {
-        status = ddca_open_display2(vdu_info->dref, 1, &disp_handle);
+        status = i2c_open_display(vdu_info, &disp_handle);
         if (status == DDCRC_OK) {
-            status = ddca_get_capabilities_string(disp_handle, &caps_text);
-            ddca_close_display(disp_handle);
+            status = i2c_get_capabilities_string(disp_handle, vdu_info, &caps_text);
+            backend->close_display(disp_handle);
         }
     }
     char* message_text = get_status_message(status);
     GVariant* result = g_variant_new("(sis)",
                                      caps_text == NULL ? "" : caps_text,
                                      status, message_text);
-    g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result
-    ddca_free_display_info_list(info_list);
+    return_read_result(invocation, result);
+    backend->free_display_info_list(info_list);
     free(caps_text);
     g_free(edid_encoded);
     free(message_text);
 }
 
+/**
+ * @brief Add the GetCapabilitiesMetadata method's command and feature dictionaries for parsed capabilities.
+ * @param parsed_capabilities the display's parsed capabilities
+ * @param disp_handle the open display, for looking up feature metadata
+ * @param vdu_info the display's info
+ * @param command_dict_builder builder for a{ys}
+ * @param feature_dict_builder builder for a{y(ssa{ys})}
+ * @return the status of the last feature metadata lookup
+ */
+static DDCA_Status add_capabilities_metadata(const DDCA_Capabilities* parsed_capabilities,
+                                             DDCA_Display_Handle disp_handle,
+                                             const DDCA_Display_Info* vdu_info,
+                                             GVariantBuilder* command_dict_builder,
+                                             GVariantBuilder* feature_dict_builder) {
+    DDCA_Status status = DDCRC_OK;
+    const DDCA_Cap_Vcp* vcp_feature_array = parsed_capabilities->vcp_codes;
+
+    if (g_log_get_debug_enabled()) {
+        g_debug("vcp_code_ct=%d", parsed_capabilities->vcp_code_ct);
+    }
+
+    for (int command_idx = 0; command_idx < parsed_capabilities->cmd_ct; command_idx++) {
+        char* command_desc = g_strdup_printf("desc of %d", parsed_capabilities->cmd_codes[command_idx]);
+        if (g_log_get_debug_enabled()) {
+            g_debug("CommandDef %x %s ", parsed_capabilities->cmd_codes[command_idx], command_desc);
+        }
+        g_variant_builder_add(command_dict_builder, "{ys}", parsed_capabilities->cmd_codes[command_idx], command_desc);
+        g_free(command_desc); // TODO is this OK, or are we freeing too early?
+    }
+
+    for (int feature_idx = 0; feature_idx < parsed_capabilities->vcp_code_ct; feature_idx++) {
+        const DDCA_Cap_Vcp* feature_def = vcp_feature_array + feature_idx;
+        DDCA_Feature_Metadata* metadata_ptr;
+
+        status = i2c_get_feature_metadata_by_dh(disp_handle, vdu_info, feature_def->feature_code, true, &metadata_ptr);
+        if (status == DDCRC_OK) {
+            if (g_log_get_debug_enabled()) {
+                g_debug("FeatureDef: %x %s %s",
+                        metadata_ptr->feature_code, metadata_ptr->feature_name, metadata_ptr->feature_desc);
+            }
+            GVariantBuilder value_dict_builder_instance;
+            // Allocate on the stack for easier memory management.
+            GVariantBuilder* value_dict_builder = &value_dict_builder_instance;
+            g_variant_builder_init(value_dict_builder, G_VARIANT_TYPE("a{ys}"));
+            for (int value_idx = 0; value_idx < feature_def->value_ct; value_idx++) {
+                const u_int8_t value_code = feature_def->values[value_idx];
+                char* value_name = "";
+                if (metadata_ptr->sl_values != NULL) {
+                    for (const DDCA_Feature_Value_Entry* fve = metadata_ptr->sl_values;
+                         fve->value_name != NULL; fve++) {
+                        if (fve->value_code == value_code) {
+                            if (g_log_get_debug_enabled()) {
+                                g_debug("  ValueDef match feature %x value %d %s",
+                                        feature_def->feature_code, fve->value_code, fve->value_name);
+                            }
+                            value_name = fve->value_name;
+                            break;
+                        }
+                    }
+                }
+                if (g_log_get_debug_enabled()) {
+                    g_debug("  ValueDef feature %x value %d %s",
+                            feature_def->feature_code, value_code, value_name);
+                }
+
+                g_variant_builder_add(value_dict_builder, "{ys}", value_code, value_name);
+            }
+            g_variant_builder_add(
+                feature_dict_builder,
+                "{y(ssa{ys})}",
+                metadata_ptr->feature_code,
+                metadata_ptr->feature_name,
+                metadata_ptr->feature_desc == NULL ? "" : metadata_ptr->feature_desc,
+                value_dict_builder);
+            ddca_free_feature_metadata(metadata_ptr);
+        }
+        else {
+            g_warning("%x %s", feature_def->feature_code, get_status_message(status));
+        }
+    }
+    return status;
+}
+
 /**
  * @brief Implements the DdcutilService GetCapabilitiesMetadata method
  *
@@ -954,87 +6760,20 @@ static void get_capabilities_metadata(GVariant* parameters, GDBusMethodInvocatio
 
     if (status == DDCRC_OK) {
         vdu_model = vdu_info->model_name;
-        status = ddca_open_display2(vdu_info->dref, 1, &disp_handle);
+        status = i2c_open_display(vdu_info, &disp_handle);
         if (status == DDCRC_OK) {
-            status = ddca_get_capabilities_string(disp_handle, &caps_text);
+            status = i2c_get_capabilities_string(disp_handle, vdu_info, &caps_text);
             if (status == DDCRC_OK) {
                 status = ddca_parse_capabilities_string(caps_text, &parsed_capabilities_ptr);
 
                 if (status == DDCRC_OK) {
-                    const DDCA_Cap_Vcp* vcp_feature_array = parsed_capabilities_ptr->vcp_codes;
-
-                    if (g_log_get_debug_enabled()) {
-                        g_debug("vcp_code_ct=%d", parsed_capabilities_ptr->vcp_code_ct);
-                    }
-
                     mccs_version_major = parsed_capabilities_ptr->version_spec.major;
                     mccs_version_minor = parsed_capabilities_ptr->version_spec.minor;
-                    for (int command_idx = 0; command_idx < parsed_capabilities_ptr->cmd_ct; command_idx++) {
-                        char* command_desc = g_strdup_printf("desc of %d",
-                                                             parsed_capabilities_ptr->cmd_codes[command_idx]);
-                        if (g_log_get_debug_enabled()) {
-                            g_debug("CommandDef %x %s ", parsed_capabilities_ptr->cmd_codes[command_idx], command_desc);
-                        }
-                        g_variant_builder_add(
-                            command_dict_builder, "{ys}", parsed_capabilities_ptr->cmd_codes[command_idx],
-                            command_desc);
-                        g_free(command_desc); // TODO is this OK, or are we freeing too early?
-                    }
-
-                    for (int feature_idx = 0; feature_idx < parsed_capabilities_ptr->vcp_code_ct; feature_idx++) {
-                        const DDCA_Cap_Vcp* feature_def = vcp_feature_array + feature_idx;
-                        DDCA_Feature_Metadata* metadata_ptr;
-
-                        status = ddca_get_feature_metadata_by_dh(feature_def->feature_code, disp_handle, true,
-                                                                 &metadata_ptr);
-                        if (status == DDCRC_OK) {
-                            if (g_log_get_debug_enabled()) {
-                                g_debug("FeatureDef: %x %s %s",
-                                        metadata_ptr->feature_code, metadata_ptr->feature_name, metadata_ptr->feature_desc);
-                            }
-                            GVariantBuilder value_dict_builder_instance;
-                            // Allocate on the stack for easier memory management.
-                            GVariantBuilder* value_dict_builder = &value_dict_builder_instance;
-                            g_variant_builder_init(value_dict_builder, G_VARIANT_TYPE("a{ys}"));
-                            for (int value_idx = 0; value_idx < feature_def->value_ct; value_idx++) {
-                                const u_int8_t value_code = feature_def->values[value_idx];
-                                char* value_name = "";
-                                if (metadata_ptr->sl_values != NULL) {
-                                    for (const DDCA_Feature_Value_Entry* fve = metadata_ptr->sl_values;
-                                         fve->value_name != NULL; fve++) {
-                                        if (fve->value_code == value_code) {
-                                            if (g_log_get_debug_enabled()) {
-                                                g_debug("  ValueDef match feature %x value %d %s",
-                                                        feature_def->feature_code, fve->value_code, fve->value_name);
-                                            }
-                                            value_name = fve->value_name;
-                                            break;
-                                        }
-                                    }
-                                }
-                                if (g_log_get_debug_enabled()) {
-                                    g_debug("  ValueDef feature %x value %d %s",
-                                            feature_def->feature_code, value_code, value_name);
-                                }
-
-                                g_variant_builder_add(value_dict_builder, "{ys}", value_code, value_name);
-                            }
-                            g_variant_builder_add(
-                                feature_dict_builder,
-                                "{y(ssa{ys})}",
-                                metadata_ptr->feature_code,
-                                metadata_ptr->feature_name,
-                                metadata_ptr->feature_desc == NULL ? "" : metadata_ptr->feature_desc,
-                                value_dict_builder);
-                            ddca_free_feature_metadata(metadata_ptr);
-                        }
-                        else {
-                            g_warning("%x %s", feature_def->feature_code, get_status_message(status));
-                        }
-                    }
+                    status = add_capabilities_metadata(parsed_capabilities_ptr, disp_handle, vdu_info,
+                                                       command_dict_builder, feature_dict_builder);
                 }
             }
-            ddca_close_display(disp_handle);
+            backend->close_display(disp_handle);
         }
     }
 
@@ -1058,8 +6797,8 @@ static void get_capabilities_metadata(GVariant* parameters, GDBusMethodInvocatio
                                      command_dict_builder,
                                      feature_dict_builder,
                                      status, message_text);
-    g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result
-    ddca_free_display_info_list(info_list);
+    return_read_result(invocation, result);
+    backend->free_display_info_list(info_list);
     ddca_free_parsed_capabilities(parsed_capabilities_ptr);
     free(caps_text);
     g_free(edid_encoded);
@@ -1096,9 +6835,9 @@ static void get_vcp_metadata(GVariant* parameters, GDBusMethodInvocation* invoca
     DDCA_Feature_Metadata* metadata_ptr = NULL;
     if (status == DDCRC_OK) {
         DDCA_Display_Handle disp_handle;
-        status = ddca_open_display2(vdu_info->dref, 1, &disp_handle);
+        status = i2c_open_display(vdu_info, &disp_handle);
         if (status == DDCRC_OK) {
-            status = ddca_get_feature_metadata_by_dh(vcp_code, disp_handle, true, &metadata_ptr);
+            status = i2c_get_feature_metadata_by_dh(disp_handle, vdu_info, vcp_code, true, &metadata_ptr);
             if (status == DDCRC_OK) {
                 if (metadata_ptr->feature_name != NULL) {
                     feature_name = g_strdup(metadata_ptr->feature_name);
@@ -1117,7 +6856,7 @@ static void get_vcp_metadata(GVariant* parameters, GDBusMethodInvocation* invoca
                 is_continuous = metadata_ptr->feature_flags & DDCA_CONT;
                 ddca_free_feature_metadata(metadata_ptr);
             }
-            ddca_close_display(disp_handle);
+            backend->close_display(disp_handle);
         }
     }
     char* message_text = get_status_message(status);
@@ -1126,8 +6865,8 @@ static void get_vcp_metadata(GVariant* parameters, GDBusMethodInvocation* invoca
                                      feature_description != NULL ? feature_description : "",
                                      is_read_only, is_write_only, is_rw, is_complex, is_continuous,
                                      status, status == DDCRC_OK ? "OK" : message_text);
-    g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result
-    ddca_free_display_info_list(info_list);
+    return_read_result(invocation, result);
+    backend->free_display_info_list(info_list);
     ddca_free_feature_metadata(metadata_ptr);
     g_free(edid_encoded);
     g_free(feature_name);
@@ -1157,15 +6896,15 @@ static void get_display_state(GVariant* parameters, GDBusMethodInvocation* invoc
     DDCA_Status status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
     if (status == DDCRC_OK) {
 #if defined(LIBDDCUTIL_HAS_CHANGES_CALLBACK)
-        status = ddca_validate_display_ref(vdu_info->dref, TRUE);
+        status = backend->validate_display_ref(vdu_info->dref, TRUE);
 #else
         status = DDCRC_UNIMPLEMENTED;
 #endif
     }
     char* message_text = get_status_message(status);
     GVariant* result = g_variant_new("(is)", status, message_text);
-    g_dbus_method_invocation_return_value(invocation, result); // Think this frees the result
-    ddca_free_display_info_list(info_list);
+    return_read_result(invocation, result);
+    backend->free_display_info_list(info_list);
     free(edid_encoded);
     free(message_text);
 }
@@ -1199,9 +6938,9 @@ static void get_sleep_multiplier(GVariant* parameters, GDBusMethodInvocation* in
     DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
     status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
     if (status == DDCRC_OK) {
-        status = ddca_get_current_display_sleep_multiplier(vdu_info->dref, &multiplier);
+        status = backend->get_current_display_sleep_multiplier(vdu_info->dref, &multiplier);
     }
-    ddca_free_display_info_list(info_list);
+    backend->free_display_info_list(info_list);
 #endif
     char* message_text = get_status_message(status);
     GVariant* result = g_variant_new("(dis)", multiplier, status, message_text);
@@ -1245,9 +6984,9 @@ static void set_sleep_multiplier(GVariant* parameters, GDBusMethodInvocation* in
     DDCA_Display_Info* vdu_info = NULL; // pointer into info_list
     status = get_display_info(display_number, edid_encoded, &info_list, &vdu_info, flags & EDID_PREFIX);
     if (status == DDCRC_OK) {
-        status = ddca_set_display_sleep_multiplier(vdu_info->dref, new_multiplier);
+        status = backend->set_display_sleep_multiplier(vdu_info->dref, new_multiplier);
     }
-    ddca_free_display_info_list(info_list);
+    backend->free_display_info_list(info_list);
 #endif
     char* message_text = get_status_message(status);
     GVariant* result = g_variant_new("(is)", status, message_text);
@@ -1264,16 +7003,25 @@ static void set_sleep_multiplier(GVariant* parameters, GDBusMethodInvocation* in
 static DdcutilServiceStatus verify_i2c_dev() {
     DdcutilServiceStatus service_status = DDCUTIL_SERVICE_OK;  // Assume OK
 
+    if (simulate_path != NULL) {
+        return service_status;  // No i2c-dev involved
+    }
+
 #if defined(VERIFY_I2C)
     g_message("Verifying libddcutil and i2c-dev dependencies (i2c-dev kernel module and device permissions)...");
-    // First just check if detect is finding anything - if it is, i2c-dev must be OK
-    const DDCA_Status detect_status = ddca_redetect_displays(); // Do not call too frequently, delays the main-loop
+    // First just check if detect is finding anything - if it is, i2c-dev must be OK.
+    // Skipped if jobs are using the displays, the GMainLoop mustn't wait for them.
+    DDCA_Status detect_status = DDCRC_OTHER;
+    if (g_rw_lock_writer_trylock(&display_refs_lock)) {
+        detect_status = redetect_displays();
+        g_rw_lock_writer_unlock(&display_refs_lock);
+    }
     if (detect_status == DDCRC_OK) {
         DDCA_Display_Info_List* dlist = NULL;
         const DDCA_Status list_status = get_display_info_list(1, &dlist, "Verify-I2C");
         if (list_status == DDCRC_OK) {
             const int vdu_count = dlist->ct;
-            ddca_free_display_info_list(dlist);
+            backend->free_display_info_list(dlist);
             if (vdu_count > 0) {
                 g_message("Detected VDU-count=%d - skipping i2c-dev verification", vdu_count);
                 return DDCUTIL_SERVICE_OK;
@@ -1386,6 +7134,10 @@ static DDCA_Status disable_ddca_watch_displays() {
  * @return DDCRC_OK if start/restart succeeds, otherwise returns the error status
  */
 static DDCA_Status enable_ddca_watch_displays(void) {
+    if (simulate_path != NULL) {
+        g_warning("libddcutil watch_displays cannot see simulated displays");
+        return DDCRC_UNIMPLEMENTED;
+    }
 #if defined(LIBDDCUTIL_HAS_CHANGES_CALLBACK)
     int status = DDCRC_OK;
     DDCA_Display_Event_Class classes_loc;
@@ -1438,6 +7190,12 @@ static DDCA_Status enable_ddca_watch_displays(void) {
 static void handle_method_call(GDBusConnection* connection, const gchar* sender, const gchar* object_path,
                                const gchar* interface_name, const gchar* method_name, GVariant* parameters,
                                GDBusMethodInvocation* invocation, gpointer user_data) {
+    const long start_micros = g_get_monotonic_time();
+    int trace_display;
+    uint8_t trace_vcp_code;
+    trace_call_begin(parameters, &trace_display, &trace_vcp_code);
+    USDT_PROBE(method__entry, method_name, trace_display, trace_vcp_code, 0, 0);
+    watchdog_phase_set(method_name, trace_display);
 
     if (ddcutil_service_status != DDCUTIL_SERVICE_OK) {
         g_message("Service currently broken, checking again...");
@@ -1462,29 +7220,73 @@ static void handle_method_call(GDBusConnection* connection, const gchar* sender,
         }
     }
 
+    // Handlers may use display refs, this only waits if a redetect barrier job is already running.
+    g_rw_lock_reader_lock(&display_refs_lock);
     if (g_strcmp0(method_name, "Detect") == 0) {
-        detect(parameters, invocation, FALSE);
+        schedule_barrier_call(method_name, invocation, detect_with_redetect);
     }
     else if (g_strcmp0(method_name, "ListDetected") == 0) {
         detect(parameters, invocation, TRUE);
     }
     else if (g_strcmp0(method_name, "GetVcp") == 0) {
-        get_vcp(parameters, invocation);
+        dispatch_read(method_name, parameters, invocation, get_vcp);
     }
     else if (g_strcmp0(method_name, "GetMultipleVcp") == 0) {
-        get_multiple_vcp(parameters, invocation);
+        dispatch_read(method_name, parameters, invocation, get_multiple_vcp);
+    }
+    else if (g_strcmp0(method_name, "GetVcpConditional") == 0) {
+        dispatch_read(method_name, parameters, invocation, get_vcp_conditional);
+    }
+    else if (g_strcmp0(method_name, "GetMultipleVcpConditional") == 0) {
+        dispatch_read(method_name, parameters, invocation, get_multiple_vcp_conditional);
+    }
+    else if (g_strcmp0(method_name, "GetVcpWithBudget") == 0) {
+        dispatch_budget_read(method_name, parameters, invocation, get_vcp_with_budget);
+    }
+    else if (g_strcmp0(method_name, "GetMultipleVcpWithBudget") == 0) {
+        dispatch_budget_read(method_name, parameters, invocation, get_multiple_vcp_with_budget);
     }
     else if (g_strcmp0(method_name, "SetVcp") == 0) {
-        set_vcp(parameters, invocation, FALSE);
+        schedule_call(method_name, invocation, set_vcp_without_context);
     }
     else if (g_strcmp0(method_name, "SetVcpWithContext") == 0) {
-        set_vcp(parameters, invocation, TRUE);
+        schedule_call(method_name, invocation, set_vcp_with_context);
+    }
+    else if (g_strcmp0(method_name, "SetMultipleVcp") == 0) {
+        schedule_call(method_name, invocation, set_multiple_vcp);
+    }
+    else if (g_strcmp0(method_name, "RampVcp") == 0) {
+        schedule_call(method_name, invocation, ramp_vcp);
+    }
+    else if (g_strcmp0(method_name, "WatchVcp") == 0) {
+        watch_vcp(parameters, invocation, TRUE);
+    }
+    else if (g_strcmp0(method_name, "UnwatchVcp") == 0) {
+        watch_vcp(parameters, invocation, FALSE);
+    }
+    else if (g_strcmp0(method_name, "AdjustVcp") == 0) {
+        adjust_vcp(parameters, invocation);
+    }
+    else if (g_strcmp0(method_name, "SetPreset") == 0) {
+        set_preset(parameters, invocation);
+    }
+    else if (g_strcmp0(method_name, "DeletePreset") == 0) {
+        delete_preset(parameters, invocation);
+    }
+    else if (g_strcmp0(method_name, "ListPresets") == 0) {
+        list_presets(parameters, invocation);
+    }
+    else if (g_strcmp0(method_name, "ApplyPreset") == 0) {
+        apply_preset(parameters, invocation);
+    }
+    else if (g_strcmp0(method_name, "Execute") == 0) {
+        execute(parameters, invocation);
     }
     else if (g_strcmp0(method_name, "GetDisplayState") == 0) {
-        get_display_state(parameters, invocation);
+        dispatch_read(method_name, parameters, invocation, get_display_state);
     }
     else if (g_strcmp0(method_name, "GetVcpMetadata") == 0) {
-        get_vcp_metadata(parameters, invocation);
+        dispatch_read(method_name, parameters, invocation, get_vcp_metadata);
     }
     else if (g_strcmp0(method_name, "GetSleepMultiplier") == 0) {
         get_sleep_multiplier(parameters, invocation);
@@ -1493,14 +7295,32 @@ static void handle_method_call(GDBusConnection* connection, const gchar* sender,
         set_sleep_multiplier(parameters, invocation);
     }
     else if (g_strcmp0(method_name, "GetCapabilitiesString") == 0) {
-        get_capabilities_string(parameters, invocation);
+        dispatch_read(method_name, parameters, invocation, get_capabilities_string);
     }
     else if (g_strcmp0(method_name, "GetCapabilitiesMetadata") == 0) {
-        get_capabilities_metadata(parameters, invocation);
+        dispatch_read(method_name, parameters, invocation, get_capabilities_metadata);
+    }
+    else if (g_strcmp0(method_name, "GetServiceStats") == 0) {
+        get_service_stats(parameters, invocation);
+    }
+    else if (g_strcmp0(method_name, "GetDisplayIoStats") == 0) {
+        get_display_io_stats(parameters, invocation);
+    }
+    else if (g_strcmp0(method_name, "GetTrace") == 0) {
+        get_trace(parameters, invocation);
+    }
+    else if (g_strcmp0(method_name, "SimulateEvent") == 0) {
+        simulate_event(parameters, invocation);
     }
     else if (g_strcmp0(method_name, "Restart") == 0) {
         restart(parameters, invocation);
     }
+    g_rw_lock_reader_unlock(&display_refs_lock);
+    latency_record_method(method_name, "dispatch", start_micros);
+    trace_call_end(TRACE_CALL, sender, method_name, trace_display, trace_vcp_code, start_micros);
+    watchdog_phase_set(NULL, -1);
+    USDT_PROBE(method__return, method_name, trace_display, trace_vcp_code,
+               GPOINTER_TO_INT(g_private_get(&trace_thread_status)), g_get_monotonic_time() - start_micros);
 }
 
 /**
@@ -1598,6 +7418,21 @@ static GVariant* handle_get_property(GDBusConnection* connection, const gchar* s
     else if (g_strcmp0(property_name, "ServicePollCascadeInterval") == 0) {
         ret = g_variant_new_double(poll_cascade_interval_micros / 1000000.0);
     }
+    else if (g_strcmp0(property_name, "ServiceVcpCacheMaxAge") == 0) {
+        ret = g_variant_new_double(vcp_cache_max_age_micros / 1000000.0);
+    }
+    else if (g_strcmp0(property_name, "ServiceStatistics") == 0) {
+        ret = get_service_statistics();
+    }
+    else if (g_strcmp0(property_name, "ServiceStatsResetTime") == 0) {
+        ret = g_variant_new_uint64(latency_get_reset_time());
+    }
+    else if (g_strcmp0(property_name, "ServicePrefetchHitRate") == 0) {
+        ret = g_variant_new_double(get_prefetch_hit_rate());
+    }
+    else if (g_strcmp0(property_name, "ServiceMainLoopStalls") == 0) {
+        ret = get_stall_statistics();
+    }
     return ret;
 }
 
@@ -1719,6 +7554,20 @@ static gboolean handle_set_property(GDBusConnection* connection, const gchar* se
             return FALSE;
         }
     }
+    else if (g_strcmp0(property_name, "ServiceVcpCacheMaxAge") == 0) {
+        const double secs = g_variant_get_double(value);
+        if (!update_vcp_cache_max_age(secs)) {
+            g_set_error (error,
+             service_error_quark,
+             DDCUTIL_SERVICE_INVALID_VCP_CACHE_MAX_AGE,
+             "Invalid VCP cache max age %5.3f, must be zero or more seconds", secs);
+            return FALSE;
+        }
+    }
+    else if (g_strcmp0(property_name, "ServiceStatsResetTime") == 0) {
+        latency_reset();  // Any value resets, the property then reads as the time of the reset
+        g_message("ServiceStatsResetTime: latency histograms reset");
+    }
     return *error == NULL;
 }
 
@@ -1734,14 +7583,26 @@ static gboolean handle_set_property(GDBusConnection* connection, const gchar* se
  */
 
 static long next_poll_time = 0;
+static gint poll_soon_requested = FALSE;  // Set from worker threads by poll_soon()
+static gboolean poll_list_primed = FALSE;  // The first full pass has listed the displays present at startup
 
 static GList* poll_list = NULL; // List of currently detected edids
 
+typedef enum {
+    POLL_REDETECT_IDLE = 0,
+    POLL_REDETECT_QUEUED = 1,     // Waiting for the workers to drain, or running
+    POLL_REDETECT_DONE = 2,       // poll_redetect_status is set
+} Poll_Redetect_State_Type;
+
+static gint poll_redetect_state = POLL_REDETECT_IDLE;  // Atomic, Poll_Redetect_State_Type
+static DDCA_Status poll_redetect_status = DDCRC_OK;     // Written before poll_redetect_state becomes DONE
+
 typedef struct {
     gchar* edid_encoded;
     gboolean connected;
     gboolean has_dpms;
     gboolean dpms_awake;
+    gboolean dpms_unknown;        // Not read yet, there was no rate limit token to spare
 } Poll_List_Item;
 
 /**
@@ -1774,15 +7635,16 @@ static bool is_dpms_capable(const DDCA_Display_Info *vdu_info) {
     DDCA_Feature_Metadata *meta_0xd6 = NULL;
 #if defined(USE_DREF_CHECK_FOR_DPMS)
     // May cause Assertion `dref->flags & DREF_DDC_COMMUNICATION_WORKING failed in libddcutil
-    status = ddca_get_feature_metadata_by_dref(0xd6, vdu_info->dref, FALSE, &meta_0xd6);
+    status = backend->get_feature_metadata_by_dref(0xd6, vdu_info->dref, FALSE, &meta_0xd6);
 #else
     // Might be safer - I think it doesn't take the assertion trip-wired path.
     DDCA_Display_Handle disp_handle;
-    status = ddca_open_display2(vdu_info->dref, 1, &disp_handle);
+    status = i2c_open_display(vdu_info, &disp_handle);
     if (status == DDCRC_OK) {
-        status = ddca_get_feature_metadata_by_dh(0xd6, disp_handle, FALSE, &meta_0xd6);
+        status = i2c_get_feature_metadata_by_dh(disp_handle, vdu_info, 0xd6, FALSE, &meta_0xd6);
     }
-    ddca_close_display(disp_handle);
+    backend->close_display(disp_handle);
+    rate_limit_refund_prepaid();  // Unused if the open failed or libddcutil already knew the VCP version
 #endif
     if (meta_0xd6 != NULL) {
         ddca_free_feature_metadata(meta_0xd6);
@@ -1792,11 +7654,14 @@ static bool is_dpms_capable(const DDCA_Display_Info *vdu_info) {
 
 static bool is_dpms_awake(const DDCA_Display_Info* vdu_info) {
     DDCA_Display_Handle disp_handle;
-    DDCA_Status status = ddca_open_display2(vdu_info->dref, 1, &disp_handle);
-    if (status == DDCRC_OK) {
+    DDCA_Status status = i2c_open_display(vdu_info, &disp_handle);
+    if (status != DDCRC_OK) {
+        rate_limit_refund_prepaid();  // The token from rate_limit_try_acquire() wasn't used
+    }
+    else {
         static DDCA_Non_Table_Vcp_Value valrec;
-        status = ddca_get_non_table_vcp_value(disp_handle, 0xd6, &valrec);
-        ddca_close_display(disp_handle);
+        status = i2c_get_non_table_vcp_value(disp_handle, vdu_info, 0xd6, &valrec);
+        backend->close_display(disp_handle);
         if (status == DDCRC_OK) {
             const uint16_t current_value = valrec.sh << 8 | valrec.sl;
             // g_debug("Poll check-dpms value=%d %s", current_value, current_value <= 1 ? "awake" : "asleep");
@@ -1809,10 +7674,39 @@ static bool is_dpms_awake(const DDCA_Display_Info* vdu_info) {
     return FALSE;  // Guessing the VDU has gone into DPMS where it cannot respond.
 }
 
+/**
+ * @brief Run the internal poll on the GMainLoop's next iteration rather than at its next interval.
+ */
+static void poll_soon(void) {
+    g_atomic_int_set(&poll_soon_requested, TRUE);
+}
+
+/**
+ * @brief Barrier job that redetects displays for the internal poll's hotplug detection.
+ * @param parameters ()
+ * @param invocation always NULL
+ */
+static void poll_redetect(GVariant* parameters, GDBusMethodInvocation* invocation) {
+    // Masking the logging is a bit hacky - it depends on internal knowledge of how libddcutil is logging.
+    // The author of libddcutil regards the normal messages as quite important, so they should be logged.
+    // A compromise: when the service is not logging debug/info, change the syslog mask, and then restore it.
+    int old_mask = 0;
+    if (!service_info_logging) {
+        old_mask = setlogmask(LOG_UPTO(LOG_WARNING));  // Temporarily disable notice msgs from libddcutil
+    }
+    poll_redetect_status = redetect_displays();
+    if (!service_info_logging) {
+        setlogmask(old_mask); // Restore original logging mask
+    }
+    g_atomic_int_set(&poll_redetect_state, POLL_REDETECT_DONE);
+}
+
 static bool poll_for_changes() {
     const long now_in_micros = g_get_monotonic_time();
     bool event_is_ready = FALSE;
-    if (now_in_micros >= next_poll_time) {
+    bool dpms_check_postponed = FALSE;  // The GMainLoop mustn't wait for a rate limit token, retry soon instead
+    if (g_atomic_int_compare_and_exchange(&poll_soon_requested, TRUE, FALSE) || now_in_micros >= next_poll_time) {
+        watchdog_phase_set("poll_for_changes", -1);
         // When monitoring_preference == MONITOR_BY_INTERNAL_POLLING, this function handles
         // both hotplug and DPMS detection.
         // When monitoring_preference == MONITOR_BY_LIBDDCUTIL_EVENTS libddcutil
@@ -1823,20 +7717,21 @@ static bool poll_for_changes() {
             g_debug("Internal Poll check: %s", handle_hotplug_detection ? "hotplug and DPMS check" : "DPMS only check");
         }
         DDCA_Status detect_status = DDCRC_OK;
+        bool redetect_pending = FALSE;  // Check back for the result soon
         if (handle_hotplug_detection) {  // Need to do expensive ddca_redected_displays() for hotplug detection
-            // Masking the logging is a bit hacky - it depends on internal knowledge of how libddcutil is logging.
-            // The author of libddcutil regards the normal messages as quite important, so they should be logged.
-            // A compromise: when the service is not logging debug/info, change the syslog mask, and then restore it.
-            int old_mask = 0;
-            if (!service_info_logging) {
-                old_mask = setlogmask(LOG_UPTO(LOG_WARNING));  // Temporarily disable notice msgs from libddcutil
+            if (g_atomic_int_compare_and_exchange(&poll_redetect_state, POLL_REDETECT_IDLE, POLL_REDETECT_QUEUED)) {
+                schedule_background_barrier(poll_redetect, g_variant_new("()"));
             }
-            detect_status = ddca_redetect_displays(); // Do not call too frequently, delays the main-loop
-            if (!service_info_logging) {
-                setlogmask(old_mask); // Restore original logging mask
+            redetect_pending = g_atomic_int_get(&poll_redetect_state) != POLL_REDETECT_DONE;
+            if (!redetect_pending) {
+                detect_status = poll_redetect_status;
+                g_atomic_int_set(&poll_redetect_state, POLL_REDETECT_IDLE);
             }
         }
-        if (detect_status == DDCRC_OK) {
+        // The display refs can't be used while a redetect is running, and the GMainLoop mustn't wait for it.
+        const bool refs_locked = !redetect_pending && g_rw_lock_reader_trylock(&display_refs_lock);
+        dpms_check_postponed |= !redetect_pending && !refs_locked;
+        if (refs_locked && detect_status == DDCRC_OK) {
             DDCA_Display_Info_List* dlist;
             const DDCA_Status info_status = get_display_info_list(1, &dlist, NULL);
             if (info_status == DDCRC_OK) {
@@ -1858,9 +7753,16 @@ static bool poll_for_changes() {
                         if (g_log_get_debug_enabled()) {
                             g_debug("Internal Poll check: existing-connection disp=%d %.30s...", ndx + 1, edid_encoded);
                         }
-                        if (vdu_poll_data->has_dpms) {
+                        if (vdu_poll_data->has_dpms && !rate_limit_try_acquire(ddca_dinfo_ptr)) {
+                            dpms_check_postponed = TRUE;
+                        }
+                        else if (vdu_poll_data->has_dpms) {
+                            watchdog_phase_set("poll_for_changes/is_dpms_awake", ddca_dinfo_ptr->dispno);
                             vdu_poll_data->dpms_awake = is_dpms_awake(ddca_dinfo_ptr);
-                            if (previous_dpms_awake != vdu_poll_data->dpms_awake) {
+                            if (vdu_poll_data->dpms_unknown) {  // First reading, nothing to compare with
+                                vdu_poll_data->dpms_unknown = FALSE;
+                            }
+                            else if (previous_dpms_awake != vdu_poll_data->dpms_awake) {
                                 g_message("Poll signal event - dpms changed to %s %d %.30s...",
                                     vdu_poll_data->dpms_awake ? "awake" : "asleep", ndx + 1, edid_encoded);
                                 Event_Data_Type* event = g_malloc(sizeof(Event_Data_Type));
@@ -1873,19 +7775,27 @@ static bool poll_for_changes() {
                         }
                         g_free(edid_encoded);  // Already in list - no longer needed
                     }
+                    else if (!rate_limit_try_acquire(ddca_dinfo_ptr)) {  // is_dpms_capable() may need DDC I/O
+                        dpms_check_postponed = TRUE;  // Still not in the list, so it is added next time
+                        g_free(edid_encoded);
+                    }
                     else {  // Not in the list, add it
                         Poll_List_Item* vdu_poll_data = g_malloc(sizeof(Poll_List_Item));
                         vdu_poll_data->edid_encoded = edid_encoded;
                         vdu_poll_data->connected = TRUE;
+                        watchdog_phase_set("poll_for_changes/is_dpms_capable", ddca_dinfo_ptr->dispno);
                         vdu_poll_data->has_dpms = is_dpms_capable(ddca_dinfo_ptr);
-                        vdu_poll_data->dpms_awake = vdu_poll_data->has_dpms ? is_dpms_awake(ddca_dinfo_ptr) : TRUE;
+                        vdu_poll_data->dpms_unknown = vdu_poll_data->has_dpms && !rate_limit_try_acquire(ddca_dinfo_ptr);
+                        dpms_check_postponed |= vdu_poll_data->dpms_unknown;
+                        vdu_poll_data->dpms_awake = vdu_poll_data->has_dpms && !vdu_poll_data->dpms_unknown
+                                                        ? is_dpms_awake(ddca_dinfo_ptr) : TRUE;
                         poll_list = g_list_append(poll_list, vdu_poll_data);
                         if (g_log_get_debug_enabled()) {
                             g_debug("Poll check: new-connection disp=%d %.30s... has_dpms=%d awake=%d ",
                                 ndx + 1, edid_encoded, vdu_poll_data->has_dpms, vdu_poll_data->dpms_awake);
                         }
                         if (handle_hotplug_detection) {
-                            if (next_poll_time) {  // Not on first time through
+                            if (poll_list_primed) {  // Not on first time through
                                 g_message("Poll signal event - connected %d %.30s...", ndx + 1, edid_encoded);
                                 Event_Data_Type *event = g_malloc(sizeof(Event_Data_Type));
                                 event->event_type = DDCA_EVENT_DISPLAY_CONNECTED;
@@ -1918,10 +7828,21 @@ static bool poll_for_changes() {
                     }
                     list_ptr = list_next_ptr;
                 }
-                ddca_free_display_info_list(dlist);
+                backend->free_display_info_list(dlist);
+                poll_list_primed = TRUE;
             }
         }
-        next_poll_time = now_in_micros + (event_is_ready ? poll_cascade_interval_micros : poll_interval_micros);
+        if (refs_locked) {
+            g_rw_lock_reader_unlock(&display_refs_lock);
+        }
+        next_poll_time = now_in_micros + (event_is_ready || dpms_check_postponed || redetect_pending
+                                              ? poll_cascade_interval_micros : poll_interval_micros);
+        if (!redetect_pending) {
+            metrics_record_poll_pass(now_in_micros);
+            USDT_PROBE(poll__pass, handle_hotplug_detection ? "hotplug" : "dpms", -1, event_is_ready, detect_status,
+                       g_get_monotonic_time() - now_in_micros);
+        }
+        watchdog_phase_set(NULL, -1);
     }
     return event_is_ready;
 }
@@ -2013,6 +7934,7 @@ static gboolean chg_signal_dispatch(GSource* source, GSourceFunc callback, gpoin
         return TRUE;
     }
     Event_Data_Type* event_ptr = atomic_event_exchange(&signal_event_data, NULL);
+    watchdog_phase_set("chg_signal_dispatch", -1);
     g_info("chg_signal_dispatch: processing event, obtained %s", event_ptr == NULL ? "NULL event data" : "event data");
     gchar* edid_encoded;
     int int_event_type = DDCA_EVENT_DISPLAY_DISCONNECTED;
@@ -2022,10 +7944,12 @@ static gboolean chg_signal_dispatch(GSource* source, GSourceFunc callback, gpoin
             case DDCA_EVENT_DPMS_AWAKE:
             case DDCA_EVENT_DPMS_ASLEEP: ;  // Add semi-colon to resolve OpenSUSE 15.5 compile error
                 DDCA_Display_Info* dinfo;
-                const DDCA_Status status = ddca_get_display_info(event_ptr->dref, &dinfo);
+                g_rw_lock_reader_lock(&display_refs_lock);
+                const DDCA_Status status = backend->get_display_info(event_ptr->dref, &dinfo);
+                g_rw_lock_reader_unlock(&display_refs_lock);
                 if (status == DDCRC_OK) {
                     edid_encoded = edid_encode(dinfo->edid_bytes);
-                    ddca_free_display_info(dinfo);
+                    backend->free_display_info(dinfo);
                     break;
                 }
             // Fall through
@@ -2046,13 +7970,27 @@ static gboolean chg_signal_dispatch(GSource* source, GSourceFunc callback, gpoin
         g_warning("chg_signal_dispatch: unexpected null event data, assume DDCA_EVENT_DISCONNECTED");
     }
 
-    if (!g_dbus_connection_emit_signal(dbus_connection,
-                                       NULL,
-                                       "/com/ddcutil/DdcutilObject",
-                                       "com.ddcutil.DdcutilInterface",
-                                       "ConnectedDisplaysChanged",
-                                       g_variant_new("(siu)", edid_encoded, int_event_type, 0),
-                                       &local_error)) {
+    // A specific display's DPMS state changed, or for connection events, something changed.
+    vcp_cache_invalidate(edid_encoded[0] != '\0' ? edid_encoded : NULL);
+    if (int_event_type == DDCA_EVENT_DISPLAY_CONNECTED || int_event_type == DDCA_EVENT_DISPLAY_DISCONNECTED) {
+        g_rw_lock_reader_lock(&display_refs_lock);
+        prefetch_displays(TRUE);
+        g_rw_lock_reader_unlock(&display_refs_lock);
+        osd_watch_reset();
+    }
+
+    const long start_micros = g_get_monotonic_time();
+    const gboolean emitted = g_dbus_connection_emit_signal(dbus_connection,
+                                                           NULL,
+                                                           "/com/ddcutil/DdcutilObject",
+                                                           "com.ddcutil.DdcutilInterface",
+                                                           "ConnectedDisplaysChanged",
+                                                           g_variant_new("(siu)", edid_encoded, int_event_type, 0),
+                                                           &local_error);
+    // The event type is passed in place of the VCP-code.
+    USDT_PROBE(signal__connected_displays_changed, get_event_type_name(int_event_type), -1, int_event_type,
+               emitted ? DDCRC_OK : DDCRC_OTHER, g_get_monotonic_time() - start_micros);
+    if (!emitted) {
         g_warning("Signal ConnectedDisplaysChanged: failed %s", local_error != NULL ? local_error->message : "");
         g_free(local_error);
     }
@@ -2062,6 +8000,7 @@ static gboolean chg_signal_dispatch(GSource* source, GSourceFunc callback, gpoin
         }
     }
     g_free(edid_encoded);
+    watchdog_phase_set(NULL, -1);
     return TRUE;
 }
 
@@ -2100,6 +8039,255 @@ static void display_status_event_callback(DDCA_Display_Status_Event event) {
 }
 #endif
 
+/* ----------------------------------------------------------------------------------------------------
+ * OpenMetrics endpoint
+ *
+ * For monitoring agents that cannot use D-Bus.  When started with --metrics-socket=PATH the service
+ * listens on a UNIX stream socket, and writes a snapshot of its metrics in OpenMetrics text format
+ * to each connection before closing it, for example:
+ *
+ *     socat - UNIX-CONNECT:$XDG_RUNTIME_DIR/ddcutil-service.metrics
+ */
+
+static gchar* metrics_socket_path = NULL;  // Set by command line argument
+static GSocketService* metrics_service = NULL;
+
+/**
+ * @brief Append the histograms of one kind as an OpenMetrics histogram family.
+ * @param text the output text
+ * @param family metric family name
+ * @param kind the kind of Latency_Histogram to include
+ * @param name_label label name for the histogram's name
+ */
+static void metrics_append_latency_family(GString* text, const char* family, const char* kind,
+                                          const char* name_label) {
+    g_string_append_printf(text, "# TYPE %s histogram\n# UNIT %s seconds\n", family, family);
+    g_mutex_lock(&latency_mutex);
+    if (latency_table != NULL) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, latency_table);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            const Latency_Histogram* histogram = value;
+            if (strcmp(histogram->kind, kind) != 0) {
+                continue;
+            }
+            guint64 cumulative = 0;
+            for (int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+                cumulative += histogram->buckets[i];
+                if (i < G_N_ELEMENTS(latency_bucket_bounds_micros)) {
+                    g_string_append_printf(text, "%s_bucket{%s=\"%s\",phase=\"%s\",le=\"%.6g\"} %" G_GUINT64_FORMAT "\n",
+                                           family, name_label, histogram->name, histogram->phase,
+                                           latency_bucket_bounds_micros[i] / 1000000.0, cumulative);
+                }
+                else {
+                    g_string_append_printf(text, "%s_bucket{%s=\"%s\",phase=\"%s\",le=\"+Inf\"} %" G_GUINT64_FORMAT "\n",
+                                           family, name_label, histogram->name, histogram->phase, cumulative);
+                }
+            }
+            g_string_append_printf(text, "%s_count{%s=\"%s\",phase=\"%s\"} %" G_GUINT64_FORMAT "\n",
+                                   family, name_label, histogram->name, histogram->phase, histogram->count);
+            g_string_append_printf(text, "%s_sum{%s=\"%s\",phase=\"%s\"} %.6f\n",
+                                   family, name_label, histogram->name, histogram->phase,
+                                   histogram->sum_micros / 1000000.0);
+        }
+    }
+    g_mutex_unlock(&latency_mutex);
+}
+
+/**
+ * @brief Render all metrics in OpenMetrics text format.
+ * @return the g_malloced text
+ */
+static gchar* metrics_render(void) {
+    GString* text = g_string_new(NULL);
+
+    // Requests are counted by the dispatch histograms, every method call passes through dispatch.
+    g_string_append(text, "# TYPE ddcutil_requests counter\n");
+    g_mutex_lock(&latency_mutex);
+    if (latency_table != NULL) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, latency_table);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            const Latency_Histogram* histogram = value;
+            if (strcmp(histogram->kind, "method") == 0 && strcmp(histogram->phase, "dispatch") == 0) {
+                g_string_append_printf(text, "ddcutil_requests_total{method=\"%s\"} %" G_GUINT64_FORMAT "\n",
+                                       histogram->name, histogram->count);
+            }
+        }
+    }
+    g_mutex_unlock(&latency_mutex);
+
+    metrics_append_latency_family(text, "ddcutil_method_latency_seconds", "method", "method");
+    metrics_append_latency_family(text, "ddcutil_display_latency_seconds", "display", "device");
+
+    g_mutex_lock(&metrics_mutex);
+    g_string_append(text, "# TYPE ddcutil_ddc_operations counter\n");
+    if (ddc_status_counts != NULL) {
+        GHashTableIter iter;
+        gpointer key, value;
+        g_hash_table_iter_init(&iter, ddc_status_counts);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            g_string_append_printf(text, "ddcutil_ddc_operations_total{status=\"%s\"} %" G_GUINT64_FORMAT "\n",
+                                   ddca_rc_name(GPOINTER_TO_INT(key)), *(guint64 *) value);
+        }
+    }
+    // OpenMetrics requires each family's samples to follow its own TYPE line, so one pass per family.
+    GHashTableIter iter;
+    gpointer value;
+    g_string_append(text, "# TYPE ddcutil_display_up gauge\n");
+    if (display_health_table != NULL) {
+        g_hash_table_iter_init(&iter, display_health_table);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            const Display_Health* health = value;
+            g_string_append_printf(text, "ddcutil_display_up{device=\"/dev/i2c-%d\"} %d\n",
+                                   health->busno, health->consecutive_failures == 0 ? 1 : 0);
+        }
+    }
+    g_string_append(text, "# TYPE ddcutil_display_consecutive_failures gauge\n");
+    if (display_health_table != NULL) {
+        g_hash_table_iter_init(&iter, display_health_table);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            const Display_Health* health = value;
+            g_string_append_printf(text, "ddcutil_display_consecutive_failures{device=\"/dev/i2c-%d\"} %u\n",
+                                   health->busno, health->consecutive_failures);
+        }
+    }
+    g_string_append(text, "# TYPE ddcutil_display_errors counter\n");
+    if (display_health_table != NULL) {
+        g_hash_table_iter_init(&iter, display_health_table);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            const Display_Health* health = value;
+            g_string_append_printf(text, "ddcutil_display_errors_total{device=\"/dev/i2c-%d\"} %" G_GUINT64_FORMAT "\n",
+                                   health->busno, health->error_count);
+        }
+    }
+    g_string_append(text, "# TYPE ddcutil_display_last_success_timestamp_seconds gauge\n");
+    if (display_health_table != NULL) {
+        g_hash_table_iter_init(&iter, display_health_table);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            const Display_Health* health = value;
+            if (health->last_ok_real_micros != 0) {
+                g_string_append_printf(text,
+                                       "ddcutil_display_last_success_timestamp_seconds{device=\"/dev/i2c-%d\"} %.3f\n",
+                                       health->busno, health->last_ok_real_micros / 1000000.0);
+            }
+        }
+    }
+    const Latency_Histogram poll = poll_pass_histogram;
+    g_mutex_unlock(&metrics_mutex);
+
+    g_string_append(text, "# TYPE ddcutil_poll_pass_seconds histogram\n# UNIT ddcutil_poll_pass_seconds seconds\n");
+    guint64 cumulative = 0;
+    for (int i = 0; i < G_N_ELEMENTS(latency_bucket_bounds_micros); i++) {
+        cumulative += poll.buckets[i];
+        g_string_append_printf(text, "ddcutil_poll_pass_seconds_bucket{le=\"%.6g\"} %" G_GUINT64_FORMAT "\n",
+                               latency_bucket_bounds_micros[i] / 1000000.0, cumulative);
+    }
+    g_string_append_printf(text, "ddcutil_poll_pass_seconds_bucket{le=\"+Inf\"} %" G_GUINT64_FORMAT "\n", poll.count);
+    g_string_append_printf(text, "ddcutil_poll_pass_seconds_count %" G_GUINT64_FORMAT "\n", poll.count);
+    g_string_append_printf(text, "ddcutil_poll_pass_seconds_sum %.6f\n", poll.sum_micros / 1000000.0);
+
+    g_mutex_lock(&inflight_read_mutex);
+    const guint64 read_requests = read_request_count;
+    const guint64 read_dedup_hits = read_dedup_hit_count;
+    g_mutex_unlock(&inflight_read_mutex);
+    g_mutex_lock(&vcp_cache_mutex);
+    const guint64 conditional_lookups = conditional_lookup_count;
+    const guint64 conditional_hits = conditional_hit_count;
+    g_mutex_unlock(&vcp_cache_mutex);
+    g_string_append(text, "# TYPE ddcutil_cache_hit_ratio gauge\n");
+    g_string_append_printf(text, "ddcutil_cache_hit_ratio{cache=\"dedup\"} %.6f\n",
+                           read_requests > 0 ? (double) read_dedup_hits / (double) read_requests : 0.0);
+    g_string_append_printf(text, "ddcutil_cache_hit_ratio{cache=\"conditional\"} %.6f\n",
+                           conditional_lookups > 0 ? (double) conditional_hits / (double) conditional_lookups : 0.0);
+    g_string_append_printf(text, "ddcutil_cache_hit_ratio{cache=\"prefetch\"} %.6f\n", get_prefetch_hit_rate());
+
+    guint priority_depth = 0;
+    guint normal_depth = 0;
+    g_mutex_lock(&scheduler_mutex);
+    if (sender_queues_table != NULL) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, sender_queues_table);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            const Sender_Queues* sender_queues = value;
+            priority_depth += sender_queues->priority_queue.length;
+            normal_depth += sender_queues->normal_queue.length;
+        }
+    }
+    const guint background_depth = background_queue.length;
+    g_mutex_unlock(&scheduler_mutex);
+    g_string_append(text, "# TYPE ddcutil_queue_depth gauge\n");
+    g_string_append_printf(text, "ddcutil_queue_depth{queue=\"priority\"} %u\n", priority_depth);
+    g_string_append_printf(text, "ddcutil_queue_depth{queue=\"normal\"} %u\n", normal_depth);
+    g_string_append_printf(text, "ddcutil_queue_depth{queue=\"background\"} %u\n", background_depth);
+    g_string_append_printf(text, "ddcutil_queue_depth{queue=\"connectivity_event\"} %d\n",
+                           g_atomic_pointer_get(&signal_event_data) != NULL ? 1 : 0);
+
+    g_string_append(text, "# EOF\n");
+    return g_string_free(text, FALSE);
+}
+
+static void metrics_write_done(GObject* source_object, GAsyncResult* res, gpointer user_data) {
+    GSocketConnection* connection = user_data;
+    GError* local_error = NULL;
+    if (!g_output_stream_write_all_finish(G_OUTPUT_STREAM(source_object), res, NULL, &local_error)) {
+        g_info("Metrics: write failed: %s", local_error->message);
+        g_error_free(local_error);
+    }
+    g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
+    g_free(g_object_steal_data(G_OBJECT(connection), "metrics-text"));
+    g_object_unref(connection);
+}
+
+/**
+ * @brief GSocketService incoming handler, writes the metrics without blocking the main loop.
+ */
+static gboolean metrics_incoming(GSocketService* service, GSocketConnection* connection, GObject* source_object,
+                                 gpointer user_data) {
+    gchar* text = metrics_render();
+    g_object_set_data(G_OBJECT(connection), "metrics-text", text);  // Must outlive the async write
+    GOutputStream* output = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+    g_output_stream_write_all_async(output, text, strlen(text), G_PRIORITY_DEFAULT, NULL,
+                                    metrics_write_done, g_object_ref(connection));
+    return TRUE;
+}
+
+/**
+ * @brief Start listening on metrics_socket_path, if set, and begin collecting metrics.
+ */
+static void metrics_start(void) {
+    if (metrics_socket_path == NULL) {
+        return;
+    }
+    struct sockaddr_un native_address = {.sun_family = AF_UNIX};
+    if (strlen(metrics_socket_path) >= sizeof(native_address.sun_path)) {
+        g_warning("Metrics: socket path is too long: %s", metrics_socket_path);
+        return;
+    }
+    g_strlcpy(native_address.sun_path, metrics_socket_path, sizeof(native_address.sun_path));
+    unlink(metrics_socket_path);  // Left over from a previous instance
+    GSocketAddress* address = g_socket_address_new_from_native(&native_address, sizeof(native_address));
+    metrics_service = g_socket_service_new();
+    GError* local_error = NULL;
+    if (!g_socket_listener_add_address(G_SOCKET_LISTENER(metrics_service), address, G_SOCKET_TYPE_STREAM,
+                                       G_SOCKET_PROTOCOL_DEFAULT, NULL, NULL, &local_error)) {
+        g_warning("Metrics: failed to listen on %s: %s", metrics_socket_path, local_error->message);
+        g_error_free(local_error);
+        g_object_unref(metrics_service);
+        metrics_service = NULL;
+    }
+    else {
+        g_signal_connect(metrics_service, "incoming", G_CALLBACK(metrics_incoming), NULL);
+        g_socket_service_start(metrics_service);
+        metrics_enabled = TRUE;
+        g_message("Metrics: serving OpenMetrics on %s", metrics_socket_path);
+    }
+    g_object_unref(address);
+}
+
 /**
  * @brief registered callback for when GD-Bus is ready to accept service registrations.
  *
@@ -2124,6 +8312,12 @@ static void on_bus_acquired(GDBusConnection* connection, const gchar* name, gpoi
     g_assert(registration_id > 0);
     g_message("Registered %s", object_path);
 
+    // Track client lifetimes, so that work queued for departed clients can be discarded.
+    g_dbus_connection_signal_subscribe(connection,
+                                       "org.freedesktop.DBus", "org.freedesktop.DBus", "NameOwnerChanged",
+                                       "/org/freedesktop/DBus", NULL, G_DBUS_SIGNAL_FLAGS_NONE,
+                                       on_name_owner_changed, NULL, NULL);
+
     // Setup any timers here - if needed.
 }
 
@@ -2189,6 +8383,11 @@ int main(int argc, char* argv[]) {
 
     int poll_seconds = -1;  // -1 flags no argument supplied
     double poll_cascade_interval_seconds = 0.0;
+    double vcp_cache_max_age_seconds = -1.0;  // -1 flags no argument supplied
+    int max_queue_depth = -1;  // -1 flags no argument supplied
+    double i2c_rate_limit_arg = 0.0;
+    gboolean prefetch_arg = FALSE;
+    gint osd_watch_interval_arg = 0;
 
 #if !defined(LIBDDCUTIL_HAS_OPTION_ARGUMENTS)
 #define DDCA_SYSLOG_NOTICE 9
@@ -2234,6 +8433,46 @@ int main(int argc, char* argv[]) {
             "poll-cascade-interval", 'c', 0, G_OPTION_ARG_DOUBLE, &poll_cascade_interval_seconds,
             "polling minimum interval between cascading events in seconds, 0.1 minimum", NULL
         },
+        {
+            "vcp-cache-max-age", 0, 0, G_OPTION_ARG_DOUBLE, &vcp_cache_max_age_seconds,
+            "maximum age in seconds of cached VCP values for conditional gets, 0 to disable (default)", NULL
+        },
+        {
+            "max-queue-depth", 0, 0, G_OPTION_ARG_INT, &max_queue_depth,
+            "maximum number of calls a client may have queued before further calls are refused, 1 minimum", NULL
+        },
+        {
+            "i2c-rate-limit", 0, 0, G_OPTION_ARG_DOUBLE, &i2c_rate_limit_arg,
+            "maximum DDC transactions per second on each I2C bus, 0 for unlimited", NULL
+        },
+        {
+            "prefetch", 0, 0, G_OPTION_ARG_NONE, &prefetch_arg,
+            "read capabilities and common VCP values in the background after startup, detect, and connect events", NULL
+        },
+        {
+            "osd-watch-interval", 0, 0, G_OPTION_ARG_INT, &osd_watch_interval_arg,
+            "interval in seconds for checking VCP 0x02 for changes made via VDU on-screen-displays, 0 to disable", NULL
+        },
+        {
+            "stall-threshold", 0, 0, G_OPTION_ARG_INT, &stall_threshold_millis,
+            "record main loop stalls longer than this many milliseconds, 0 to disable", NULL
+        },
+        {
+            "stall-warnings", 0, 0, G_OPTION_ARG_NONE, &stall_warnings,
+            "log a warning for each main loop stall", NULL
+        },
+        {
+            "trace-records", 0, 0, G_OPTION_ARG_INT, &trace_records,
+            "number of recent operations kept by the flight recorder, 0 to disable", NULL
+        },
+        {
+            "metrics-socket", 0, 0, G_OPTION_ARG_FILENAME, &metrics_socket_path,
+            "serve OpenMetrics text on this UNIX socket path", "PATH"
+        },
+        {
+            "simulate", 0, 0, G_OPTION_ARG_FILENAME, &simulate_path,
+            "simulate the displays described in FILE instead of using real displays", "FILE"
+        },
         {
             "return-raw-values", 'r', 0, G_OPTION_ARG_NONE, &return_raw_values,
             "return high-byte and low-byte for all values, including Simple Non-Continuous values", NULL
@@ -2336,6 +8575,11 @@ int main(int argc, char* argv[]) {
     g_free(arg_string);
 #endif
 
+    if (simulate_path != NULL && !sim_load(simulate_path, &error)) {
+        g_print("Failed to load simulated displays: %s\n", error->message);
+        exit(1);
+    }
+
     ddcutil_service_status = verify_i2c_dev();
 
 #if defined(LIBDDCUTIL_HAS_DYNAMIC_SLEEP_BOOLEAN)
@@ -2378,11 +8622,44 @@ int main(int argc, char* argv[]) {
                 MIN_POLL_CASCADE_INTERVAL_SECONDS);
         exit(1);
     }
+    if (vcp_cache_max_age_seconds != -1.0 && !update_vcp_cache_max_age(vcp_cache_max_age_seconds)) {
+        g_print("VCP cache max age parameter must be zero or more seconds.");
+        exit(1);
+    }
+    if (max_queue_depth != -1) {
+        if (max_queue_depth < 1) {
+            g_print("Max queue depth parameter must be at least 1.");
+            exit(1);
+        }
+        scheduler_max_queue_depth = max_queue_depth;
+    }
+    if (i2c_rate_limit_arg < 0.0) {
+        g_print("I2C rate limit parameter must be zero or more transactions per second.");
+        exit(1);
+    }
+    i2c_rate_limit = i2c_rate_limit_arg;
+    prefetch_enabled = prefetch_arg;
+    if (osd_watch_interval_arg < 0) {
+        g_print("OSD watch interval parameter must be zero or more seconds.");
+        exit(1);
+    }
+    osd_watch_interval_seconds = osd_watch_interval_arg;
+    if (trace_records < 0 || trace_records > (1 << 24)) {
+        g_print("Trace records parameter must be in the range 0..16777216.");
+        exit(1);
+    }
+    trace_start();
 
     configure_display_connectivity_detection();
 
     enable_custom_source(main_loop);  // May do nothing - but a client may enable events or polling later
 
+    prefetch_displays(FALSE);  // Warm the caches for the clients that start at login
+    osd_watch_start();
+    metrics_start();
+    watchdog_start();
+    sim_start();
+
     g_main_loop_run(main_loop);
     g_bus_unown_name(owner_id);
     g_dbus_node_info_unref(introspection_data);